@@ -3,9 +3,11 @@
 uniform float scroll;
 
 INOUTTYPE vec4 texcoords[2];
+INOUTTYPE vec3 worldpos;
 
 #ifdef VERTEXSHADER
 uniform mat4 localMatrix;
+uniform mat4 entityMatrix;
 
 layout(location = 0) in vec4 position;
 layout(location = 1) in vec4 diffuse;
@@ -17,6 +19,7 @@ void LightmappedVS ()
 	gl_Position = localMatrix * position;
 	texcoords[0] = diffuse + (vec4 (scroll, 0, 0, 0) * diffuse.z);
 	texcoords[1] = lightmap;
+	worldpos = (entityMatrix * position).xyz;
 }
 #endif
 
@@ -29,12 +32,16 @@ uniform mat4 colormatrix;
 
 out vec4 fragColor;
 
+// matches the falloff of the old lightmap dlights
+#define DLIGHT_CUTOFF 64.0
+
 void LightmappedFS ()
 {
 	vec4 lmap = texture2DArray(lightmap, texcoords[1].xyz);
 	vec4 albedo = texture(diffuse, texcoords[0].st);
 		
-	vec4 final = albedo * (colormatrix * (lmap / lmap.a));
+	vec4 dlight = vec4 (DynamicLight (worldpos, DLIGHT_CUTOFF), 0.0);
+	vec4 final = albedo * (colormatrix * ((lmap / lmap.a) + dlight));
 	
 	fragColor = vec4(final.rgb, surfalpha);
 }
@@ -15,3 +15,43 @@ vec3 doBrightnessAndContrast(vec3 value, float brightnessValue, float contrastVa
 	vec3 color = value.rgb * contrastValue;
 	return vec3(pow(abs(color.rgb), vec3(brightnessValue)));
 }
+
+
+#ifdef FRAGMENTSHADER
+// dynamic lights, culled into view clusters by R_SetupDlights; these must match gl_light.c and ref_public.h
+#define MAX_DLIGHTS 128
+#define CLUSTER_X 16
+#define CLUSTER_Y 8
+#define CLUSTER_Z 24
+
+layout(std140) uniform LightUniforms
+{
+	vec4 dlightorigin[MAX_DLIGHTS];
+	vec4 dlightcolor[MAX_DLIGHTS];
+	vec4 clusterforward;
+	vec4 clusterscale;
+	vec4 clusterbias;
+};
+
+uniform usamplerBuffer clustergrid;
+uniform usamplerBuffer clusterlights;
+
+vec3 DynamicLight (vec3 worldpos, float cutoff)
+{
+	float depth = dot (worldpos, clusterforward.xyz) + clusterforward.w;
+	int slice = int (clamp (log (max (depth, 1.0)) * clusterscale.z + clusterscale.w, 0.0, float (CLUSTER_Z - 1)));
+	ivec2 tile = ivec2 (clamp ((gl_FragCoord.xy - clusterbias.xy) * clusterscale.xy, vec2 (0.0), vec2 (CLUSTER_X - 1, CLUSTER_Y - 1)));
+	uvec2 cluster = texelFetch (clustergrid, (slice * CLUSTER_Y + tile.y) * CLUSTER_X + tile.x).xy;
+	vec3 light = vec3 (0.0);
+
+	for (uint i = 0u; i < cluster.y; i++)
+	{
+		int l = int (texelFetch (clusterlights, int (cluster.x + i)).r);
+		float add = dlightorigin[l].w - cutoff - distance (worldpos, dlightorigin[l].xyz);
+
+		light += max (add, 0.0) * dlightcolor[l].rgb;
+	}
+
+	return light;
+}
+#endif
@@ -1,10 +1,12 @@
 
 INOUTTYPE vec2 texcoords;
 INOUTTYPE vec3 normals;
+INOUTTYPE vec3 worldpos;
 
 layout(std140) uniform MeshUniforms
 {
 	mat4 localMatrix;
+	mat4 entityMatrix;
 	vec3 move;
 	vec3 frontv;
 	vec3 backv;
@@ -13,6 +15,7 @@ layout(std140) uniform MeshUniforms
 	float lerpfrac;
 	float powersuit_scale;
 	float meshshellmix;
+	float dlightscale;
 };
 
 #ifdef VERTEXSHADER
@@ -26,13 +29,13 @@ void MeshVS ()
 {
 	vec4 lerpnormal = vec4 (mix (lightnormal[uint (currvert.w)], lightnormal[uint (lastvert.w)], lerpfrac), 0.0);
 
-	gl_Position = localMatrix * 
-	(
-		vec4 (move, 1.0) + 
+	vec4 modelpos = vec4 (move, 1.0) + 
 		(currvert * vec4 (frontv, 0.0)) + 
 		(lastvert * vec4 (backv, 0.0)) + 
-		(lerpnormal * vec4 (powersuit_scale, powersuit_scale, powersuit_scale, 0.0))
-	);
+		(lerpnormal * vec4 (powersuit_scale, powersuit_scale, powersuit_scale, 0.0));
+
+	gl_Position = localMatrix * modelpos;
+	worldpos = (entityMatrix * modelpos).xyz;
 
 	texcoords = texcoord.st;
 	normals = lerpnormal.xyz;
@@ -49,7 +52,8 @@ void MeshFS ()
 {
 	vec4 diff = texture (diffuse, texcoords);
 	float shadedot = dot (normalize (normals), shadevector);
-	vec4 finalColor = diff * (max (shadedot + 1.0, (shadedot * 0.2954545) + 1.0) * shadelight);
+	vec4 light = shadelight + vec4 (DynamicLight (worldpos, 0.0) * dlightscale, 0.0);
+	vec4 finalColor = diff * (max (shadedot + 1.0, (shadedot * 0.2954545) + 1.0) * light);
 
 	fragColor = mix (finalColor, shadelight, meshshellmix);
 }
@@ -0,0 +1,361 @@
+/*
+Copyright (C) 1997-2001 Id Software, Inc.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+// cl_bench.c -- timedemo benchmark runs
+
+/*
+"benchmark demo1 [demo2 ...]" plays each demo as a timedemo, one after the
+other, and records how long every rendered frame took to benchmark.csv in
+the game directory: the whole frame, and the parse, render and sound parts
+of the client frame along with what is left of it.  When a demo ends its
+frame count, fps and min/avg/1%/0.1% frame times are printed and appended
+to benchmark_summary.csv, so runs can be compared across builds.
+
+Every demo starts from the same random seed (bench_seed).  A non zero
+bench_step sets a fixed frame step in milliseconds through fixedtime, so
+particle effects and animation come out the same on every run.
+*/
+
+#include "client.h"
+
+#define	BENCH_MAX_DEMOS		32
+
+typedef struct
+{
+	unsigned int	total;		// the whole frame, server included
+	unsigned int	client;		// the client frame less the parts below
+	unsigned int	parse;
+	unsigned int	render;
+	unsigned int	sound;
+} benchframe_t;
+
+static cvar_t	*bench_seed;
+static cvar_t	*bench_step;
+
+static char		bench_demos[BENCH_MAX_DEMOS][MAX_QPATH];
+static int		bench_numdemos;
+static int		bench_current;			// demo being played, -1 when idle
+static qboolean	bench_started;			// the current demo has rendered a frame
+
+static benchframe_t	*bench_frames;
+static int		bench_numframes;
+static int		bench_maxframes;
+static unsigned int	bench_lastframe;	// Sys_Microseconds of the previous frame
+
+static FILE		*bench_csv;
+
+// settings put back when the run is over
+static char		bench_oldtimedemo[16];
+static char		bench_oldfixedtime[16];
+
+
+/*
+================
+Bench_Running
+================
+*/
+qboolean Bench_Running (void)
+{
+	return bench_current >= 0;
+}
+
+/*
+================
+Bench_Frame
+
+Records the timings of one client frame
+================
+*/
+void Bench_Frame (unsigned int client, unsigned int parse, unsigned int render, unsigned int sound)
+{
+	benchframe_t	*frame;
+	unsigned int	now;
+
+	if (!Bench_Running ())
+		return;
+
+	now = Sys_Microseconds ();
+
+	// only frames that actually drew the demo count
+	if (cls.state != ca_active || !cl.refresh_prepped || !render)
+	{
+		bench_lastframe = now;
+		return;
+	}
+
+	// the first frame has no previous one to measure from
+	if (!bench_started)
+	{
+		bench_started = true;
+		bench_lastframe = now;
+		return;
+	}
+
+	if (bench_numframes == bench_maxframes)
+	{
+		benchframe_t	*frames;
+
+		bench_maxframes = bench_maxframes ? bench_maxframes * 2 : 4096;
+		frames = Z_Malloc (bench_maxframes * sizeof (*frames));
+
+		if (bench_frames)
+		{
+			memcpy (frames, bench_frames, bench_numframes * sizeof (*frames));
+			Z_Free (bench_frames);
+		}
+
+		bench_frames = frames;
+	}
+
+	frame = &bench_frames[bench_numframes++];
+
+	frame->total = now - bench_lastframe;
+	frame->parse = parse;
+	frame->render = render;
+	frame->sound = sound;
+	frame->client = client - parse - render - sound;
+
+	bench_lastframe = now;
+
+	if (bench_csv)
+		fprintf (bench_csv, "%s,%i,%u,%u,%u,%u,%u\n", bench_demos[bench_current], bench_numframes,
+			frame->total, frame->client, frame->parse, frame->render, frame->sound);
+}
+
+/*
+================
+Bench_CompareTimes
+================
+*/
+static int Bench_CompareTimes (const void *a, const void *b)
+{
+	unsigned int	ta = *(const unsigned int *) a;
+	unsigned int	tb = *(const unsigned int *) b;
+
+	return (ta > tb) - (ta < tb);
+}
+
+/*
+================
+Bench_Report
+
+Prints and saves the summary of the demo just played
+================
+*/
+static void Bench_Report (void)
+{
+	unsigned int	*times;
+	double		sum, avg, fps;
+	unsigned int	low1, low01;
+	FILE		*f;
+	char		name[MAX_OSPATH];
+	qboolean	header;
+	int			i;
+
+	if (!bench_numframes)
+	{
+		Com_Printf ("benchmark: %s drew no frames\n", bench_demos[bench_current]);
+		return;
+	}
+
+	times = Z_Malloc (bench_numframes * sizeof (*times));
+	sum = 0;
+
+	for (i = 0; i < bench_numframes; i++)
+	{
+		times[i] = bench_frames[i].total;
+		sum += times[i];
+	}
+
+	qsort (times, bench_numframes, sizeof (*times), Bench_CompareTimes);
+
+	avg = sum / bench_numframes;
+	fps = sum > 0 ? bench_numframes * 1000000.0 / sum : 0;
+
+	// the frame time that only 1% and 0.1% of the frames were slower than
+	low1 = times[(int) ((bench_numframes - 1) * 0.99)];
+	low01 = times[(int) ((bench_numframes - 1) * 0.999)];
+
+	Com_Printf ("benchmark: %s: %i frames, %3.1f seconds: %3.1f fps\n", bench_demos[bench_current],
+		bench_numframes, sum / 1000000.0, fps);
+	Com_Printf ("frame msec min %.2f avg %.2f 1%% %.2f 0.1%% %.2f\n",
+		times[0] / 1000.0, avg / 1000.0, low1 / 1000.0, low01 / 1000.0);
+
+	Com_sprintf (name, sizeof (name), "%s/benchmark_summary.csv", FS_Gamedir ());
+
+	f = fopen (name, "r");
+	header = !f;
+
+	if (f)
+		fclose (f);
+
+	if ((f = fopen (name, "a")) != NULL)
+	{
+		if (header)
+			fprintf (f, "demo,frames,seconds,fps,min_msec,avg_msec,p1_msec,p01_msec,seed,step\n");
+
+		fprintf (f, "%s,%i,%.3f,%.1f,%.3f,%.3f,%.3f,%.3f,%i,%i\n", bench_demos[bench_current],
+			bench_numframes, sum / 1000000.0, fps, times[0] / 1000.0, avg / 1000.0,
+			low1 / 1000.0, low01 / 1000.0, (int) bench_seed->value, (int) bench_step->value);
+		fclose (f);
+	}
+
+	Z_Free (times);
+}
+
+/*
+================
+Bench_Stop
+================
+*/
+static void Bench_Stop (void)
+{
+	if (bench_csv)
+	{
+		fclose (bench_csv);
+		bench_csv = NULL;
+	}
+
+	if (bench_frames)
+	{
+		Z_Free (bench_frames);
+		bench_frames = NULL;
+	}
+
+	bench_numframes = bench_maxframes = 0;
+	bench_current = -1;
+
+	Cvar_Set ("timedemo", bench_oldtimedemo);
+	Cvar_Set ("fixedtime", bench_oldfixedtime);
+}
+
+/*
+================
+Bench_StartDemo
+================
+*/
+static void Bench_StartDemo (void)
+{
+	bench_numframes = 0;
+	bench_started = false;
+
+	// the same effects on every run
+	srand ((unsigned int) bench_seed->value);
+
+	Cbuf_AddText (va ("demomap \"%s\"\n", bench_demos[bench_current]));
+}
+
+/*
+================
+Bench_DemoFinished
+
+Called when the client disconnects; moves on to the next demo
+================
+*/
+void Bench_DemoFinished (void)
+{
+	if (!Bench_Running ())
+		return;
+
+	// a demo that couldn't be opened drops the client before a frame is drawn
+	if (bench_started)
+		Bench_Report ();
+	else
+		Com_Printf ("benchmark: %s couldn't be played\n", bench_demos[bench_current]);
+
+	if (++bench_current >= bench_numdemos)
+	{
+		Com_Printf ("benchmark: done\n");
+		Bench_Stop ();
+		return;
+	}
+
+	Bench_StartDemo ();
+}
+
+/*
+================
+Bench_f
+================
+*/
+static void Bench_f (void)
+{
+	char	name[MAX_OSPATH];
+	int		i;
+
+	if (Cmd_Argc () < 2)
+	{
+		Com_Printf ("usage: benchmark <demo> [demo ...]\n");
+		return;
+	}
+
+	if (Bench_Running ())
+		Bench_Stop ();
+
+	// leave the current game now, so dropping it isn't taken for the end
+	// of the first demo
+	if (cls.state > ca_disconnected)
+		CL_Disconnect ();
+
+	bench_numdemos = 0;
+
+	for (i = 1; i < Cmd_Argc () && bench_numdemos < BENCH_MAX_DEMOS; i++)
+	{
+		Q_strlcpy (bench_demos[bench_numdemos], Cmd_Argv (i), sizeof (bench_demos[0]));
+
+		if (!strstr (bench_demos[bench_numdemos], ".dm2"))
+			Q_strlcat (bench_demos[bench_numdemos], ".dm2", sizeof (bench_demos[0]));
+
+		bench_numdemos++;
+	}
+
+	Com_sprintf (name, sizeof (name), "%s/benchmark.csv", FS_Gamedir ());
+	bench_csv = fopen (name, "w");
+
+	if (!bench_csv)
+		Com_Printf ("benchmark: couldn't write %s\n", name);
+	else
+		fprintf (bench_csv, "demo,frame,total_usec,client_usec,parse_usec,render_usec,sound_usec\n");
+
+	Q_strlcpy (bench_oldtimedemo, Cvar_VariableString ("timedemo"), sizeof (bench_oldtimedemo));
+	Q_strlcpy (bench_oldfixedtime, Cvar_VariableString ("fixedtime"), sizeof (bench_oldfixedtime));
+
+	Cvar_Set ("timedemo", "1");
+
+	// fixedtime is in microseconds, like the rest of Qcommon_Frame
+	if (bench_step->value > 0)
+		Cvar_SetValue ("fixedtime", (int) (bench_step->value * 1000));
+
+	bench_current = 0;
+	Bench_StartDemo ();
+}
+
+/*
+================
+Bench_Init
+================
+*/
+void Bench_Init (void)
+{
+	bench_seed = Cvar_Get ("bench_seed", "1", 0);
+	bench_step = Cvar_Get ("bench_step", "0", 0);
+	bench_current = -1;
+
+	Cmd_AddCommand ("benchmark", Bench_f);
+}
@@ -30,12 +30,7 @@ extern	int		key_linepos;
 
 void DrawStringScaled (int x, int y, char *s, float factor)
 {
-	while (*s)
-	{
-		RE_Draw_CharScaled(x, y, *s, factor);
-		x += 8 * factor;
-		s++;
-	}
+	RE_Draw_StringScaled (x, y, s, strlen (s), factor);
 }
 
 void DrawAltStringScaled (int x, int y, char *s, float factor)
@@ -118,6 +113,27 @@ void Con_ToggleChat_f (void)
 	Con_ClearNotify ();
 }
 
+/*
+================
+Con_Reset
+
+Throws away all the text
+================
+*/
+static void Con_Reset (void)
+{
+	con.textend = 0;
+	con.numlines = 0;
+	con.firstline = 0;
+	con.linefeed = false;
+	con.cr = false;
+	con.current = -1;
+	con.display = -1;
+	con.totallines = 0;
+
+	Con_ClearNotify ();
+}
+
 /*
 ================
 Con_Clear_f
@@ -125,7 +141,7 @@ Con_Clear_f
 */
 void Con_Clear_f (void)
 {
-	memset (con.text, ' ', CON_TEXTSIZE);
+	Con_Reset ();
 }
 
 
@@ -139,9 +155,9 @@ Save the console contents out to a file
 void Con_Dump_f (void)
 {
 	int		l, x;
-	char	*line;
+	conline_t	*line;
 	FILE	*f;
-	char	buffer[1024];
+	char	buffer[CON_MAXLINELEN + 1];
 	char	name[MAX_OSPATH];
 
 	if (Cmd_Argc() != 2)
@@ -150,12 +166,6 @@ void Con_Dump_f (void)
 		return;
 	}
 
-	if (con.linewidth >= 1024)
-	{
-		Com_Printf("con.linewidth too large!\n");
-		return;
-	}
-
 	Com_sprintf (name, sizeof (name), "%s/%s.txt", FS_Gamedir(), Cmd_Argv (1));
 
 	Com_Printf ("Dumped console text to %s.\n", name);
@@ -169,37 +179,22 @@ void Con_Dump_f (void)
 	}
 
 	// skip empty lines
-	for (l = con.current - con.totallines + 1; l <= con.current; l++)
-	{
-		line = con.text + (l % con.totallines) * con.linewidth;
-
-		for (x = 0; x < con.linewidth; x++)
-			if (line[x] != ' ')
-				break;
-
-		if (x != con.linewidth)
+	for (l = con.firstline; l < con.numlines; l++)
+		if (con.lines[l & (CON_MAXLINES - 1)].length)
 			break;
-	}
-
-	// write the remaining lines
-	buffer[con.linewidth] = 0;
 
-	for (; l <= con.current; l++)
+	// write the remaining lines as they were printed, not as they're wrapped
+	for (; l < con.numlines; l++)
 	{
-		line = con.text + (l % con.totallines) * con.linewidth;
-		memcpy (buffer, line, con.linewidth);
+		line = &con.lines[l & (CON_MAXLINES - 1)];
 
-		for (x = con.linewidth - 1; x >= 0; x--)
-		{
-			if (buffer[x] == ' ')
-				buffer[x] = 0;
-			else
-				break;
-		}
+		for (x = 0; x < line->length; x++)
+			buffer[x] = con.text[(line->start + x) & CON_TEXTMASK] & 0x7f;
 
-		for (x = 0; buffer[x]; x++)
-			buffer[x] &= 0x7f;
+		while (x > 0 && buffer[x - 1] == ' ')
+			x--;
 
+		buffer[x] = 0;
 		fprintf (f, "%s\n", buffer);
 	}
 
@@ -243,64 +238,164 @@ void Con_MessageMode2_f (void)
 	cls.key_dest = key_message;
 }
 
+/*
+==============================================================================
+
+LAYOUT
+
+==============================================================================
+*/
+
 /*
 ================
-Con_CheckResize
+Con_AddRow
+================
+*/
+static void Con_AddRow (unsigned int start, int length)
+{
+	conrow_t	*row;
 
-If the line width has changed, reformat the buffer.
+	con.current++;
+	row = &con.rows[con.current & (CON_MAXROWS - 1)];
+	row->start = start;
+	row->length = length;
+}
+
+/*
+================
+Con_LayoutLine
+
+Word wraps a line into rows at the current line width
 ================
 */
-void Con_CheckResize (void)
+static void Con_LayoutLine (conline_t *line)
 {
-	int		i, j, width, oldwidth, oldtotallines, numlines, numchars;
-	static char	tbuf[CON_TEXTSIZE];
-	float scale = SCR_GetConsoleScale();
+	unsigned int	ofs, rowstart;
+	int		i, l, x;
 
-	width = ((int)(viddef.width / scale) >> 3) - 2;
+	line->firstrow = con.current + 1;
+	rowstart = line->start;
+	x = 0;
 
-	if (width == con.linewidth)
+	for (i = 0, ofs = line->start; i < line->length; i++, ofs++)
+	{
+		// at the start of a word, move it to the next row if it won't fit on this one
+		if (x && (con.text[(ofs - 1) & CON_TEXTMASK] & 127) <= ' ')
+		{
+			for (l = 0; l < con.linewidth && i + l < line->length; l++)
+				if ((con.text[(ofs + l) & CON_TEXTMASK] & 127) <= ' ')
+					break;
+
+			if (l != con.linewidth && x + l > con.linewidth)
+			{
+				Con_AddRow (rowstart, x);
+				rowstart = ofs;
+				x = 0;
+			}
+		}
+
+		if (++x >= con.linewidth)
+		{
+			Con_AddRow (rowstart, x);
+			rowstart = ofs + 1;
+			x = 0;
+		}
+	}
+
+	// an empty line still takes a row
+	if (x || con.current < line->firstrow)
+		Con_AddRow (rowstart, x);
+}
+
+/*
+================
+Con_LayoutLines
+
+Lays out every line from first on, replacing the rows they had
+================
+*/
+static void Con_LayoutLines (int first)
+{
+	int		i;
+
+	if (first >= con.numlines)
 		return;
 
-	if (width < 1)			// video hasn't been initialized yet
+	con.current = con.lines[first & (CON_MAXLINES - 1)].firstrow - 1;
+
+	for (i = first; i < con.numlines; i++)
+		Con_LayoutLine (&con.lines[i & (CON_MAXLINES - 1)]);
+}
+
+/*
+================
+Con_TrimScrollback
+
+Drops the lines whose text has been overwritten, and the rows that fell
+out of the row ring
+================
+*/
+static void Con_TrimScrollback (void)
+{
+	int		firstrow;
+
+	while (con.firstline < con.numlines)
 	{
-		width = 78;
-		con.linewidth = width;
-		con.totallines = CON_TEXTSIZE / con.linewidth;
-		memset (con.text, ' ', CON_TEXTSIZE);
+		if (con.numlines - con.firstline <= CON_MAXLINES &&
+			con.textend - con.lines[con.firstline & (CON_MAXLINES - 1)].start <= CON_TEXTSIZE)
+			break;
+
+		con.firstline++;
 	}
+
+	if (con.firstline < con.numlines)
+		firstrow = con.lines[con.firstline & (CON_MAXLINES - 1)].firstrow;
 	else
-	{
-		oldwidth = con.linewidth;
-		con.linewidth = width;
-		oldtotallines = con.totallines;
-		con.totallines = CON_TEXTSIZE / con.linewidth;
-		numlines = oldtotallines;
+		firstrow = con.current + 1;
 
-		if (con.totallines < numlines)
-			numlines = con.totallines;
+	if (con.current + 1 - firstrow > CON_MAXROWS)
+		firstrow = con.current + 1 - CON_MAXROWS;
 
-		numchars = oldwidth;
+	con.totallines = con.current + 1 - firstrow;
 
-		if (con.linewidth < numchars)
-			numchars = con.linewidth;
+	if (con.display < firstrow)
+		con.display = firstrow;
+}
 
-		memcpy (tbuf, con.text, CON_TEXTSIZE);
-		memset (con.text, ' ', CON_TEXTSIZE);
+/*
+================
+Con_CheckResize
 
-		for (i = 0; i < numlines; i++)
-		{
-			for (j = 0; j < numchars; j++)
-			{
-				con.text[(con.totallines - 1 - i) * con.linewidth + j] =
-					tbuf[((con.current - i + oldtotallines) %
-							oldtotallines) * oldwidth + j];
-			}
-		}
+If the line width has changed, lay the text out again.
+================
+*/
+void Con_CheckResize (void)
+{
+	int		width;
+	float scale = SCR_GetConsoleScale();
+
+	width = ((int)(viddef.width / scale) >> 3) - 2;
 
-		Con_ClearNotify ();
+	if (width == con.linewidth)
+		return;
+
+	if (width < 1)			// video hasn't been initialized yet
+		width = 78;
+
+	con.linewidth = width;
+
+	// nothing is lost, the whole line is still in the text ring
+	if (con.firstline < con.numlines)
+	{
+		con.lines[con.firstline & (CON_MAXLINES - 1)].firstrow = 0;
+		Con_LayoutLines (con.firstline);
 	}
+	else
+		con.current = -1;
+
+	Con_TrimScrollback ();
+	Con_ClearNotify ();
 
-	con.current = con.totallines - 1;
 	con.display = con.current;
 }
 
@@ -314,6 +409,7 @@ void Con_Init (void)
 {
 	con.linewidth = -1;
 
+	Con_Reset ();
 	Con_CheckResize ();
 
 	Com_Printf ("Console initialized.\n");
@@ -335,18 +431,20 @@ void Con_Init (void)
 
 /*
 ===============
-Con_Linefeed
+Con_NewLine
 ===============
 */
-void Con_Linefeed (void)
+static void Con_NewLine (void)
 {
-	con.x = 0;
+	conline_t	*line;
 
-	if (con.display == con.current)
-		con.display++;
+	line = &con.lines[con.numlines & (CON_MAXLINES - 1)];
+	line->start = con.textend;
+	line->length = 0;
+	line->firstrow = con.current + 1;
 
-	con.current++;
-	memset (&con.text[(con.current%con.totallines) *con.linewidth], ' ', con.linewidth);
+	con.numlines++;
+	con.linefeed = false;
 }
 
 /*
@@ -356,14 +454,18 @@ Con_Print
 Handles cursor positioning, line wrapping, etc
 All console printing must go through this in order to be logged to disk
 If no console is visible, the text will appear at the top of the game window
+
+Only the lines touched by the print are laid out again, so the cost
+doesn't grow with the size of the scrollback
 ================
 */
 void Con_Print (char *txt)
 {
-	int		y;
-	int		c, l;
-	static int	cr;
+	int		c, i;
 	int		mask;
+	int		first, oldcurrent;
+	qboolean	follow;
+	conline_t	*line;
 
 	if (!con.initialized)
 		return;
@@ -376,58 +478,72 @@ void Con_Print (char *txt)
 	else
 		mask = 0;
 
+	if (!*txt)
+		return;
 
-	while ((c = *txt))
-	{
-		// count word length
-		for (l = 0; l < con.linewidth; l++)
-			if (txt[l] <= ' ')
-				break;
-
-		// word wrap
-		if ((l != con.linewidth) && (con.x + l > con.linewidth))
-			con.x = 0;
-
-		txt++;
+	oldcurrent = con.current;
+	follow = (con.display == con.current);
 
-		if (cr)
-		{
-			con.current--;
-			cr = false;
-		}
+	// the open line is laid out again along with any new ones
+	first = con.numlines ? con.numlines - 1 : 0;
 
-		if (!con.x)
+	while ((c = *txt++))
+	{
+		if (con.cr)
 		{
-			Con_Linefeed ();
+			// rewrite the open line
+			if (con.numlines && !con.linefeed)
+			{
+				line = &con.lines[(con.numlines - 1) & (CON_MAXLINES - 1)];
+				line->start = con.textend;
+				line->length = 0;
+			}
 
-			// mark time for transparent overlay
-			if (con.current >= 0)
-				con.times[con.current % NUM_CON_TIMES] = cls.realtime;
+			con.cr = false;
 		}
 
 		switch (c)
 		{
 		case '\n':
-			con.x = 0;
+			if (!con.numlines || con.linefeed)
+				Con_NewLine ();
+
+			con.linefeed = true;
 			break;
 
 		case '\r':
-			con.x = 0;
-			cr = 1;
+			con.cr = true;
 			break;
 
-		default:	// display character and advance
-			y = con.current % con.totallines;
-			con.text[y *con.linewidth+con.x] = c | mask | con.ormask;
-			con.x++;
-
-			if (con.x >= con.linewidth)
-				con.x = 0;
+		default:	// add the character to the open line
+			if (!con.numlines || con.linefeed ||
+				con.lines[(con.numlines - 1) & (CON_MAXLINES - 1)].length >= CON_MAXLINELEN)
+				Con_NewLine ();
 
+			con.text[con.textend & CON_TEXTMASK] = c | mask | con.ormask;
+			con.textend++;
+			con.lines[(con.numlines - 1) & (CON_MAXLINES - 1)].length++;
 			break;
 		}
-
 	}
+
+	Con_LayoutLines (first);
+	Con_TrimScrollback ();
+
+	// mark time for transparent overlay
+	i = con.current - NUM_CON_TIMES + 1;
+
+	if (i <= oldcurrent)
+		i = oldcurrent + 1;
+
+	if (i < 0)
+		i = 0;
+
+	for (; i <= con.current; i++)
+		con.times[i % NUM_CON_TIMES] = cls.realtime;
+
+	if (follow || con.display > con.current)
+		con.display = con.current;
 }
 
 
@@ -440,6 +556,32 @@ DRAWING
 */
 
 
+/*
+================
+Con_DrawRow
+
+Draws a row of text in one call, or two if it wraps around the end of
+the text ring
+================
+*/
+static void Con_DrawRow (int x, int y, int row, float scale)
+{
+	conrow_t	*r = &con.rows[row & (CON_MAXROWS - 1)];
+	int			ofs = r->start & CON_TEXTMASK;
+	int			len = r->length;
+
+	if (ofs + len > CON_TEXTSIZE)
+	{
+		RE_Draw_StringScaled (x, y, con.text + ofs, CON_TEXTSIZE - ofs, scale);
+		x += (CON_TEXTSIZE - ofs) * 8 * scale;
+		len -= CON_TEXTSIZE - ofs;
+		ofs = 0;
+	}
+
+	RE_Draw_StringScaled (x, y, con.text + ofs, len, scale);
+}
+
+
 /*
 ================
 Con_DrawInput
@@ -474,8 +616,7 @@ void Con_DrawInput (void)
 		text += 1 + key_linepos - con.linewidth;
 
 	// draw it
-	for (i = 0; i < con.linewidth; i++)
-		RE_Draw_CharScaled (((i + 1) << 3) * scale, con.vislines - 22 * scale, text[i], scale);
+	RE_Draw_StringScaled (8 * scale, con.vislines - 22 * scale, text, con.linewidth, scale);
 
 	// remove cursor
 	key_lines[edit_line][key_linepos] = 0;
@@ -492,7 +633,6 @@ Draws the last few lines of output transparently over the game top
 void Con_DrawNotify (void)
 {
 	int		x, v;
-	char	*text;
 	int		i;
 	int		time;
 	char	*s;
@@ -517,10 +657,10 @@ void Con_DrawNotify (void)
 		if (time > con_notifytime->value * 1000)
 			continue;
 
-		text = con.text + (i % con.totallines) * con.linewidth;
+		if (con.current - i >= con.totallines)
+			continue;		// cleared or scrolled out
 
-		for (x = 0; x < con.linewidth; x++)
-			RE_Draw_CharScaled (((x + 1) << 3) * scale, v * scale, text[x], scale);
+		Con_DrawRow (8 * scale, v * scale, i, scale);
 
 		v += 8;
 	}
@@ -543,13 +683,8 @@ void Con_DrawNotify (void)
 		if (chat_bufferlen > (viddef.width >> 3) - (skip + 1))
 			s += chat_bufferlen - ((viddef.width >> 3) - (skip + 1));
 
-		x = 0;
-
-		while (s[x])
-		{
-			RE_Draw_CharScaled (((x + skip) << 3) * scale, v * scale, s[x], scale);
-			x++;
-		}
+		x = strlen (s);
+		RE_Draw_StringScaled ((skip << 3) * scale, v * scale, s, x, scale);
 
 		RE_Draw_CharScaled (((x + skip) << 3) * scale, v + scale, 10 + ((cls.realtime >> 8) & 1), scale);
 		v += 8;
@@ -619,10 +754,7 @@ void Con_DrawConsole (float frac)
 		if (con.current - row >= con.totallines)
 			break;		// past scrollback wrap point
 
-		text = con.text + (row % con.totallines) * con.linewidth;
-
-		for (x = 0; x < con.linewidth; x++)
-			RE_Draw_CharScaled (((x + 1) << 3) * scale, y * scale, text[x], scale);
+		Con_DrawRow (8 * scale, y * scale, row, scale);
 	}
 
 	// draw the download bar
@@ -672,8 +804,7 @@ void Con_DrawConsole (float frac)
 		// draw it
 		y = con.vislines - 12;
 
-		for (i = 0; i < strlen (dlbar); i++)
-			RE_Draw_CharScaled (((i + 1) << 3) * scale, y * scale, dlbar[i], scale);
+		RE_Draw_StringScaled (8 * scale, y * scale, dlbar, strlen (dlbar), scale);
 	}
 
 	// draw the input prompt, user text, and cursor if desired
@@ -794,6 +794,9 @@ void CL_ParseFrame (void)
 	// save the frame off in the backup array for later delta comparisons
 	cl.frames[cl.frame.serverframe &UPDATE_MASK] = cl.frame;
 
+	// find everything prediction has to clip against
+	CL_BuildSolidList ();
+
 	if (cl.frame.valid)
 	{
 		// getting a valid frame message ends the connection process
@@ -888,6 +891,361 @@ struct model_s *S_RegisterSexedModel (entity_state_t *ent, char *base)
 // PMM - used in shell code
 extern int Developer_searchpath (int who);
 // pmm
+/*
+==============================================================================
+
+ENTITY CULLING
+
+Packet entities are tested against the view frustum before any of their
+refresh entities are built.  The server only culls them by PVS, so
+everything behind the player still arrives, and there is no point in
+picking models, skins and shells for them only to have the refresh throw
+them away.  Trails and dynamic lights are still run for culled entities,
+since what they leave behind may well be in view.
+
+Entities with a clipping box are tested as spheres padded out past it.
+Other alias models use the radius the refresh works out over all of
+their frames, and anything it doesn't know the size of is never culled.
+
+==============================================================================
+*/
+
+#define	CULL_RADIUS		128		// minimum radius of a non brush entity
+#define	CULL_PAD		64		// how far animations may reach past the box
+
+static cplane_t	cl_cullplanes[4];
+static qboolean	cl_cullactive;
+
+/*
+===============
+CL_SetupCull
+
+Builds the culling frustum the refresh is going to use, a little wider
+===============
+*/
+static void CL_SetupCull (void)
+{
+	float	fov_x, fov_y;
+	vec3_t	forward, right, up;
+	int		i;
+
+	cl_cullactive = (cl_cullentities->value && viddef.width > 0 && viddef.height > 0);
+
+	if (!cl_cullactive)
+		return;
+
+	// the same as SCR_CalcFOV, which hasn't been run for this frame yet
+	fov_y = SCR_CalcFovY (cl.refdef.fov_x, 640, 480) + 4;
+	fov_x = SCR_CalcFovX (fov_y, viddef.width, viddef.height) + 4;
+
+	if (fov_x > 179 || fov_y > 179)
+	{
+		cl_cullactive = false;
+		return;
+	}
+
+	VectorCopy (cl.v_forward, forward);
+	VectorCopy (cl.v_right, right);
+	VectorCopy (cl.v_up, up);
+
+	// rotate forward right by fov_x / 2 degrees
+	RotatePointAroundVector (cl_cullplanes[0].normal, up, forward, -(90 - fov_x / 2));
+	// rotate forward left by fov_x / 2 degrees
+	RotatePointAroundVector (cl_cullplanes[1].normal, up, forward, 90 - fov_x / 2);
+	// rotate forward up by fov_y / 2 degrees
+	RotatePointAroundVector (cl_cullplanes[2].normal, right, forward, 90 - fov_y / 2);
+	// rotate forward down by fov_y / 2 degrees
+	RotatePointAroundVector (cl_cullplanes[3].normal, right, forward, -(90 - fov_y / 2));
+
+	for (i = 0; i < 4; i++)
+		cl_cullplanes[i].dist = DotProduct (cl.refdef.vieworg, cl_cullplanes[i].normal);
+}
+
+/*
+===============
+CL_CullPacketEntity
+
+Returns true if nothing of the entity can be in view
+===============
+*/
+static qboolean CL_CullPacketEntity (entity_state_t *s1, vec3_t origin, unsigned int renderfx)
+{
+	vec3_t		center, mins, maxs;
+	float		radius;
+	cmodel_t	*cmodel;
+	int			i, x, zd, zu;
+	float		modelradius;
+	int			models[4];
+
+	if (!cl_cullactive)
+		return false;
+
+	// beams span two points and the player model is looked after elsewhere
+	if (renderfx & RF_BEAM)
+		return false;
+
+	if (s1->number == cl.playernum + 1)
+		return false;
+
+	if (s1->solid == 31)
+	{
+		// brush models are positioned by their origin
+		cmodel = cl.model_clip[s1->modelindex];
+
+		if (!cmodel)
+			return false;
+
+		VectorAdd (cmodel->mins, cmodel->maxs, center);
+		VectorScale (center, 0.5, center);
+		VectorAdd (center, origin, center);
+
+		VectorSubtract (cmodel->maxs, cmodel->mins, maxs);
+		radius = VectorLength (maxs) * 0.5 + 1;
+
+		// rotating brush models sweep around their origin
+		if (s1->angles[0] || s1->angles[1] || s1->angles[2])
+		{
+			VectorCopy (origin, center);
+
+			for (i = 0; i < 3; i++)
+				maxs[i] = max (fabs (cmodel->mins[i]), fabs (cmodel->maxs[i]));
+
+			radius = VectorLength (maxs) + 1;
+		}
+	}
+	else
+	{
+		VectorCopy (origin, center);
+
+		// the largest of the models drawn for it, all frames included,
+		// or 0 if any of them has an unknown size
+		models[0] = s1->modelindex;
+		models[1] = s1->modelindex2;
+		models[2] = s1->modelindex3;
+		models[3] = s1->modelindex4;
+		radius = 0;
+
+		for (i = 0; i < 4; i++)
+		{
+			x = models[i];
+
+			if (!x)
+				continue;
+
+			// custom player models and models not loaded yet
+			if (x == 255 || !cl.model_draw[x])
+				modelradius = 0;
+			else
+				modelradius = RE_ModelRadius (cl.model_draw[x]);
+
+			if (modelradius <= 0)
+			{
+				radius = 0;
+				break;
+			}
+
+			if (radius < modelradius)
+				radius = modelradius;
+		}
+
+		if (s1->solid)
+		{
+			// encoded bbox, the same as CL_BuildSolidList
+			x = 8 * (s1->solid & 31);
+			zd = 8 * ((s1->solid >> 5) & 31);
+			zu = 8 * ((s1->solid >> 10) & 63) - 32;
+
+			mins[0] = mins[1] = -x;
+			maxs[0] = maxs[1] = x;
+			mins[2] = -zd;
+			maxs[2] = zu;
+
+			VectorSubtract (maxs, mins, maxs);
+			modelradius = VectorLength (maxs) * 0.5 + CULL_PAD;
+
+			if (modelradius < CULL_RADIUS)
+				modelradius = CULL_RADIUS;
+
+			if (radius < modelradius)
+				radius = modelradius;
+		}
+		else if (!radius)
+			return false;	// no idea how far it reaches
+	}
+
+	for (i = 0; i < 4; i++)
+	{
+		if (DotProduct (center, cl_cullplanes[i].normal) - cl_cullplanes[i].dist < -radius)
+			return true;
+	}
+
+	return false;
+}
+
+
+/*
+===============
+CL_AddPacketModels
+
+Adds the refresh entities for a packet entity that is in view
+===============
+*/
+static void CL_AddPacketModels (entity_t *ent, entity_state_t *s1, unsigned int effects, unsigned int renderfx)
+{
+	clientinfo_t	*ci;
+	int				i;
+
+	if (effects & EF_BFG)
+	{
+		ent->flags |= RF_TRANSLUCENT;
+		ent->alpha = 0.30;
+	}
+
+	// RAFAEL
+	if (effects & EF_PLASMA)
+	{
+		ent->flags |= RF_TRANSLUCENT;
+		ent->alpha = 0.6;
+	}
+
+	if (effects & EF_SPHERETRANS)
+	{
+		ent->flags |= RF_TRANSLUCENT;
+
+		// PMM - *sigh* yet more EF overloading
+		if (effects & EF_TRACKERTRAIL)
+			ent->alpha = 0.6;
+		else
+			ent->alpha = 0.3;
+	}
+
+	//pmm
+
+	// add to refresh list
+	V_AddEntity (ent);
+
+
+	// color shells generate a seperate entity for the main model
+	if (effects & EF_COLOR_SHELL)
+	{
+		// PMM - at this point, all of the shells have been handled
+		// if we're in the rogue pack, set up the custom mixing, otherwise just
+		// keep going
+		//			if(Developer_searchpath(2) == 2)
+		//			{
+		// all of the solo colors are fine. we need to catch any of the combinations that look bad
+		// (double & half) and turn them into the appropriate color, and make double/quad something special
+		if (renderfx & RF_SHELL_HALF_DAM)
+		{
+			if (Developer_searchpath (2) == 2)
+			{
+				// ditch the half damage shell if any of red, blue, or double are on
+				if (renderfx & (RF_SHELL_RED | RF_SHELL_BLUE | RF_SHELL_DOUBLE))
+					renderfx &= ~RF_SHELL_HALF_DAM;
+			}
+		}
+
+		if (renderfx & RF_SHELL_DOUBLE)
+		{
+			if (Developer_searchpath (2) == 2)
+			{
+				// lose the yellow shell if we have a red, blue, or green shell
+				if (renderfx & (RF_SHELL_RED | RF_SHELL_BLUE | RF_SHELL_GREEN))
+					renderfx &= ~RF_SHELL_DOUBLE;
+
+				// if we have a red shell, turn it to purple by adding blue
+				if (renderfx & RF_SHELL_RED)
+					renderfx |= RF_SHELL_BLUE;
+				// if we have a blue shell (and not a red shell), turn it to cyan by adding green
+				else if (renderfx & RF_SHELL_BLUE)
+
+					// go to green if it's on already, otherwise do cyan (flash green)
+					if (renderfx & RF_SHELL_GREEN)
+						renderfx &= ~RF_SHELL_BLUE;
+					else
+						renderfx |= RF_SHELL_GREEN;
+			}
+		}
+
+		//			}
+		// pmm
+		ent->flags = renderfx | RF_TRANSLUCENT;
+		ent->alpha = 0.30;
+		V_AddEntity (ent);
+	}
+
+	ent->skin = NULL;		// never use a custom skin on others
+	ent->skinnum = 0;
+	ent->flags = 0;
+	ent->alpha = 0;
+
+	// duplicate for linked models
+	if (s1->modelindex2)
+	{
+		if (s1->modelindex2 == 255)
+		{
+			// custom weapon
+			ci = &cl.clientinfo[s1->skinnum & 0xff];
+			i = (s1->skinnum >> 8); // 0 is default weapon model
+
+			if (!cl_vwep->value || i > MAX_CLIENTWEAPONMODELS - 1)
+				i = 0;
+
+			ent->model = ci->weaponmodel[i];
+
+			if (!ent->model)
+			{
+				if (i != 0)
+					ent->model = ci->weaponmodel[0];
+
+				if (!ent->model)
+					ent->model = cl.baseclientinfo.weaponmodel[0];
+			}
+		}
+		else
+			ent->model = cl.model_draw[s1->modelindex2];
+
+		// PMM - check for the defender sphere shell .. make it translucent
+		// replaces the previous version which used the high bit on modelindex2 to determine transparency
+		if (!Q_strcasecmp (cl.configstrings[CS_MODELS+ (s1->modelindex2)], "models/items/shell/tris.md2"))
+		{
+			ent->alpha = 0.32;
+			ent->flags = RF_TRANSLUCENT;
+		}
+
+		// pmm
+
+		V_AddEntity (ent);
+
+		//PGM - make sure these get reset.
+		ent->flags = 0;
+		ent->alpha = 0;
+		//PGM
+	}
+
+	if (s1->modelindex3)
+	{
+		ent->model = cl.model_draw[s1->modelindex3];
+		V_AddEntity (ent);
+	}
+
+	if (s1->modelindex4)
+	{
+		ent->model = cl.model_draw[s1->modelindex4];
+		V_AddEntity (ent);
+	}
+
+	if (effects & EF_POWERSCREEN)
+	{
+		ent->model = cl_mod_powerscreen;
+		ent->lastframe = 0;
+		ent->currframe = 0;
+		ent->flags |= (RF_TRANSLUCENT | RF_SHELL_GREEN);
+		ent->alpha = 0.30;
+		V_AddEntity (ent);
+	}
+}
+
 /*
 ===============
 CL_AddPacketEntities
@@ -905,6 +1263,9 @@ void CL_AddPacketEntities (frame_t *frame)
 	int					autoanim;
 	clientinfo_t		*ci;
 	unsigned int		effects, renderfx;
+	qboolean			culled;
+
+	CL_SetupCull ();
 
 	// bonus items rotate at a fixed rate
 	autorotate = anglemod (cl.time / 10);
@@ -987,6 +1348,8 @@ void CL_AddPacketEntities (frame_t *frame)
 			}
 		}
 
+		culled = CL_CullPacketEntity (s1, ent.currorigin, renderfx);
+
 		// create a new entity
 
 		// tweak the color of beams
@@ -997,7 +1360,7 @@ void CL_AddPacketEntities (frame_t *frame)
 			ent.skinnum = (s1->skinnum >> ((rand () % 4) * 8)) & 0xff;
 			ent.model = NULL;
 		}
-		else
+		else if (!culled)
 		{
 			// set skin
 			if (s1->modelindex == 255)
@@ -1079,7 +1442,7 @@ void CL_AddPacketEntities (frame_t *frame)
 				V_AddLight (start, 100, 1, 0, 0);
 			}
 		}
-		else
+		else if (!culled)
 		{
 			// interpolate angles
 			float	a1, a2;
@@ -1113,155 +1476,16 @@ void CL_AddPacketEntities (frame_t *frame)
 		if (!s1->modelindex)
 			continue;
 
-		if (effects & EF_BFG)
+		if (culled)
 		{
-			ent.flags |= RF_TRANSLUCENT;
-			ent.alpha = 0.30;
-		}
-
-		// RAFAEL
-		if (effects & EF_PLASMA)
-		{
-			ent.flags |= RF_TRANSLUCENT;
-			ent.alpha = 0.6;
-		}
-
-		if (effects & EF_SPHERETRANS)
-		{
-			ent.flags |= RF_TRANSLUCENT;
-
-			// PMM - *sigh* yet more EF overloading
-			if (effects & EF_TRACKERTRAIL)
-				ent.alpha = 0.6;
-			else
-				ent.alpha = 0.3;
-		}
-
-		//pmm
-
-		// add to refresh list
-		V_AddEntity (&ent);
-
-
-		// color shells generate a seperate entity for the main model
-		if (effects & EF_COLOR_SHELL)
-		{
-			// PMM - at this point, all of the shells have been handled
-			// if we're in the rogue pack, set up the custom mixing, otherwise just
-			// keep going
-			//			if(Developer_searchpath(2) == 2)
-			//			{
-			// all of the solo colors are fine. we need to catch any of the combinations that look bad
-			// (double & half) and turn them into the appropriate color, and make double/quad something special
-			if (renderfx & RF_SHELL_HALF_DAM)
-			{
-				if (Developer_searchpath (2) == 2)
-				{
-					// ditch the half damage shell if any of red, blue, or double are on
-					if (renderfx & (RF_SHELL_RED | RF_SHELL_BLUE | RF_SHELL_DOUBLE))
-						renderfx &= ~RF_SHELL_HALF_DAM;
-				}
-			}
-
-			if (renderfx & RF_SHELL_DOUBLE)
-			{
-				if (Developer_searchpath (2) == 2)
-				{
-					// lose the yellow shell if we have a red, blue, or green shell
-					if (renderfx & (RF_SHELL_RED | RF_SHELL_BLUE | RF_SHELL_GREEN))
-						renderfx &= ~RF_SHELL_DOUBLE;
-
-					// if we have a red shell, turn it to purple by adding blue
-					if (renderfx & RF_SHELL_RED)
-						renderfx |= RF_SHELL_BLUE;
-					// if we have a blue shell (and not a red shell), turn it to cyan by adding green
-					else if (renderfx & RF_SHELL_BLUE)
-
-						// go to green if it's on already, otherwise do cyan (flash green)
-						if (renderfx & RF_SHELL_GREEN)
-							renderfx &= ~RF_SHELL_BLUE;
-						else
-							renderfx |= RF_SHELL_GREEN;
-				}
-			}
-
-			//			}
-			// pmm
-			ent.flags = renderfx | RF_TRANSLUCENT;
-			ent.alpha = 0.30;
-			V_AddEntity (&ent);
-		}
-
-		ent.skin = NULL;		// never use a custom skin on others
-		ent.skinnum = 0;
-		ent.flags = 0;
-		ent.alpha = 0;
-
-		// duplicate for linked models
-		if (s1->modelindex2)
-		{
-			if (s1->modelindex2 == 255)
-			{
-				// custom weapon
-				ci = &cl.clientinfo[s1->skinnum & 0xff];
-				i = (s1->skinnum >> 8); // 0 is default weapon model
-
-				if (!cl_vwep->value || i > MAX_CLIENTWEAPONMODELS - 1)
-					i = 0;
-
-				ent.model = ci->weaponmodel[i];
-
-				if (!ent.model)
-				{
-					if (i != 0)
-						ent.model = ci->weaponmodel[0];
-
-					if (!ent.model)
-						ent.model = cl.baseclientinfo.weaponmodel[0];
-				}
-			}
-			else
-				ent.model = cl.model_draw[s1->modelindex2];
-
-			// PMM - check for the defender sphere shell .. make it translucent
-			// replaces the previous version which used the high bit on modelindex2 to determine transparency
-			if (!Q_strcasecmp (cl.configstrings[CS_MODELS+ (s1->modelindex2)], "models/items/shell/tris.md2"))
-			{
-				ent.alpha = 0.32;
-				ent.flags = RF_TRANSLUCENT;
-			}
-
-			// pmm
-
-			V_AddEntity (&ent);
-
-			//PGM - make sure these get reset.
+			ent.skin = NULL;
+			ent.skinnum = 0;
 			ent.flags = 0;
 			ent.alpha = 0;
-			//PGM
-		}
-
-		if (s1->modelindex3)
-		{
-			ent.model = cl.model_draw[s1->modelindex3];
-			V_AddEntity (&ent);
-		}
-
-		if (s1->modelindex4)
-		{
-			ent.model = cl.model_draw[s1->modelindex4];
-			V_AddEntity (&ent);
 		}
+		else
+			CL_AddPacketModels (&ent, s1, effects, renderfx);
 
-		if (effects & EF_POWERSCREEN)
-		{
-			ent.model = cl_mod_powerscreen;
-			ent.lastframe = 0;
-			ent.currframe = 0;
-			ent.flags |= (RF_TRANSLUCENT | RF_SHELL_GREEN);
-			ent.alpha = 0.30;
-			V_AddEntity (&ent);
-		}
 
 		// add automatic particle trails
 		if ((effects&~EF_ROTATE))
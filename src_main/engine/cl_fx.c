@@ -869,10 +869,18 @@ typedef struct particle_s
 #define	PARTICLE_GRAVITY	40
 */
 
-cparticle_t	*active_particles, *free_particles;
+/*
+Live particles are packed at the front of the pool, so updating them is
+a straight walk through memory; a particle that fades out is replaced by
+the last live one.  cl_maxparticles sizes the pool, up to MAX_PARTICLES,
+and takes effect the next time the particles are cleared.
+*/
 
-cparticle_t	particles[MAX_PARTICLES];
-int			cl_numparticles = MAX_PARTICLES;
+static cparticle_t	*particles;
+int			cl_numparticles;		// size of the pool
+int			cl_activeparticles;		// live particles at the front of the pool
+
+extern unsigned	d_8to24table_rgba[];
 
 
 /*
@@ -882,15 +890,40 @@ CL_ClearParticles
 */
 void CL_ClearParticles (void)
 {
-	int		i;
+	int		count;
+
+	count = cl_maxparticles ? cl_maxparticles->value : MAX_PARTICLES;
 
-	free_particles = &particles[0];
-	active_particles = NULL;
+	if (count < 1024)
+		count = 1024;
+	if (count > MAX_PARTICLES)
+		count = MAX_PARTICLES;
 
-	for (i = 0; i < cl_numparticles; i++)
-		particles[i].next = &particles[i+1];
+	if (count != cl_numparticles)
+	{
+		if (particles)
+			Z_Free (particles);
 
-	particles[cl_numparticles-1].next = NULL;
+		particles = Z_Malloc (count * sizeof (cparticle_t));
+		cl_numparticles = count;
+	}
+
+	cl_activeparticles = 0;
+}
+
+/*
+===============
+CL_AllocParticle
+
+Returns NULL when the pool is full
+===============
+*/
+cparticle_t *CL_AllocParticle (void)
+{
+	if (cl_activeparticles >= cl_numparticles)
+		return NULL;
+
+	return &particles[cl_activeparticles++];
 }
 
 
@@ -909,14 +942,10 @@ void CL_ParticleEffect (vec3_t org, vec3_t dir, int color, int count)
 
 	for (i = 0; i < count; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		p->color = color + (rand () & 7);
 
@@ -950,14 +979,10 @@ void CL_ParticleEffect2 (vec3_t org, vec3_t dir, int color, int count)
 
 	for (i = 0; i < count; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		p->color = color;
 
@@ -992,14 +1017,10 @@ void CL_ParticleEffect3 (vec3_t org, vec3_t dir, int color, int count)
 
 	for (i = 0; i < count; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		p->color = color;
 
@@ -1031,14 +1052,10 @@ void CL_TeleporterParticles (entity_state_t *ent)
 
 	for (i = 0; i < 8; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		p->color = 0xdb;
 
@@ -1073,14 +1090,10 @@ void CL_LogoutEffect (vec3_t org, int type)
 
 	for (i = 0; i < 500; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 
 		if (type == MZ_LOGIN)
@@ -1119,14 +1132,10 @@ void CL_ItemRespawnParticles (vec3_t org)
 
 	for (i = 0; i < 64; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 
 		p->color = 0xd4 + (rand () & 3);	// green
@@ -1159,14 +1168,10 @@ void CL_ExplosionParticles (vec3_t org)
 
 	for (i = 0; i < 256; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		p->color = 0xe0 + (rand () & 7);
 
@@ -1199,14 +1204,10 @@ void CL_BigTeleportParticles (vec3_t org)
 
 	for (i = 0; i < 4096; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 
 		p->color = colortable[rand () &3];
@@ -1251,14 +1252,10 @@ void CL_BlasterParticles (vec3_t org, vec3_t dir, unsigned int color)
 
 	for (i = 0; i < count; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		p->color = color + (rand () & 7);
 
@@ -1305,13 +1302,10 @@ void CL_BlasterTrail (vec3_t start, vec3_t end, float color)
 	{
 		len -= dec;
 
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -1357,13 +1351,10 @@ void CL_QuadTrail (vec3_t start, vec3_t end)
 	{
 		len -= dec;
 
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -1409,13 +1400,10 @@ void CL_FlagTrail (vec3_t start, vec3_t end, float color)
 	{
 		len -= dec;
 
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -1479,16 +1467,13 @@ void CL_DiminishingTrail (vec3_t start, vec3_t end, centity_t *old, int flags)
 	{
 		len -= dec;
 
-		if (!free_particles)
+		if (cl_activeparticles >= cl_numparticles)
 			return;
 
 		// drop less particles as it flies
 		if ((rand () & 1023) < old->trailcount)
 		{
-			p = free_particles;
-			free_particles = p->next;
-			p->next = active_particles;
-			active_particles = p;
+			p = CL_AllocParticle ();
 			VectorClear (p->accel);
 
 			p->time = cl.time;
@@ -1594,15 +1579,12 @@ void CL_RocketTrail (vec3_t start, vec3_t end, centity_t *old)
 	{
 		len -= dec;
 
-		if (!free_particles)
+		if (cl_activeparticles >= cl_numparticles)
 			return;
 
 		if ((rand () & 7) == 0)
 		{
-			p = free_particles;
-			free_particles = p->next;
-			p->next = active_particles;
-			active_particles = p;
+			p = CL_AllocParticle ();
 
 			VectorClear (p->accel);
 			p->time = cl.time;
@@ -1652,14 +1634,10 @@ void CL_RailTrail (vec3_t start, vec3_t end)
 
 	for (i = 0; i < len; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		VectorClear (p->accel);
 
@@ -1691,14 +1669,10 @@ void CL_RailTrail (vec3_t start, vec3_t end)
 	{
 		len -= dec;
 
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		VectorClear (p->accel);
 
@@ -1744,13 +1718,10 @@ void CL_IonripperTrail (vec3_t start, vec3_t ent)
 	{
 		len -= dec;
 
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -1807,14 +1778,10 @@ void CL_BubbleTrail (vec3_t start, vec3_t end)
 
 	for (i = 0; i < len; i += dec)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		VectorClear (p->accel);
 		p->time = cl.time;
 
@@ -1880,14 +1847,10 @@ void CL_FlyParticles (vec3_t origin, int count)
 		forward[1] = cp * sy;
 		forward[2] = -sp;
 
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 
 		dist = sin (ltime + i) * 64;
@@ -1982,14 +1945,10 @@ void CL_BfgParticles (entity_t *ent)
 		forward[1] = cp * sy;
 		forward[2] = -sp;
 
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 
 		dist = sin (ltime + i) * 64;
@@ -2044,13 +2003,10 @@ void CL_TrapParticles (entity_t *ent)
 	{
 		len -= dec;
 
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -2089,14 +2045,10 @@ void CL_TrapParticles (entity_t *ent)
 			for (j = -2; j <= 2; j += 4)
 				for (k = -2; k <= 4; k += 4)
 				{
-					if (!free_particles)
+					p = CL_AllocParticle ();
+					if (!p)
 						return;
 
-					p = free_particles;
-					free_particles = p->next;
-					p->next = active_particles;
-					active_particles = p;
-
 					p->time = cl.time;
 					p->color = 0xe0 + (rand () & 3);
 
@@ -2135,14 +2087,10 @@ void CL_BFGExplosionParticles (vec3_t org)
 
 	for (i = 0; i < 256; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		p->color = 0xd0 + (rand () & 7);
 
@@ -2178,14 +2126,10 @@ void CL_TeleportParticles (vec3_t org)
 		for (j = -16; j <= 16; j += 4)
 			for (k = -16; k <= 32; k += 4)
 			{
-				if (!free_particles)
+				p = CL_AllocParticle ();
+				if (!p)
 					return;
 
-				p = free_particles;
-				free_particles = p->next;
-				p->next = active_particles;
-				active_particles = p;
-
 				p->time = cl.time;
 				p->color = 7 + (rand () & 7);
 
@@ -2217,61 +2161,54 @@ CL_AddParticles
 */
 void CL_AddParticles (void)
 {
-	cparticle_t		*p, *next;
+	cparticle_t		*p;
+	particle_t		*out;
 	float			alpha;
 	float			time, time2;
-	vec3_t			org;
-	int				color;
-	cparticle_t		*active, *tail;
-
-	active = NULL;
-	tail = NULL;
+	int				i, count;
 
-	for (p = active_particles; p; p = next)
+	// drop everything that has faded out, so the survivors can
+	// go straight into the refresh list
+	for (i = 0; i < cl_activeparticles; )
 	{
-		next = p->next;
+		p = &particles[i];
 
 		// PMM - added INSTANT_PARTICLE handling for heat beam
-		if (p->alphavel != INSTANT_PARTICLE)
-		{
-			time = (cl.time - p->time) * 0.001;
-			alpha = p->alpha + time * p->alphavel;
-
-			if (alpha <= 0)
-			{
-				// faded out
-				p->next = free_particles;
-				free_particles = p;
-				continue;
-			}
-		}
-		else
+		if (p->alphavel != INSTANT_PARTICLE
+			&& p->alpha + (cl.time - p->time) * 0.001 * p->alphavel <= 0)
 		{
-			alpha = p->alpha;
+			*p = particles[--cl_activeparticles];
+			continue;
 		}
 
-		p->next = NULL;
+		i++;
+	}
+
+	count = V_ReserveParticles (&out, cl_activeparticles);
+
+	for (i = 0, p = particles; i < count; i++, p++, out++)
+	{
+		time = (cl.time - p->time) * 0.001;
 
-		if (!tail)
-			active = tail = p;
+		if (p->alphavel != INSTANT_PARTICLE)
+			alpha = p->alpha + time * p->alphavel;
 		else
-		{
-			tail->next = p;
-			tail = p;
-		}
+			alpha = p->alpha;
 
 		if (alpha > 1.0)
 			alpha = 1;
 
-		color = p->color;
-
 		time2 = time * time;
 
-		org[0] = p->org[0] + p->vel[0] * time + p->accel[0] * time2;
-		org[1] = p->org[1] + p->vel[1] * time + p->accel[1] * time2;
-		org[2] = p->org[2] + p->vel[2] * time + p->accel[2] * time2;
+		out->origin[0] = p->org[0] + p->vel[0] * time + p->accel[0] * time2;
+		out->origin[1] = p->org[1] + p->vel[1] * time + p->accel[1] * time2;
+		out->origin[2] = p->org[2] + p->vel[2] * time + p->accel[2] * time2;
 
-		V_AddParticle (org, color, alpha);
+		// same as V_AddParticle
+		out->soft_color = (int)p->color;
+		out->color = d_8to24table_rgba[out->soft_color & 255];
+		out->rgba[3] = (alpha < 0) ? 0 : alpha * 255;
+		out->alpha = alpha;
 
 		// PMM
 		if (p->alphavel == INSTANT_PARTICLE)
@@ -2280,8 +2217,6 @@ void CL_AddParticles (void)
 			p->alpha = 0.0;
 		}
 	}
-
-	active_particles = active;
 }
 
 
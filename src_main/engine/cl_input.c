@@ -483,6 +483,7 @@ void CL_RefreshCmd(void)
 	}
 	
 	cmd->msec = ms;
+	cls.cmdrefreshed = true;
 	
 	// Update frame time for the next call
 	old_sys_frame_time = sys_frame_time;
@@ -657,10 +658,12 @@ void CL_SendCmd (void)
 
 	// deliver the message
 	Netchan_Transmit (&cls.netchan, buf.cursize, buf.data);
+	cls.lastcmdsend = Sys_Milliseconds ();
 
 	// reinit the current cmd buffer
 	cmd = &cl.cmds[cls.netchan.outgoing_sequence & (CMD_BACKUP - 1)];
 	memset(cmd, 0, sizeof(*cmd));
+	cls.cmdrefreshed = false;
 }
 
 
@@ -40,15 +40,21 @@ cvar_t	*rcon_client_password;
 cvar_t	*rcon_address;
 
 cvar_t	*cl_noskins;
+cvar_t	*cl_loadbudget;
 cvar_t	*cl_autoskins;
 cvar_t	*cl_footsteps;
 cvar_t	*cl_timeout;
 cvar_t	*cl_predict;
+cvar_t	*cl_netthread;
+cvar_t	*cl_predictcache;
+cvar_t	*cl_showpredict;
 cvar_t	*cl_gun;
 
 cvar_t	*cl_add_particles;
+cvar_t	*cl_maxparticles;
 cvar_t	*cl_add_lights;
 cvar_t	*cl_add_entities;
+cvar_t	*cl_cullentities;
 cvar_t	*cl_add_blend;
 
 cvar_t	*cl_shownet;
@@ -374,6 +380,9 @@ void CL_Drop (void)
 	if (cls.state == ca_disconnected)
 		return;
 
+	// we may have been thrown out of the middle of a render
+	CL_NetLock ();
+
 	CL_Disconnect ();
 
 	// drop loading plaque unless this is the initial game start
@@ -608,6 +617,9 @@ void CL_Disconnect (void)
 						time / 1000.0, cl.timedemo_frames * 1000.0 / time);
 	}
 
+	// a benchmark moves on to its next demo
+	Bench_DemoFinished ();
+
 	VectorClear (cl.refdef.blend);
 	RE_SetPalette (NULL);
 
@@ -1431,12 +1443,18 @@ void CL_InitLocal (void)
 	cl_add_blend = Cvar_Get ("cl_blend", "1", 0);
 	cl_add_lights = Cvar_Get ("cl_lights", "1", 0);
 	cl_add_particles = Cvar_Get ("cl_particles", "1", 0);
+	cl_maxparticles = Cvar_Get ("cl_maxparticles", "16384", CVAR_ARCHIVE);
 	cl_add_entities = Cvar_Get ("cl_entities", "1", 0);
+	cl_cullentities = Cvar_Get ("cl_cullentities", "1", 0);
 	cl_gun = Cvar_Get ("cl_gun", "1", 0);
 	cl_footsteps = Cvar_Get ("cl_footsteps", "1", 0);
 	cl_noskins = Cvar_Get ("cl_noskins", "0", 0);
+	cl_loadbudget = Cvar_Get ("cl_loadbudget", "2", CVAR_ARCHIVE);
 	cl_autoskins = Cvar_Get ("cl_autoskins", "0", 0);
 	cl_predict = Cvar_Get ("cl_predict", "1", 0);
+	cl_netthread = Cvar_Get ("cl_netthread", "0", CVAR_ARCHIVE);
+	cl_predictcache = Cvar_Get ("cl_predictcache", "1", 0);
+	cl_showpredict = Cvar_Get ("cl_showpredict", "0", 0);
 
 	cl_upspeed = Cvar_Get ("cl_upspeed", "200", 0);
 	cl_forwardspeed = Cvar_Get ("cl_forwardspeed", "200", 0);
@@ -1583,6 +1601,179 @@ void CL_UpdateWindowedMouse(void)
 	}
 }
 
+/*
+==============================================================================
+
+NETWORK THREAD
+
+With cl_netthread set, moves are sent from a thread of their own at the
+cl_maxfps rate, so a long render frame doesn't hold up the commands the
+server is waiting for.  The main thread owns all client state and only
+lets go of it while it draws the screen and updates sound, which is when
+the network thread gets to finish off and send the current command.
+Input is still sampled on the main thread, where SDL pumps its events,
+and the renderer stays there with its GL context.  So this keeps the
+server fed during long frames but doesn't lower input latency: a send
+that comes before the main thread has sampled again repeats the last move.
+
+==============================================================================
+*/
+
+static void		*cl_netthread_handle;
+static void		*cl_netlock;
+static void		*cl_netwake;		// only posted to stop the thread
+static int		cl_netquit;
+static qboolean	cl_netlocked;		// the main thread holds cl_netlock
+
+/*
+==================
+CL_NetLock
+
+Takes back the client state from the network thread; safe to call
+when it is already held
+==================
+*/
+void CL_NetLock (void)
+{
+	if (!cl_netlock || cl_netlocked)
+		return;
+
+	Sys_LockMutex (cl_netlock);
+	cl_netlocked = true;
+}
+
+/*
+==================
+CL_NetUnlock
+==================
+*/
+void CL_NetUnlock (void)
+{
+	if (!cl_netlock || !cl_netlocked)
+		return;
+
+	Sys_UnlockMutex (cl_netlock);
+	cl_netlocked = false;
+}
+
+/*
+==================
+CL_NetThread
+==================
+*/
+static int CL_NetThread (void *data)
+{
+	int		now, interval, msec;
+	usercmd_t	*cmd, *oldcmd;
+
+	Scratch_InitThread (SCRATCH_THREAD_SIZE);
+
+	cls.lastcmdsend = Sys_Milliseconds ();
+
+	while (!Sys_AtomicGet (&cl_netquit))
+	{
+		Sys_SemWait (cl_netwake, 1);
+
+		interval = (cl_maxfps->value >= 1) ? 1000 / (int)cl_maxfps->value : 16;
+		now = Sys_Milliseconds ();
+
+		if (now - Sys_AtomicGet (&cls.lastcmdsend) < interval)
+			continue;
+
+		Sys_LockMutex (cl_netlock);
+
+		// userinfo changes and connection traffic stay on the main thread
+		if (cls.state == ca_active && !userinfo_modified && !Sys_AtomicGet (&cl_netquit))
+		{
+			now = Sys_Milliseconds ();
+			msec = now - cls.lastcmdsend;
+
+			if (msec > 250)
+				msec = 100;
+			else if (msec < 1)
+				msec = 1;
+
+			cmd = &cl.cmds[cls.netchan.outgoing_sequence & (CMD_BACKUP - 1)];
+
+			// the main thread hasn't sampled input since the last send, so
+			// repeat what the player was doing instead of sending a blank move;
+			// CL_FinalizeCmd fills the buttons in from the key state
+			if (!cls.cmdrefreshed)
+			{
+				oldcmd = &cl.cmds[(cls.netchan.outgoing_sequence - 1) & (CMD_BACKUP - 1)];
+
+				VectorCopy (oldcmd->angles, cmd->angles);
+				cmd->forwardmove = oldcmd->forwardmove;
+				cmd->sidemove = oldcmd->sidemove;
+				cmd->upmove = oldcmd->upmove;
+				cmd->lightlevel = oldcmd->lightlevel;
+			}
+
+			cmd->msec = msec;
+
+			CL_SendCmd ();
+		}
+
+		Sys_UnlockMutex (cl_netlock);
+	}
+
+	Scratch_ShutdownThread ();
+
+	return 0;
+}
+
+/*
+==================
+CL_StopNetThread
+==================
+*/
+void CL_StopNetThread (void)
+{
+	if (!cl_netthread_handle)
+		return;
+
+	CL_NetUnlock ();
+
+	Sys_AtomicSet (&cl_netquit, 1);
+	Sys_SemPost (cl_netwake);
+	Sys_WaitThread (cl_netthread_handle);
+
+	Sys_DestroySemaphore (cl_netwake);
+	Sys_DestroyMutex (cl_netlock);
+
+	cl_netthread_handle = NULL;
+	cl_netwake = NULL;
+	cl_netlock = NULL;
+}
+
+/*
+==================
+CL_CheckNetThread
+
+Starts or stops the network thread to match cl_netthread
+==================
+*/
+static void CL_CheckNetThread (void)
+{
+	if (!cl_netthread->value)
+	{
+		CL_StopNetThread ();
+		return;
+	}
+
+	if (cl_netthread_handle)
+		return;
+
+	cl_netquit = 0;
+	cl_netlock = Sys_CreateMutex ();
+	cl_netwake = Sys_CreateSemaphore (0);
+
+	// the main thread starts out holding everything
+	CL_NetLock ();
+
+	cl_netthread_handle = Sys_CreateThread (CL_NetThread, NULL, "clnet");
+}
+
 /*
 ==================
 CL_SendCommand
@@ -1617,10 +1808,23 @@ void CL_Frame (int packetdelta, int renderdelta, int timedelta, qboolean packetf
 {
 	static int lasttimecalled;
 	
+	qboolean	forcepacket = false;
+	qboolean	bench;
+	unsigned int	bench_start = 0, bench_parse = 0, bench_render = 0, bench_sound = 0;
+
 	// are we running dedicated?
 	if (dedicated->value)
 		return;
 
+	// an error may have thrown us out while the network thread had the state
+	CL_CheckNetThread ();
+	CL_NetLock ();
+
+	bench = Bench_Running ();
+
+	if (bench)
+		bench_start = Sys_Microseconds ();
+
 	// update the GameSpy query loop if we're pinging some servers
 	CL_GameSpy_Async_Think ();
 
@@ -1652,7 +1856,13 @@ void CL_Frame (int packetdelta, int renderdelta, int timedelta, qboolean packetf
 	if (packetframe || renderframe)
 	{
 		// fetch input packets
+		if (bench)
+			bench_parse = Sys_Microseconds ();
+
 		CL_ReadPackets();
+
+		if (bench)
+			bench_parse = Sys_Microseconds () - bench_parse;
 		
 		// update input
 		CL_UpdateWindowedMouse();
@@ -1661,6 +1871,9 @@ void CL_Frame (int packetdelta, int renderdelta, int timedelta, qboolean packetf
 		// execute whats in the command buffer
 		Cbuf_Execute();
 
+		// register what the server changed, a little at a time
+		CL_ProcessConfigStrings ();
+
 		// perform command
 		if (cls.state > ca_connecting)
 			CL_RefreshCmd();
@@ -1671,13 +1884,31 @@ void CL_Frame (int packetdelta, int renderdelta, int timedelta, qboolean packetf
 	if (cls.forcePacket || userinfo_modified)
 	{
 		packetframe = true;
+		forcepacket = true;
 		cls.forcePacket = false;
 	}
 
 	if (packetframe)
 	{		
-		// sned command and check for resending
-		CL_SendCmd();
+		// sned command and check for resending; once we're in the
+		// game the network thread sends moves on its own schedule
+		if (!cl_netthread_handle || cls.state != ca_active)
+			CL_SendCmd();
+		else if (forcepacket)
+		{
+			// the network thread may already have sent part of this frame,
+			// so only claim the time since its last send; we hold cl_netlock
+			usercmd_t	*cmd = &cl.cmds[cls.netchan.outgoing_sequence & (CMD_BACKUP - 1)];
+			int			msec = Sys_Milliseconds () - cls.lastcmdsend;
+
+			if (msec > 250)
+				msec = 100;
+			else if (msec < 1)
+				msec = 1;
+
+			cmd->msec = msec;
+			CL_SendCmd();
+		}
 		CL_CheckForResend();
 	}
 
@@ -1697,15 +1928,32 @@ void CL_Frame (int packetdelta, int renderdelta, int timedelta, qboolean packetf
 		if (host_speeds->value)
 			time_before_ref = Sys_Milliseconds ();
 
+		// let the network thread send while we draw
+		CL_NetUnlock ();
+
+		if (bench)
+			bench_render = Sys_Microseconds ();
+
 		SCR_UpdateScreen ();
 
+		if (bench)
+			bench_render = Sys_Microseconds () - bench_render;
+
 		if (host_speeds->value)
 			time_after_ref = Sys_Milliseconds ();
 
 		// update audio
+		if (bench)
+			bench_sound = Sys_Microseconds ();
+
 		S_Update (cl.refdef.vieworg, cl.v_forward, cl.v_right, cl.v_up);
 		BGM_Update();
 
+		if (bench)
+			bench_sound = Sys_Microseconds () - bench_sound;
+
+		CL_NetLock ();
+
 		// advance local effects for next frame
 		CL_RunDLights ();
 		CL_RunLightStyles ();
@@ -1739,6 +1987,9 @@ void CL_Frame (int packetdelta, int renderdelta, int timedelta, qboolean packetf
 			}
 		}
 	}
+
+	if (bench)
+		Bench_Frame (Sys_Microseconds () - bench_start, bench_parse, bench_render, bench_sound);
 }
 
 
@@ -1779,6 +2030,8 @@ void CL_Init (void)
 
 	CL_InitLocal ();
 
+	Bench_Init ();
+
 	Cbuf_Execute ();
 }
 
@@ -1803,6 +2056,8 @@ void CL_Shutdown (void)
 
 	isdown = true;
 
+	CL_StopNetThread ();
+
 	CL_WriteConfiguration ();
 
 	BGM_Shutdown ();
@@ -21,9 +21,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "client.h"
 
-extern cparticle_t	*active_particles, *free_particles;
-extern cparticle_t	particles[MAX_PARTICLES];
 extern int			cl_numparticles;
+extern int			cl_activeparticles;
 
 extern void MakeNormalVectors (vec3_t forward, vec3_t right, vec3_t up);
 
@@ -144,14 +143,10 @@ void CL_DebugTrail (vec3_t start, vec3_t end)
 	{
 		len -= dec;
 
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		VectorClear (p->accel);
 		VectorClear (p->vel);
@@ -197,13 +192,10 @@ void CL_SmokeTrail (vec3_t start, vec3_t end, int colorStart, int colorRun, int
 	{
 		len -= spacing;
 
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -243,15 +235,12 @@ void CL_ForceWall (vec3_t start, vec3_t end, int color)
 	{
 		len -= 4;
 
-		if (!free_particles)
+		if (cl_activeparticles >= cl_numparticles)
 			return;
 
 		if (frand () > 0.3)
 		{
-			p = free_particles;
-			free_particles = p->next;
-			p->next = active_particles;
-			active_particles = p;
+			p = CL_AllocParticle ();
 			VectorClear (p->accel);
 
 			p->time = cl.time;
@@ -285,14 +274,10 @@ void CL_FlameEffects (centity_t *ent, vec3_t origin)
 
 	for (n = 0; n < count; n++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		VectorClear (p->accel);
 		p->time = cl.time;
 
@@ -314,13 +299,10 @@ void CL_FlameEffects (centity_t *ent, vec3_t origin)
 
 	for (n = 0; n < count; n++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -353,14 +335,10 @@ void CL_GenericParticleEffect (vec3_t org, vec3_t dir, int color, int count, int
 
 	for (i = 0; i < count; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 
 		if (numcolors > 1)
@@ -409,14 +387,10 @@ void CL_BubbleTrail2 (vec3_t start, vec3_t end, int dist)
 
 	for (i = 0; i < len; i += dec)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		VectorClear (p->accel);
 		p->time = cl.time;
 
@@ -485,14 +459,10 @@ void CL_Heatbeam (vec3_t start, vec3_t end)
 		k = 1;
 #endif
 
-			if (!free_particles)
+			p = CL_AllocParticle ();
+			if (!p)
 				return;
 
-			p = free_particles;
-			free_particles = p->next;
-			p->next = active_particles;
-			active_particles = p;
-
 			p->time = cl.time;
 			VectorClear (p->accel);
 
@@ -583,14 +553,10 @@ void CL_Heatbeam (vec3_t start, vec3_t forward)
 		for (rot = 0; rot < M_PI * 2; rot += rstep)
 		{
 
-			if (!free_particles)
+			p = CL_AllocParticle ();
+			if (!p)
 				return;
 
-			p = free_particles;
-			free_particles = p->next;
-			p->next = active_particles;
-			active_particles = p;
-
 			p->time = cl.time;
 			VectorClear (p->accel);
 			//			rot+= fmod(ltime, 12.0)*M_PI;
@@ -661,14 +627,10 @@ void CL_Heatbeam (vec3_t start, vec3_t end)
 
 	for (i = 0; i < 8; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		VectorClear (p->accel);
 
@@ -707,14 +669,10 @@ void CL_Heatbeam (vec3_t start, vec3_t end)
 
 			for (rot = 0; rot < M_PI*2; rot += rstep)
 			{
-				if (!free_particles)
+				p = CL_AllocParticle ();
+				if (!p)
 					return;
 
-				p = free_particles;
-				free_particles = p->next;
-				p->next = active_particles;
-				active_particles = p;
-
 				p->time = cl.time;
 				VectorClear (p->accel);
 	//			rot+= fmod(ltime, 12.0)*M_PI;
@@ -774,14 +732,10 @@ void CL_ParticleSteamEffect (vec3_t org, vec3_t dir, int color, int count, int m
 
 	for (i = 0; i < count; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		p->color = color + (rand () & 7);
 
@@ -822,14 +776,10 @@ void CL_ParticleSteamEffect2 (cl_sustain_t *self)
 
 	for (i = 0; i < self->count; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		p->color = self->color + (rand () & 7);
 
@@ -887,13 +837,10 @@ void CL_TrackerTrail (vec3_t start, vec3_t end, int particleColor)
 	{
 		len -= dec;
 
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -925,13 +872,10 @@ void CL_Tracker_Shell (vec3_t origin)
 
 	for (i = 0; i < 300; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -957,13 +901,10 @@ void CL_MonsterPlasma_Shell (vec3_t origin)
 
 	for (i = 0; i < 40; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -994,13 +935,10 @@ void CL_Widowbeamout (cl_sustain_t *self)
 
 	for (i = 0; i < 300; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -1031,13 +969,10 @@ void CL_Nukeblast (cl_sustain_t *self)
 
 	for (i = 0; i < 700; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -1065,14 +1000,10 @@ void CL_WidowSplash (vec3_t org)
 
 	for (i = 0; i < 256; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		p->color = colortable[rand () &3];
 
@@ -1099,13 +1030,10 @@ void CL_Tracker_Explode (vec3_t	origin)
 
 	for (i = 0; i < 300; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -1151,13 +1079,10 @@ void CL_TagTrail (vec3_t start, vec3_t end, float color)
 	{
 		len -= dec;
 
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
 		VectorClear (p->accel);
 
 		p->time = cl.time;
@@ -1189,14 +1114,10 @@ void CL_ColorExplosionParticles (vec3_t org, int color, int run)
 
 	for (i = 0; i < 128; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		p->color = color + (rand () % run);
 
@@ -1230,14 +1151,10 @@ void CL_ParticleSmokeEffect (vec3_t org, vec3_t dir, int color, int count, int m
 
 	for (i = 0; i < count; i++)
 	{
-		if (!free_particles)
+		p = CL_AllocParticle ();
+		if (!p)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
-
 		p->time = cl.time;
 		p->color = color + (rand () & 7);
 
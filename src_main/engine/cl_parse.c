@@ -537,6 +537,177 @@ void CL_ParseClientinfo (int player)
 	ci = &cl.clientinfo[player];
 
 	CL_LoadClientinfo (ci, s);
+
+	// no need to do it again if it was waiting in the queue
+	cl.csqueued[player+CS_PLAYERSKINS] = false;
+}
+
+
+/*
+=====================================================================
+
+CONFIGSTRING QUEUE
+
+Registering what a changed configstring refers to can mean loading
+models and skins from disk, and a burst of players joining a full server
+used to stall the client for as long as all their skins took to load.
+Changes are queued instead and registered by CL_ProcessConfigStrings
+for up to cl_loadbudget milliseconds a frame.  Until then a player shows
+up with the base clientinfo, and a sound is registered right away if it
+is started before its turn comes.
+
+Registration goes through the refresh and sound system, so this is done
+on the main thread, spread over frames, rather than in the background.
+cl_loadbudget 0 registers everything as soon as it arrives.
+
+=====================================================================
+*/
+
+/*
+================
+CL_RegisterConfigString
+
+Does whatever a changed configstring calls for
+================
+*/
+static void CL_RegisterConfigString (int i)
+{
+	cl.csqueued[i] = false;
+
+	if (i >= CS_SOUNDS && i < CS_SOUNDS + MAX_SOUNDS)
+		cl.sound_precache[i-CS_SOUNDS] = S_RegisterSound (cl.configstrings[i]);
+	else if (i >= CS_IMAGES && i < CS_IMAGES + MAX_IMAGES)
+		cl.image_precache[i-CS_IMAGES] = RE_Draw_RegisterPic (cl.configstrings[i]);
+	else if (i >= CS_PLAYERSKINS && i < CS_PLAYERSKINS + MAX_CLIENTS)
+		CL_ParseClientinfo (i - CS_PLAYERSKINS);
+}
+
+/*
+================
+CL_QueueConfigString
+================
+*/
+static void CL_QueueConfigString (int i)
+{
+	if (!cl_loadbudget->value)
+	{
+		CL_RegisterConfigString (i);
+		return;
+	}
+
+	if (cl.csqueued[i])
+		return;
+
+	// strings registered out of turn leave stale entries behind,
+	// so make room if that has filled the queue up
+	if (cl.csqueuetail - cl.csqueuehead == MAX_CONFIGSTRINGS)
+	{
+		int		old = cl.csqueue[cl.csqueuehead++ % MAX_CONFIGSTRINGS];
+
+		if (cl.csqueued[old])
+			CL_RegisterConfigString (old);
+	}
+
+	cl.csqueue[cl.csqueuetail++ % MAX_CONFIGSTRINGS] = i;
+	cl.csqueued[i] = true;
+}
+
+/*
+================
+CL_ProcessConfigStrings
+
+Registers queued configstrings until the frame's budget runs out
+================
+*/
+void CL_ProcessConfigStrings (void)
+{
+	unsigned int	start, budget;
+	int				i;
+
+	if (!cl.refresh_prepped)
+		return;
+
+	start = Sys_Microseconds ();
+	budget = cl_loadbudget->value * 1000;
+
+	// always get at least one done, so a tiny budget still makes progress
+	while (cl.csqueuehead != cl.csqueuetail)
+	{
+		i = cl.csqueue[cl.csqueuehead++ % MAX_CONFIGSTRINGS];
+
+		if (!cl.csqueued[i])
+			continue;
+
+		CL_RegisterConfigString (i);
+
+		if (Sys_Microseconds () - start >= budget)
+			break;
+	}
+
+	if (cl.csqueuehead == cl.csqueuetail)
+		cl.csqueuehead = cl.csqueuetail = 0;
+}
+
+/*
+================
+CL_ClearConfigStringQueue
+
+CL_PrepRefresh registers everything, so nothing needs to wait
+================
+*/
+void CL_ClearConfigStringQueue (void)
+{
+	cl.csqueuehead = cl.csqueuetail = 0;
+	memset (cl.csqueued, 0, sizeof (cl.csqueued));
+}
+
+/*
+================
+CL_QueueClientinfo
+
+A changed player name doesn't need the skin loaded again, so only
+queue the player when the model or skin is different
+================
+*/
+static void CL_QueueClientinfo (int player, char *olds)
+{
+	clientinfo_t	*ci = &cl.clientinfo[player];
+	char			*s = cl.configstrings[player+CS_PLAYERSKINS];
+	char			*oldskin, *skin;
+
+	oldskin = strstr (olds, "\\");
+	skin = strstr (s, "\\");
+
+	if (ci->model && !cl.csqueued[player+CS_PLAYERSKINS] && oldskin && skin && !strcmp (oldskin, skin))
+	{
+		strncpy (ci->cinfo, s, sizeof (ci->cinfo));
+		ci->cinfo[sizeof (ci->cinfo)-1] = 0;
+
+		strncpy (ci->name, s, sizeof (ci->name));
+		ci->name[sizeof (ci->name)-1] = 0;
+
+		if (skin - s < sizeof (ci->name))
+			ci->name[skin - s] = 0;
+
+		return;
+	}
+
+	if (cl_loadbudget->value)
+	{
+		// show the name at once, with the base model and skin until it loads
+		strncpy (ci->name, s, sizeof (ci->name));
+		ci->name[sizeof (ci->name)-1] = 0;
+
+		if (skin && skin - s < sizeof (ci->name))
+			ci->name[skin - s] = 0;
+
+		ci->skin = NULL;
+		ci->icon = NULL;
+		ci->model = NULL;
+		memset (ci->weaponmodel, 0, sizeof (ci->weaponmodel));
+	}
+
+	CL_QueueConfigString (player + CS_PLAYERSKINS);
 }
 
 
@@ -582,22 +753,24 @@ void CL_ParseConfigString (void)
 				cl.model_clip[i-CS_MODELS] = CM_InlineModel (cl.configstrings[i]);
 			else
 				cl.model_clip[i-CS_MODELS] = NULL;
+
+			CL_BuildSolidList ();
 		}
 	}
 	else if (i >= CS_SOUNDS && i < CS_SOUNDS + MAX_MODELS)
 	{
 		if (cl.refresh_prepped)
-			cl.sound_precache[i-CS_SOUNDS] = S_RegisterSound (cl.configstrings[i]);
+			CL_QueueConfigString (i);
 	}
 	else if (i >= CS_IMAGES && i < CS_IMAGES + MAX_MODELS)
 	{
 		if (cl.refresh_prepped)
-			cl.image_precache[i-CS_IMAGES] = RE_Draw_RegisterPic (cl.configstrings[i]);
+			CL_QueueConfigString (i);
 	}
 	else if (i >= CS_PLAYERSKINS && i < CS_PLAYERSKINS + MAX_CLIENTS)
 	{
 		if (cl.refresh_prepped && strcmp (olds, s))
-			CL_ParseClientinfo (i - CS_PLAYERSKINS);
+			CL_QueueClientinfo (i - CS_PLAYERSKINS, olds);
 	}
 }
 
@@ -671,6 +844,10 @@ void CL_ParseStartSoundPacket (void)
 	else	// use entity number
 		pos = NULL;
 
+	// don't wait for its turn in the queue
+	if (cl.csqueued[CS_SOUNDS+sound_num])
+		CL_RegisterConfigString (CS_SOUNDS + sound_num);
+
 	if (!cl.sound_precache[sound_num])
 		return;
 
@@ -66,27 +66,55 @@ void CL_CheckPredictionError (void)
 }
 
 
+/*
+==============================================================================
+
+SOLID ENTITY LIST
+
+The solid entities of the current frame with their clipping hulls and
+world bounds worked out once, when the frame is parsed, rather than in
+every prediction trace.  Traces and point contents only clip against
+the entries whose bounds they touch.
+
+==============================================================================
+*/
+
+typedef struct
+{
+	entity_state_t	*ent;
+	int			headnode;		// bmodels only, boxes share the box hull
+	vec3_t		mins, maxs;		// size of a bbox entity
+	vec3_t		absmin, absmax;
+	float		*angles;
+	qboolean	bmodel;
+} clsolid_t;
+
+static clsolid_t	cl_solids[MAX_PARSE_ENTITIES];
+static int			cl_numsolids;
+static int			cl_solidlist;		// bumped every time the list is rebuilt
+
 /*
 ====================
-CL_ClipMoveToEntities
+CL_BuildSolidList
 
+Called whenever a frame is parsed or the inline models change
 ====================
 */
-void CL_ClipMoveToEntities (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, trace_t *tr)
+void CL_BuildSolidList (void)
 {
-	int			i, x, zd, zu;
-	trace_t		trace;
-	int			headnode;
-	float		*angles;
+	int			i, j, x, zd, zu;
 	entity_state_t	*ent;
-	int			num;
-	cmodel_t		*cmodel;
-	vec3_t		bmins, bmaxs;
+	cmodel_t	*cmodel;
+	clsolid_t	*solid;
+	vec3_t		corner;
+	float		radius;
+
+	cl_numsolids = 0;
+	cl_solidlist++;
 
 	for (i = 0; i < cl.frame.num_entities; i++)
 	{
-		num = (cl.frame.parse_entities + i) & (MAX_PARSE_ENTITIES - 1);
-		ent = &cl_parse_entities[num];
+		ent = &cl_parse_entities[(cl.frame.parse_entities + i) & (MAX_PARSE_ENTITIES - 1)];
 
 		if (!ent->solid)
 			continue;
@@ -94,6 +122,9 @@ void CL_ClipMoveToEntities (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end,
 		if (ent->number == cl.playernum + 1)
 			continue;
 
+		solid = &cl_solids[cl_numsolids];
+		solid->ent = ent;
+
 		if (ent->solid == 31)
 		{
 			// special value for bmodel
@@ -102,8 +133,29 @@ void CL_ClipMoveToEntities (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end,
 			if (!cmodel)
 				continue;
 
-			headnode = cmodel->headnode;
-			angles = ent->angles;
+			solid->bmodel = true;
+			solid->headnode = cmodel->headnode;
+			solid->angles = ent->angles;
+
+			if (ent->angles[0] || ent->angles[1] || ent->angles[2])
+			{
+				// expand for rotation
+				for (j = 0; j < 3; j++)
+					corner[j] = max (fabs (cmodel->mins[j]), fabs (cmodel->maxs[j]));
+
+				radius = VectorLength (corner);
+
+				for (j = 0; j < 3; j++)
+				{
+					solid->absmin[j] = ent->origin[j] - radius;
+					solid->absmax[j] = ent->origin[j] + radius;
+				}
+			}
+			else
+			{
+				VectorAdd (ent->origin, cmodel->mins, solid->absmin);
+				VectorAdd (ent->origin, cmodel->maxs, solid->absmax);
+			}
 		}
 		else
 		{
@@ -112,26 +164,81 @@ void CL_ClipMoveToEntities (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end,
 			zd = 8 * ((ent->solid >> 5) & 31);
 			zu = 8 * ((ent->solid >> 10) & 63) - 32;
 
-			bmins[0] = bmins[1] = -x;
-			bmaxs[0] = bmaxs[1] = x;
-			bmins[2] = -zd;
-			bmaxs[2] = zu;
+			solid->mins[0] = solid->mins[1] = -x;
+			solid->maxs[0] = solid->maxs[1] = x;
+			solid->mins[2] = -zd;
+			solid->maxs[2] = zu;
+
+			solid->bmodel = false;
+			solid->angles = vec3_origin;	// boxes don't rotate
 
-			headnode = CM_HeadnodeForBox (bmins, bmaxs);
-			angles = vec3_origin;	// boxes don't rotate
+			VectorAdd (ent->origin, solid->mins, solid->absmin);
+			VectorAdd (ent->origin, solid->maxs, solid->absmax);
+		}
+
+		// a trace can stop within DIST_EPSILON of a surface
+		for (j = 0; j < 3; j++)
+		{
+			solid->absmin[j] -= 1;
+			solid->absmax[j] += 1;
 		}
 
+		cl_numsolids++;
+	}
+}
+
+
+/*
+====================
+CL_ClipMoveToEntities
+
+====================
+*/
+void CL_ClipMoveToEntities (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, trace_t *tr)
+{
+	int			i, j;
+	trace_t		trace;
+	int			headnode;
+	clsolid_t	*solid;
+	vec3_t		boxmins, boxmaxs;
+
+	// the bounds of the whole move
+	for (j = 0; j < 3; j++)
+	{
+		if (end[j] > start[j])
+		{
+			boxmins[j] = start[j] + mins[j];
+			boxmaxs[j] = end[j] + maxs[j];
+		}
+		else
+		{
+			boxmins[j] = end[j] + mins[j];
+			boxmaxs[j] = start[j] + maxs[j];
+		}
+	}
+
+	for (i = 0, solid = cl_solids; i < cl_numsolids; i++, solid++)
+	{
+		if (solid->absmin[0] > boxmaxs[0] || solid->absmin[1] > boxmaxs[1] || solid->absmin[2] > boxmaxs[2]
+			|| solid->absmax[0] < boxmins[0] || solid->absmax[1] < boxmins[1] || solid->absmax[2] < boxmins[2])
+			continue;
+
+		if (solid->bmodel)
+			headnode = solid->headnode;
+		else
+			headnode = CM_HeadnodeForBox (solid->mins, solid->maxs);
+
 		if (tr->allsolid)
 			return;
 
 		trace = CM_TransformedBoxTrace (start, end,
 										mins, maxs, headnode, MASK_PLAYERSOLID,
-										ent->origin, angles);
+										solid->ent->origin, solid->angles);
 
 		if (trace.allsolid || trace.startsolid ||
 				trace.fraction < tr->fraction)
 		{
-			trace.ent = (struct edict_s *) ent;
+			trace.ent = (struct edict_s *) solid->ent;
 
 			if (tr->startsolid)
 			{
@@ -171,38 +278,61 @@ trace_t CL_PMTrace (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end)
 int CL_PMpointcontents (vec3_t point)
 {
 	int			i;
-	entity_state_t	*ent;
-	int			num;
-	cmodel_t		*cmodel;
+	clsolid_t	*solid;
 	int			contents;
 
 	contents = CM_PointContents (point, 0);
 
-	for (i = 0; i < cl.frame.num_entities; i++)
+	for (i = 0, solid = cl_solids; i < cl_numsolids; i++, solid++)
 	{
-		num = (cl.frame.parse_entities + i) & (MAX_PARSE_ENTITIES - 1);
-		ent = &cl_parse_entities[num];
-
-		if (ent->solid != 31) // special value for bmodel
+		if (!solid->bmodel)
 			continue;
 
-		cmodel = cl.model_clip[ent->modelindex];
-
-		if (!cmodel)
+		if (point[0] < solid->absmin[0] || point[1] < solid->absmin[1] || point[2] < solid->absmin[2]
+			|| point[0] > solid->absmax[0] || point[1] > solid->absmax[1] || point[2] > solid->absmax[2])
 			continue;
 
-		contents |= CM_TransformedPointContents (point, cmodel->headnode, ent->origin, ent->angles);
+		contents |= CM_TransformedPointContents (point, solid->headnode, solid->ent->origin, solid->ent->angles);
 	}
 
 	return contents;
 }
 
 
+/*
+=================
+CL_PredictCached
+
+Returns the cached result of predicting cmd from pm->s, if there is one.
+Each command is normally replayed every rendered frame until the server
+acknowledges it, but its result only changes when a new server frame
+arrives or the command itself is still being built.
+=================
+*/
+static predcache_t *CL_PredictCached (pmove_t *pm, int sequence)
+{
+	predcache_t	*pc = &cl.predcache[sequence & (CMD_BACKUP - 1)];
+
+	if (pc->sequence != sequence || pc->solidlist != cl_solidlist)
+		return NULL;
+	if (pc->airaccelerate != pm_airaccelerate)
+		return NULL;
+	if (memcmp (&pc->cmd, &pm->cmd, sizeof (pc->cmd)))
+		return NULL;
+	if (memcmp (&pc->in, &pm->s, sizeof (pc->in)))
+		return NULL;
+
+	return pc;
+}
+
 /*
 =================
 CL_PredictMovement
 
 Sets cl.predicted_origin and cl.predicted_angles
+
+cl_predictcache 0 replays every unacknowledged command each frame,
+2 does so and also reports any command the cache got wrong
 =================
 */
 void CL_PredictMovement (void)
@@ -214,6 +344,9 @@ void CL_PredictMovement (void)
 	int			i;
 	int			step;
 	vec3_t		tmp;
+	predcache_t	*pc;
+	pmove_state_t	in;
+	int			numcmds, numpmoves;
 
 	if (cls.state != ca_active)
 		return;
@@ -254,6 +387,7 @@ void CL_PredictMovement (void)
 	//	SCR_DebugGraph (current - ack - 1, 0);
 
 	frame = 0;
+	numcmds = numpmoves = 0;
 
 	// run frames
 	while (++ack <= current)
@@ -268,12 +402,41 @@ void CL_PredictMovement (void)
 		}
 
 		pm.cmd = *cmd;
-		Pmove (&pm);
+		numcmds++;
+
+		pc = CL_PredictCached (&pm, ack);
+
+		if (pc && cl_predictcache->value == 1)
+		{
+			pm.s = pc->out;
+			VectorCopy (pc->viewangles, pm.viewangles);
+		}
+		else
+		{
+			in = pm.s;
+			Pmove (&pm);
+			numpmoves++;
+
+			if (pc && cl_predictcache->value == 2 && (memcmp (&pc->out, &pm.s, sizeof (pm.s)) || !VectorCompare (pc->viewangles, pm.viewangles)))
+				Com_Printf ("prediction cache miss on %i\n", ack);
+
+			pc = &cl.predcache[frame];
+			pc->sequence = ack;
+			pc->solidlist = cl_solidlist;
+			pc->airaccelerate = pm_airaccelerate;
+			pc->cmd = *cmd;
+			pc->in = in;
+			pc->out = pm.s;
+			VectorCopy (pm.viewangles, pc->viewangles);
+		}
 
 		// save for debug checking
 		VectorCopy (pm.s.origin, cl.predicted_origins[frame]);
 	}
 
+	if (cl_showpredict->value)
+		Com_Printf ("predict: %i pmoves for %i cmds\n", numpmoves, numcmds);
+
 	step = pm.s.origin[2] - (int)(cl.predicted_origin[2] * 8);
 	VectorCopy(pm.s.velocity, tmp);
 
@@ -161,6 +161,14 @@ void SCR_DrawDebugGraph (void)
 		h = (int) v % (int) scr_graphheight->value;
 		RE_Draw_Fill (x + w - 1 - a, y - h, 1,	h, color);
 	}
+
+	// live temp entities of each kind
+	if (scr_netgraph->value && cls.state == ca_active)
+	{
+		float	scale = SCR_GetConsoleScale ();
+
+		DrawStringScaled (0, y - scr_graphheight->value - scale * 10, CL_TEntStats (), scale);
+	}
 }
 
 /*
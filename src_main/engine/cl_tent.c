@@ -42,11 +42,6 @@ typedef struct
 
 
 
-#define	MAX_EXPLOSIONS	256
-explosion_t	cl_explosions[MAX_EXPLOSIONS];
-
-
-#define	MAX_BEAMS	256
 typedef struct
 {
 	int		entity;
@@ -56,23 +51,142 @@ typedef struct
 	vec3_t	offset;
 	vec3_t	start, end;
 } beam_t;
-beam_t		cl_beams[MAX_BEAMS];
-//PMM - added this for player-linked beams. Currently only used by the plasma beam
-beam_t		cl_playerbeams[MAX_BEAMS];
 
-
-#define	MAX_LASERS	256
 typedef struct
 {
 	entity_t	ent;
 	int			endtime;
 } laser_t;
-laser_t		cl_lasers[MAX_LASERS];
 
+
+/*
+==============================================================================
+
+TEMP ENTITY POOLS
+
+Each kind of temp entity has a pool of its own with the live ones packed
+at the front.  A new one goes in the slot after the last, and one that
+runs out is replaced by the last live one, so nothing ever scans dead
+slots.  A pool starts out at the old fixed size and doubles whenever it
+fills up, to TENT_POOL_LIMIT; past that a new explosion replaces the
+oldest one and anything else is dropped.  netgraph shows how many of
+each are live and how many were dropped since the level started.
+
+==============================================================================
+*/
+
+#define	TENT_POOL_START		256
+#define	TENT_POOL_LIMIT		4096
+
+typedef struct
+{
+	char	*name;
+	int		size;			// bytes per item
+	byte	*items;
+	int		count;			// live items, packed at the front
+	int		max;			// items allocated
+	int		dropped;		// allocations refused at the limit
+} tentpool_t;
+
+static tentpool_t	cl_explosions = {"ex", sizeof (explosion_t)};
+static tentpool_t	cl_beams = {"beam", sizeof (beam_t)};
+//PMM - added this for player-linked beams. Currently only used by the plasma beam
+static tentpool_t	cl_playerbeams = {"pbeam", sizeof (beam_t)};
+static tentpool_t	cl_lasers = {"laser", sizeof (laser_t)};
 //ROGUE
-cl_sustain_t	cl_sustains[MAX_SUSTAINS];
+static tentpool_t	cl_sustains = {"sus", sizeof (cl_sustain_t)};
 //ROGUE
 
+static tentpool_t	*cl_tentpools[] = {&cl_explosions, &cl_beams, &cl_playerbeams, &cl_lasers, &cl_sustains};
+
+#define	NUM_TENT_POOLS	(sizeof (cl_tentpools) / sizeof (cl_tentpools[0]))
+
+/*
+=================
+CL_TEntAlloc
+
+Returns a cleared slot at the end of the pool, or NULL if it is full
+=================
+*/
+static void *CL_TEntAlloc (tentpool_t *pool)
+{
+	byte	*item;
+
+	if (pool->count == pool->max)
+	{
+		byte	*items;
+		int		max;
+
+		if (pool->max >= TENT_POOL_LIMIT)
+		{
+			pool->dropped++;
+			return NULL;
+		}
+
+		max = pool->max ? pool->max * 2 : TENT_POOL_START;
+		items = Z_Malloc (max * pool->size);
+
+		if (pool->items)
+		{
+			memcpy (items, pool->items, pool->count * pool->size);
+			Z_Free (pool->items);
+		}
+
+		pool->items = items;
+		pool->max = max;
+	}
+
+	item = pool->items + pool->count * pool->size;
+	pool->count++;
+
+	memset (item, 0, pool->size);
+	return item;
+}
+
+/*
+=================
+CL_TEntFree
+
+Moves the last live item into the freed slot
+=================
+*/
+static void CL_TEntFree (tentpool_t *pool, int index)
+{
+	pool->count--;
+
+	if (index != pool->count)
+		memcpy (pool->items + index * pool->size, pool->items + pool->count * pool->size, pool->size);
+}
+
+/*
+=================
+CL_TEntStats
+
+Live and dropped counts of every pool, for the netgraph
+=================
+*/
+char *CL_TEntStats (void)
+{
+	static char	str[256];
+	int			i, len;
+
+	str[0] = 0;
+
+	for (i = 0, len = 0; i < NUM_TENT_POOLS; i++)
+	{
+		Com_sprintf (str + len, sizeof (str) - len, "%s%s %i", i ? "  " : "", cl_tentpools[i]->name, cl_tentpools[i]->count);
+		len = strlen (str);
+
+		if (cl_tentpools[i]->dropped)
+		{
+			Com_sprintf (str + len, sizeof (str) - len, " (-%i)", cl_tentpools[i]->dropped);
+			len = strlen (str);
+		}
+	}
+
+	return str;
+}
+
 //PGM
 extern void CL_TeleportParticles (vec3_t org);
 //PGM
@@ -205,14 +319,14 @@ CL_ClearTEnts
 */
 void CL_ClearTEnts (void)
 {
-	memset (cl_beams, 0, sizeof (cl_beams));
-	memset (cl_explosions, 0, sizeof (cl_explosions));
-	memset (cl_lasers, 0, sizeof (cl_lasers));
+	int		i;
 
-	//ROGUE
-	memset (cl_playerbeams, 0, sizeof (cl_playerbeams));
-	memset (cl_sustains, 0, sizeof (cl_sustains));
-	//ROGUE
+	// the pools keep their memory for the next level
+	for (i = 0; i < NUM_TENT_POOLS; i++)
+	{
+		cl_tentpools[i]->count = 0;
+		cl_tentpools[i]->dropped = 0;
+	}
 }
 
 /*
@@ -222,32 +336,28 @@ CL_AllocExplosion
 */
 explosion_t *CL_AllocExplosion (void)
 {
+	explosion_t	*ex;
 	int		i;
 	int		time;
 	int		index;
 
-	for (i = 0; i < MAX_EXPLOSIONS; i++)
-	{
-		if (cl_explosions[i].type == ex_free)
-		{
-			memset (&cl_explosions[i], 0, sizeof (cl_explosions[i]));
-			return &cl_explosions[i];
-		}
-	}
+	if ((ex = CL_TEntAlloc (&cl_explosions)) != NULL)
+		return ex;
 
 	// find the oldest explosion
+	ex = (explosion_t *) cl_explosions.items;
 	time = cl.time;
 	index = 0;
 
-	for (i = 0; i < MAX_EXPLOSIONS; i++)
-		if (cl_explosions[i].start < time)
+	for (i = 0; i < cl_explosions.count; i++)
+		if (ex[i].start < time)
 		{
-			time = cl_explosions[i].start;
+			time = ex[i].start;
 			index = i;
 		}
 
-	memset (&cl_explosions[index], 0, sizeof (cl_explosions[index]));
-	return &cl_explosions[index];
+	memset (&ex[index], 0, sizeof (ex[index]));
+	return &ex[index];
 }
 
 /*
@@ -314,7 +424,7 @@ int CL_ParseBeam (struct model_s *model)
 	MSG_ReadPos (&net_message, end);
 
 	// override any beam with the same entity
-	for (i = 0, b = cl_beams; i < MAX_BEAMS; i++, b++)
+	for (i = 0, b = (beam_t *) cl_beams.items; i < cl_beams.count; i++, b++)
 		if (b->entity == ent)
 		{
 			b->entity = ent;
@@ -327,18 +437,15 @@ int CL_ParseBeam (struct model_s *model)
 		}
 
 	// find a free beam
-	for (i = 0, b = cl_beams; i < MAX_BEAMS; i++, b++)
+	if ((b = CL_TEntAlloc (&cl_beams)) != NULL)
 	{
-		if (!b->model || b->endtime < cl.time)
-		{
-			b->entity = ent;
-			b->model = model;
-			b->endtime = cl.time + 200;
-			VectorCopy (start, b->start);
-			VectorCopy (end, b->end);
-			VectorClear (b->offset);
-			return ent;
-		}
+		b->entity = ent;
+		b->model = model;
+		b->endtime = cl.time + 200;
+		VectorCopy (start, b->start);
+		VectorCopy (end, b->end);
+		VectorClear (b->offset);
+		return ent;
 	}
 
 	Com_Printf ("beam list overflow!\n");
@@ -367,7 +474,7 @@ int CL_ParseBeam2 (struct model_s *model)
 
 	// override any beam with the same entity
 
-	for (i = 0, b = cl_beams; i < MAX_BEAMS; i++, b++)
+	for (i = 0, b = (beam_t *) cl_beams.items; i < cl_beams.count; i++, b++)
 		if (b->entity == ent)
 		{
 			b->entity = ent;
@@ -380,18 +487,15 @@ int CL_ParseBeam2 (struct model_s *model)
 		}
 
 	// find a free beam
-	for (i = 0, b = cl_beams; i < MAX_BEAMS; i++, b++)
+	if ((b = CL_TEntAlloc (&cl_beams)) != NULL)
 	{
-		if (!b->model || b->endtime < cl.time)
-		{
-			b->entity = ent;
-			b->model = model;
-			b->endtime = cl.time + 200;
-			VectorCopy (start, b->start);
-			VectorCopy (end, b->end);
-			VectorCopy (offset, b->offset);
-			return ent;
-		}
+		b->entity = ent;
+		b->model = model;
+		b->endtime = cl.time + 200;
+		VectorCopy (start, b->start);
+		VectorCopy (end, b->end);
+		VectorCopy (offset, b->offset);
+		return ent;
 	}
 
 	Com_Printf ("beam list overflow!\n");
@@ -432,7 +536,7 @@ int CL_ParsePlayerBeam (struct model_s *model)
 
 	// override any beam with the same entity
 	// PMM - For player beams, we only want one per player (entity) so..
-	for (i = 0, b = cl_playerbeams; i < MAX_BEAMS; i++, b++)
+	for (i = 0, b = (beam_t *) cl_playerbeams.items; i < cl_playerbeams.count; i++, b++)
 	{
 		if (b->entity == ent)
 		{
@@ -447,18 +551,15 @@ int CL_ParsePlayerBeam (struct model_s *model)
 	}
 
 	// find a free beam
-	for (i = 0, b = cl_playerbeams; i < MAX_BEAMS; i++, b++)
+	if ((b = CL_TEntAlloc (&cl_playerbeams)) != NULL)
 	{
-		if (!b->model || b->endtime < cl.time)
-		{
-			b->entity = ent;
-			b->model = model;
-			b->endtime = cl.time + 100;		// PMM - this needs to be 100 to prevent multiple heatbeams
-			VectorCopy (start, b->start);
-			VectorCopy (end, b->end);
-			VectorCopy (offset, b->offset);
-			return ent;
-		}
+		b->entity = ent;
+		b->model = model;
+		b->endtime = cl.time + 100;		// PMM - this needs to be 100 to prevent multiple heatbeams
+		VectorCopy (start, b->start);
+		VectorCopy (end, b->end);
+		VectorCopy (offset, b->offset);
+		return ent;
 	}
 
 	Com_Printf ("beam list overflow!\n");
@@ -485,7 +586,7 @@ int CL_ParseLightning (struct model_s *model)
 	MSG_ReadPos (&net_message, end);
 
 	// override any beam with the same source AND destination entities
-	for (i = 0, b = cl_beams; i < MAX_BEAMS; i++, b++)
+	for (i = 0, b = (beam_t *) cl_beams.items; i < cl_beams.count; i++, b++)
 		if (b->entity == srcEnt && b->dest_entity == destEnt)
 		{
 			//			Com_Printf("%d: OVERRIDE %d -> %d\n", cl.time, srcEnt, destEnt);
@@ -500,20 +601,17 @@ int CL_ParseLightning (struct model_s *model)
 		}
 
 	// find a free beam
-	for (i = 0, b = cl_beams; i < MAX_BEAMS; i++, b++)
+	if ((b = CL_TEntAlloc (&cl_beams)) != NULL)
 	{
-		if (!b->model || b->endtime < cl.time)
-		{
-			//			Com_Printf("%d: NORMAL %d -> %d\n", cl.time, srcEnt, destEnt);
-			b->entity = srcEnt;
-			b->dest_entity = destEnt;
-			b->model = model;
-			b->endtime = cl.time + 200;
-			VectorCopy (start, b->start);
-			VectorCopy (end, b->end);
-			VectorClear (b->offset);
-			return srcEnt;
-		}
+		//			Com_Printf("%d: NORMAL %d -> %d\n", cl.time, srcEnt, destEnt);
+		b->entity = srcEnt;
+		b->dest_entity = destEnt;
+		b->model = model;
+		b->endtime = cl.time + 200;
+		VectorCopy (start, b->start);
+		VectorCopy (end, b->end);
+		VectorClear (b->offset);
+		return srcEnt;
 	}
 
 	Com_Printf ("beam list overflow!\n");
@@ -530,25 +628,20 @@ void CL_ParseLaser (int colors)
 	vec3_t	start;
 	vec3_t	end;
 	laser_t	*l;
-	int		i;
 
 	MSG_ReadPos (&net_message, start);
 	MSG_ReadPos (&net_message, end);
 
-	for (i = 0, l = cl_lasers; i < MAX_LASERS; i++, l++)
+	if ((l = CL_TEntAlloc (&cl_lasers)) != NULL)
 	{
-		if (l->endtime < cl.time)
-		{
-			l->ent.flags = RF_TRANSLUCENT | RF_BEAM;
-			VectorCopy (start, l->ent.currorigin);
-			VectorCopy (end, l->ent.lastorigin);
-			l->ent.alpha = 0.30;
-			l->ent.skinnum = (colors >> ((rand () % 4) * 8)) & 0xff;
-			l->ent.model = NULL;
-			l->ent.currframe = 4;
-			l->endtime = cl.time + 100;
-			return;
-		}
+		l->ent.flags = RF_TRANSLUCENT | RF_BEAM;
+		VectorCopy (start, l->ent.currorigin);
+		VectorCopy (end, l->ent.lastorigin);
+		l->ent.alpha = 0.30;
+		l->ent.skinnum = (colors >> ((rand () % 4) * 8)) & 0xff;
+		l->ent.model = NULL;
+		l->ent.currframe = 4;
+		l->endtime = cl.time + 100;
 	}
 }
 
@@ -557,30 +650,19 @@ void CL_ParseLaser (int colors)
 void CL_ParseSteam (void)
 {
 	vec3_t	pos, dir;
-	int		id, i;
+	int		id;
 	int		r;
 	int		cnt;
 	int		color;
 	int		magnitude;
-	cl_sustain_t	*s, *free_sustain;
+	cl_sustain_t	*s;
 
 	id = MSG_ReadShort (&net_message);		// an id of -1 is an instant effect
 
 	if (id != -1) // sustains
 	{
 		//			Com_Printf ("Sustain effect id %d\n", id);
-		free_sustain = NULL;
-
-		for (i = 0, s = cl_sustains; i < MAX_SUSTAINS; i++, s++)
-		{
-			if (s->id == 0)
-			{
-				free_sustain = s;
-				break;
-			}
-		}
-
-		if (free_sustain)
+		if ((s = CL_TEntAlloc (&cl_sustains)) != NULL)
 		{
 			s->id = id;
 			s->count = MSG_ReadByte (&net_message);
@@ -622,23 +704,12 @@ void CL_ParseSteam (void)
 void CL_ParseWidow (void)
 {
 	vec3_t	pos;
-	int		id, i;
-	cl_sustain_t	*s, *free_sustain;
+	int		id;
+	cl_sustain_t	*s;
 
 	id = MSG_ReadShort (&net_message);
 
-	free_sustain = NULL;
-
-	for (i = 0, s = cl_sustains; i < MAX_SUSTAINS; i++, s++)
-	{
-		if (s->id == 0)
-		{
-			free_sustain = s;
-			break;
-		}
-	}
-
-	if (free_sustain)
+	if ((s = CL_TEntAlloc (&cl_sustains)) != NULL)
 	{
 		s->id = id;
 		MSG_ReadPos (&net_message, s->org);
@@ -657,21 +728,9 @@ void CL_ParseWidow (void)
 void CL_ParseNuke (void)
 {
 	vec3_t	pos;
-	int		i;
-	cl_sustain_t	*s, *free_sustain;
-
-	free_sustain = NULL;
-
-	for (i = 0, s = cl_sustains; i < MAX_SUSTAINS; i++, s++)
-	{
-		if (s->id == 0)
-		{
-			free_sustain = s;
-			break;
-		}
-	}
+	cl_sustain_t	*s;
 
-	if (free_sustain)
+	if ((s = CL_TEntAlloc (&cl_sustains)) != NULL)
 	{
 		s->id = 21000;
 		MSG_ReadPos (&net_message, s->org);
@@ -1283,10 +1342,16 @@ void CL_AddBeams (void)
 	float		model_length;
 
 	// update beams
-	for (i = 0, b = cl_beams; i < MAX_BEAMS; i++, b++)
+	for (i = 0; i < cl_beams.count; i++)
 	{
+		b = (beam_t *) cl_beams.items + i;
+
 		if (!b->model || b->endtime < cl.time)
+		{
+			// the last beam moves in here, so look at this slot again
+			CL_TEntFree (&cl_beams, i--);
 			continue;
+		}
 
 		// if coming from the player, update the start position
 		if (b->entity == cl.playernum + 1)	// entity 0 is the world
@@ -1454,12 +1519,17 @@ void CL_AddPlayerBeams (void)
 	//PMM
 
 	// update beams
-	for (i = 0, b = cl_playerbeams; i < MAX_BEAMS; i++, b++)
+	for (i = 0; i < cl_playerbeams.count; i++)
 	{
 		vec3_t		f, r, u;
 
+		b = (beam_t *) cl_playerbeams.items + i;
+
 		if (!b->model || b->endtime < cl.time)
+		{
+			CL_TEntFree (&cl_playerbeams, i--);
 			continue;
+		}
 
 		if (cl_mod_heatbeam && (b->model == cl_mod_heatbeam))
 		{
@@ -1700,10 +1770,9 @@ void CL_AddExplosions (void)
 
 	memset (&ent, 0, sizeof (ent));
 
-	for (i = 0, ex = cl_explosions; i < MAX_EXPLOSIONS; i++, ex++)
+	for (i = 0; i < cl_explosions.count; i++)
 	{
-		if (ex->type == ex_free)
-			continue;
+		ex = (explosion_t *) cl_explosions.items + i;
 
 		frac = (cl.time - ex->start) / 100.0;
 		f = floor (frac);
@@ -1781,7 +1850,10 @@ void CL_AddExplosions (void)
 		}
 
 		if (ex->type == ex_free)
+		{
+			CL_TEntFree (&cl_explosions, i--);
 			continue;
+		}
 
 		if (ex->light)
 		{
@@ -1813,10 +1885,17 @@ void CL_AddLasers (void)
 	laser_t		*l;
 	int			i;
 
-	for (i = 0, l = cl_lasers; i < MAX_LASERS; i++, l++)
+	for (i = 0; i < cl_lasers.count; i++)
 	{
-		if (l->endtime >= cl.time)
-			V_AddEntity (&l->ent);
+		l = (laser_t *) cl_lasers.items + i;
+
+		if (l->endtime < cl.time)
+		{
+			CL_TEntFree (&cl_lasers, i--);
+			continue;
+		}
+
+		V_AddEntity (&l->ent);
 	}
 }
 
@@ -1826,15 +1905,18 @@ void CL_ProcessSustain ()
 	cl_sustain_t	*s;
 	int				i;
 
-	for (i = 0, s = cl_sustains; i < MAX_SUSTAINS; i++, s++)
+	for (i = 0; i < cl_sustains.count; i++)
 	{
-		if (s->id)
-			if ((s->endtime >= cl.time) && (cl.time >= s->nextthink))
-			{
-				s->think (s);
-			}
-			else if (s->endtime < cl.time)
-				s->id = 0;
+		s = (cl_sustain_t *) cl_sustains.items + i;
+
+		if (s->endtime < cl.time)
+		{
+			CL_TEntFree (&cl_sustains, i--);
+			continue;
+		}
+
+		if (cl.time >= s->nextthink)
+			s->think (s);
 	}
 }
 
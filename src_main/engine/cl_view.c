@@ -39,6 +39,8 @@ cvar_t		*cl_testblend;
 
 cvar_t		*cl_stats;
 
+static cvar_t	*v_dynamic;		// the refresh's gl_dynamic, cached for V_AddLight
+
 
 int			r_numdlights;
 dlight_t	r_dlights[MAX_DLIGHTS];
@@ -122,6 +124,25 @@ void V_AddParticle(vec3_t org, int color, float alpha)
 	p->alpha = alpha;
 }
 
+/*
+=====================
+V_ReserveParticles
+
+Claims up to count particles at the end of the list for the caller to
+fill in, and returns how many fit
+=====================
+*/
+int V_ReserveParticles (particle_t **out, int count)
+{
+	if (count > MAX_PARTICLES - r_numparticles)
+		count = MAX_PARTICLES - r_numparticles;
+
+	*out = &r_particles[r_numparticles];
+	r_numparticles += count;
+
+	return count;
+}
+
 
 /*
 =====================
@@ -138,7 +159,7 @@ void V_AddLight (vec3_t org, float intensity, float r, float g, float b)
 
 	dl = &r_dlights[r_numdlights++];
 	VectorCopy (org, dl->origin);
-	dl->intensity = intensity * Cvar_VariableValue("gl_dynamic");
+	dl->intensity = intensity * v_dynamic->value;
 
 	dl->color[0] = r * scaler;
 	dl->color[1] = g * scaler;
@@ -278,6 +299,9 @@ void CL_PrepRefresh (void)
 	if (!cl.configstrings[CS_MODELS+1][0])
 		return;		// no map loaded
 
+	// everything gets registered here anyway
+	CL_ClearConfigStringQueue ();
+
 	// let the render dll load the map
 	strcpy (mapname, cl.configstrings[CS_MODELS+1] + 5);	// skip "maps/"
 	mapname[strlen (mapname)-4] = 0;		// cut off ".bsp"
@@ -318,6 +342,9 @@ void CL_PrepRefresh (void)
 		}
 	}
 
+	// the inline models may not have been there when the frame was parsed
+	CL_BuildSolidList ();
+
 	for (i = 1; i < MAX_IMAGES && cl.configstrings[CS_IMAGES+i][0]; i++)
 	{
 		cl.image_precache[i] = RE_Draw_RegisterPic (cl.configstrings[CS_IMAGES+i]);
@@ -475,22 +502,116 @@ void SCR_DrawCrosshair (void)
 
 /*
 ==================
-V_RenderView
+V_SortEntities
+
+Groups the entities by model then skin for better cache locality.  Every
+distinct model and skin pointer gets a small id in the order it is first
+seen, and the entities are radix sorted on the two ids, which keeps equal
+models together without comparing pointers and leaves the order stable.
 ==================
 */
-static int entitycmpfnc(const entity_t *a, const entity_t *b)
+#define	SORT_HASH_SIZE		(MAX_ENTITIES * 4)	// must be a power of two
+
+static entity_t	r_sortedentities[MAX_ENTITIES];
+
+static void V_SortEntities (void)
 {
-	// all other models are sorted by model then skin
-	if (a->model == b->model)
+	static void			*hashptr[SORT_HASH_SIZE];
+	static unsigned short	hashid[SORT_HASH_SIZE];
+	static unsigned short	hashframe[SORT_HASH_SIZE];
+	static unsigned short	sortframe;
+	static unsigned int	keys[MAX_ENTITIES];
+	static unsigned short	order[2][MAX_ENTITIES];
+	int			count[256];
+	int			i, j, n, pass, shift, numids;
+	unsigned int	h;
+	void		*ptr;
+	unsigned short	*in, *out;
+
+	n = r_numentities;
+
+	if (n < 2)
+		return;
+
+	// a new frame number invalidates the whole table at once
+	if (!++sortframe)
 	{
-		return ((int)a->skin - (int)b->skin);
+		memset (hashframe, 0, sizeof (hashframe));
+		sortframe = 1;
 	}
-	else
+
+	numids = 0;
+
+	for (i = 0; i < n; i++)
 	{
-		return ((int)a->model - (int)b->model);
+		keys[i] = 0;
+
+		for (j = 0; j < 2; j++)
+		{
+			ptr = j ? (void *) r_entities[i].skin : (void *) r_entities[i].model;
+			h = ((unsigned int) ((size_t) ptr >> 4) * 2654435761u) & (SORT_HASH_SIZE - 1);
+
+			while (hashframe[h] == sortframe && hashptr[h] != ptr)
+				h = (h + 1) & (SORT_HASH_SIZE - 1);
+
+			if (hashframe[h] != sortframe)
+			{
+				hashframe[h] = sortframe;
+				hashptr[h] = ptr;
+				hashid[h] = numids++;
+			}
+
+			// model in the high half, skin in the low
+			keys[i] |= hashid[h] << (j ? 0 : 16);
+		}
+
+		order[0][i] = i;
+	}
+
+	// ids stay below 2 * MAX_ENTITIES, so the high digit of each half is
+	// usually zero and its pass can be skipped
+	in = order[0];
+	out = order[1];
+
+	for (pass = 0; pass < 4; pass++)
+	{
+		shift = (pass & 1) * 8 + (pass & 2) * 8;
+
+		// skip digits that are the same for every entity
+		if (!(numids >> (shift & 15)))
+			continue;
+
+		memset (count, 0, sizeof (count));
+
+		for (i = 0; i < n; i++)
+			count[(keys[in[i]] >> shift) & 255]++;
+
+		for (i = 0, j = 0; i < 256; i++)
+		{
+			int		c = count[i];
+
+			count[i] = j;
+			j += c;
+		}
+
+		for (i = 0; i < n; i++)
+			out[count[(keys[in[i]] >> shift) & 255]++] = in[i];
+
+		in = out;
+		out = (in == order[0]) ? order[1] : order[0];
 	}
+
+	for (i = 0; i < n; i++)
+		r_sortedentities[i] = r_entities[in[i]];
+
+	cl.refdef.entities = r_sortedentities;
 }
 
+/*
+==================
+V_RenderView
+==================
+*/
 void V_RenderView (float stereo_separation)
 {
 	if (cls.state != ca_active)
@@ -591,7 +712,7 @@ void V_RenderView (float stereo_separation)
 			cl.refdef.rdflags |= RDF_FOVADAPT;
 
 		// sort entities for better cache locality
-		qsort (cl.refdef.entities, cl.refdef.num_entities, sizeof (cl.refdef.entities[0]), (int (*) (const void *, const void *)) entitycmpfnc);
+		V_SortEntities ();
 	}
 
 	RE_RenderFrame (&cl.refdef);
@@ -638,4 +759,6 @@ void V_Init (void)
 	cl_testlights = Cvar_Get ("cl_testlights", "0", 0);
 
 	cl_stats = Cvar_Get ("cl_stats", "0", 0);
+
+	v_dynamic = Cvar_Get ("gl_dynamic", "1", 0);
 }
@@ -84,6 +84,21 @@ extern int num_cl_weaponmodels;
 
 #define	CMD_BACKUP		64	// allow a lot of command backups for very fast systems
 
+//
+// the result of predicting one command, reused on later frames as long
+// as the command, the state it started from and the world are unchanged
+//
+typedef struct
+{
+	int				sequence;		// outgoing sequence of the command
+	int				solidlist;		// CL_BuildSolidList generation it was traced against
+	float			airaccelerate;
+	usercmd_t		cmd;
+	pmove_state_t	in;
+	pmove_state_t	out;
+	vec3_t			viewangles;
+} predcache_t;
+
 //
 // the client_state_t structure is wiped completely at every
 // server map change
@@ -105,6 +120,7 @@ typedef struct
 	usercmd_t	cmds[CMD_BACKUP];	// each mesage will send several old cmds
 	int			cmd_time[CMD_BACKUP];	// time sent, for calculating pings
 	short		predicted_origins[CMD_BACKUP][3];	// for debug comparing against server
+	predcache_t	predcache[CMD_BACKUP];
 
 	float		predicted_step;				// for stair up smoothing
 	unsigned	predicted_step_time;
@@ -168,6 +184,11 @@ typedef struct
 
 	clientinfo_t	clientinfo[MAX_CLIENTS];
 	clientinfo_t	baseclientinfo;
+
+	// changed configstrings still waiting to be registered
+	short		csqueue[MAX_CONFIGSTRINGS];
+	int			csqueuehead, csqueuetail;
+	qboolean	csqueued[MAX_CONFIGSTRINGS];
 } client_state_t;
 
 extern	client_state_t	cl;
@@ -230,6 +251,8 @@ typedef struct
 	int			challenge;			// from the server to use for connecting
 
 	qboolean	forcePacket;		// forces a packet to be send at the next frame
+	qboolean	cmdrefreshed;		// the current move has been filled in since the last send
+	int			lastcmdsend;		// Sys_Milliseconds of the last move sent
 
 	FILE		*download;			// file transfer from server
 	char		downloadtempname[MAX_OSPATH];
@@ -264,10 +287,17 @@ extern	cvar_t	*cl_gun;
 extern	cvar_t	*cl_add_blend;
 extern	cvar_t	*cl_add_lights;
 extern	cvar_t	*cl_add_particles;
+extern	cvar_t	*cl_maxparticles;
 extern	cvar_t	*cl_add_entities;
+extern	cvar_t	*cl_cullentities;
 extern	cvar_t	*cl_predict;
+extern	cvar_t	*cl_netthread;
+extern	cvar_t	*cl_maxfps;
+extern	cvar_t	*cl_predictcache;
+extern	cvar_t	*cl_showpredict;
 extern	cvar_t	*cl_footsteps;
 extern	cvar_t	*cl_noskins;
+extern	cvar_t	*cl_loadbudget;
 extern	cvar_t	*cl_autoskins;
 
 extern	cvar_t	*cl_upspeed;
@@ -357,7 +387,6 @@ typedef struct cl_sustain
 	void	(*think) (struct cl_sustain *self);
 } cl_sustain_t;
 
-#define MAX_SUSTAINS		256
 void CL_ParticleSteamEffect2 (cl_sustain_t *self);
 
 void CL_TeleporterParticles (entity_state_t *ent);
@@ -374,8 +403,6 @@ void CL_ParticleEffect3 (vec3_t org, vec3_t dir, int color, int count);
 // PGM
 typedef struct particle_s
 {
-	struct particle_s	*next;
-
 	float		time;
 
 	vec3_t		org;
@@ -388,6 +415,8 @@ typedef struct particle_s
 } cparticle_t;
 
 
+cparticle_t *CL_AllocParticle (void);
+
 #define	PARTICLE_GRAVITY	40
 #define BLASTER_PARTICLE_COLOR		0xe0
 // PMM
@@ -397,6 +426,7 @@ typedef struct particle_s
 
 void CL_ClearEffects (void);
 void CL_ClearTEnts (void);
+char *CL_TEntStats (void);
 void CL_BlasterTrail (vec3_t start, vec3_t end, float color);
 void CL_QuadTrail (vec3_t start, vec3_t end);
 void CL_RailTrail (vec3_t start, vec3_t end);
@@ -466,6 +496,9 @@ void CL_Init (void);
 
 void CL_FixUpGender (void);
 void CL_Disconnect (void);
+void CL_NetLock (void);
+void CL_NetUnlock (void);
+void CL_StopNetThread (void);
 void CL_Disconnect_f (void);
 void CL_PingServers_f (void);
 void CL_Snd_Restart_f (void);
@@ -519,6 +552,8 @@ void CL_ParseServerMessage (void);
 void CL_LoadClientinfo (clientinfo_t *ci, char *s);
 void SHOWNET (char *s);
 void CL_ParseClientinfo (int player);
+void CL_ProcessConfigStrings (void);
+void CL_ClearConfigStringQueue (void);
 void CL_Download_f (void);
 
 //
@@ -531,8 +566,11 @@ void V_Init (void);
 void V_RenderView (float stereo_separation);
 void V_AddEntity (entity_t *ent);
 void V_AddParticle (vec3_t org, int color, float alpha);
+int V_ReserveParticles (particle_t **out, int count);
 void V_AddLight (vec3_t org, float intensity, float r, float g, float b);
 void V_AddLightStyle (int style, float r, float g, float b);
+float SCR_CalcFovX (float fov_y, float width, float height);
+float SCR_CalcFovY (float fov_x, float width, float height);
 
 //
 // cl_tent.c
@@ -545,8 +583,17 @@ void CL_RegisterTEntModels (void);
 // cl_pred.c
 //
 void CL_PredictMovement(void);
+void CL_BuildSolidList (void);
 void CL_CheckPredictionError (void);
 
+//
+// cl_bench.c
+//
+void Bench_Init (void);
+qboolean Bench_Running (void);
+void Bench_Frame (unsigned int client, unsigned int parse, unsigned int render, unsigned int sound);
+void Bench_DemoFinished (void);
+
 //
 // cl_fx.c
 //
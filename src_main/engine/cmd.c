@@ -40,6 +40,128 @@ qboolean	cmd_wait;
 int		alias_count;		// for detecting runaway loops
 
 
+/*
+=============================================================================
+
+						SYMBOL TABLE
+
+Commands, aliases and cvars share one hashed name table so that a command
+line is resolved without walking every list.  The owners keep their own
+linked lists for ordered listing and completion.
+
+=============================================================================
+*/
+
+#define	SYMBOL_HASH_SIZE	1024
+
+typedef struct cmdsymbol_s
+{
+	struct cmdsymbol_s	*hashnext;
+	char				*name;
+	symboltype_t		type;
+	void				*data;
+} cmdsymbol_t;
+
+static cmdsymbol_t	*cmd_symbols[SYMBOL_HASH_SIZE];
+
+/*
+============
+Cmd_SymbolMatch
+
+Commands and aliases are matched case insensitively, cvars exactly
+============
+*/
+static qboolean Cmd_SymbolMatch (cmdsymbol_t *sym, char *name)
+{
+	if (sym->type == SYMBOL_CVAR)
+		return !strcmp (name, sym->name);
+
+	return !Q_strcasecmp (name, sym->name);
+}
+
+/*
+============
+Cmd_AddSymbol
+
+name must stay valid for as long as the symbol is registered
+============
+*/
+void Cmd_AddSymbol (char *name, symboltype_t type, void *data)
+{
+	cmdsymbol_t	*sym;
+	unsigned	hash = Com_HashKey (name, SYMBOL_HASH_SIZE);
+
+	sym = Z_Malloc (sizeof (cmdsymbol_t));
+	sym->name = name;
+	sym->type = type;
+	sym->data = data;
+	sym->hashnext = cmd_symbols[hash];
+	cmd_symbols[hash] = sym;
+}
+
+/*
+============
+Cmd_RemoveSymbol
+============
+*/
+void Cmd_RemoveSymbol (char *name, void *data)
+{
+	cmdsymbol_t	*sym, **back;
+
+	for (back = &cmd_symbols[Com_HashKey (name, SYMBOL_HASH_SIZE)]; (sym = *back) != NULL; back = &sym->hashnext)
+	{
+		if (sym->data == data)
+		{
+			*back = sym->hashnext;
+			Z_Free (sym);
+			return;
+		}
+	}
+}
+
+/*
+============
+Cmd_FindSymbol
+============
+*/
+void *Cmd_FindSymbol (char *name, symboltype_t type)
+{
+	cmdsymbol_t	*sym;
+
+	for (sym = cmd_symbols[Com_HashKey (name, SYMBOL_HASH_SIZE)]; sym; sym = sym->hashnext)
+	{
+		if (sym->type == type && Cmd_SymbolMatch (sym, name))
+			return sym->data;
+	}
+
+	return NULL;
+}
+
+/*
+============
+Cmd_ResolveSymbol
+
+Returns the symbol a command line would execute: commands take precedence
+over aliases, which take precedence over cvars
+============
+*/
+static cmdsymbol_t *Cmd_ResolveSymbol (char *name)
+{
+	cmdsymbol_t	*sym, *best = NULL;
+
+	for (sym = cmd_symbols[Com_HashKey (name, SYMBOL_HASH_SIZE)]; sym; sym = sym->hashnext)
+	{
+		if (best && best->type <= sym->type)
+			continue;
+
+		if (Cmd_SymbolMatch (sym, name))
+			best = sym;
+	}
+
+	return best;
+}
+
+
 //=============================================================================
 
 /*
@@ -471,23 +593,19 @@ void Cmd_Alias_f (void)
 	}
 
 	// if the alias already exists, reuse it
-	for (a = cmd_alias; a; a = a->next)
+	if ((a = Cmd_FindSymbol (s, SYMBOL_ALIAS)) != NULL)
 	{
-		if (!strcmp (s, a->name))
-		{
-			Z_Free (a->value);
-			break;
-		}
+		Z_Free (a->value);
 	}
-
-	if (!a)
+	else
 	{
 		a = Z_Malloc (sizeof (cmdalias_t));
 		a->next = cmd_alias;
 		cmd_alias = a;
-	}
 
-	strcpy (a->name, s);
+		strcpy (a->name, s);
+		Cmd_AddSymbol (a->name, SYMBOL_ALIAS, a);
+	}
 
 	// copy the rest of the command line
 	cmd[0] = 0;		// start out with a null string
@@ -741,13 +859,10 @@ void Cmd_AddCommand (char *cmd_name, xcommand_t function)
 	}
 
 	// fail if the command already exists
-	for (cmd = cmd_functions; cmd; cmd = cmd->next)
+	if (Cmd_FindSymbol (cmd_name, SYMBOL_COMMAND))
 	{
-		if (!strcmp (cmd_name, cmd->name))
-		{
-			Com_Printf ("Cmd_AddCommand: %s already defined\n", cmd_name);
-			return;
-		}
+		Com_Printf ("Cmd_AddCommand: %s already defined\n", cmd_name);
+		return;
 	}
 
 	cmd = Z_Malloc (sizeof (cmd_function_t));
@@ -755,6 +870,8 @@ void Cmd_AddCommand (char *cmd_name, xcommand_t function)
 	cmd->function = function;
 	cmd->next = cmd_functions;
 	cmd_functions = cmd;
+
+	Cmd_AddSymbol (cmd->name, SYMBOL_COMMAND, cmd);
 }
 
 /*
@@ -781,6 +898,7 @@ void Cmd_RemoveCommand (char *cmd_name)
 		if (!strcmp (cmd_name, cmd->name))
 		{
 			*back = cmd->next;
+			Cmd_RemoveSymbol (cmd->name, cmd);
 			Z_Free (cmd);
 			return;
 		}
@@ -796,15 +914,7 @@ Cmd_Exists
 */
 qboolean	Cmd_Exists (char *cmd_name)
 {
-	cmd_function_t	*cmd;
-
-	for (cmd = cmd_functions; cmd; cmd = cmd->next)
-	{
-		if (!strcmp (cmd_name, cmd->name))
-			return true;
-	}
-
-	return false;
+	return Cmd_FindSymbol (cmd_name, SYMBOL_COMMAND) != NULL;
 }
 
 
@@ -826,13 +936,11 @@ char *Cmd_CompleteCommand (char *partial)
 		return NULL;
 
 	// check for exact match
-	for (cmd = cmd_functions; cmd; cmd = cmd->next)
-		if (!strcmp (partial, cmd->name))
-			return cmd->name;
+	if ((cmd = Cmd_FindSymbol (partial, SYMBOL_COMMAND)) != NULL)
+		return cmd->name;
 
-	for (a = cmd_alias; a; a = a->next)
-		if (!strcmp (partial, a->name))
-			return a->name;
+	if ((a = Cmd_FindSymbol (partial, SYMBOL_ALIAS)) != NULL)
+		return a->name;
 
 	// check for partial match
 	for (cmd = cmd_functions; cmd; cmd = cmd->next)
@@ -854,11 +962,11 @@ qboolean doneWithDefaultCfg;
 Cmd_ExecuteString
 
 A complete command line has been parsed, so try to execute it
-FIXME: lookupnoadd the token to speed search?
 ============
 */
 void	Cmd_ExecuteString (char *text)
 {
+	cmdsymbol_t		*sym;
 	cmd_function_t	*cmd;
 	cmdalias_t		*a;
 
@@ -874,41 +982,41 @@ void	Cmd_ExecuteString (char *text)
 		doneWithDefaultCfg = true;
 	}
 
+	sym = Cmd_ResolveSymbol (cmd_argv[0]);
+
 	// check functions
-	for (cmd = cmd_functions; cmd; cmd = cmd->next)
+	if (sym && sym->type == SYMBOL_COMMAND)
 	{
-		if (!Q_strcasecmp (cmd_argv[0], cmd->name))
-		{
-			if (!cmd->function)
-			{
-				// forward to server command
-				Cmd_ExecuteString (va ("cmd %s", text));
-			}
-			else
-				cmd->function ();
+		cmd = sym->data;
 
-			return;
+		if (!cmd->function)
+		{
+			// forward to server command
+			Cmd_ExecuteString (va ("cmd %s", text));
 		}
+		else
+			cmd->function ();
+
+		return;
 	}
 
 	// check alias
-	for (a = cmd_alias; a; a = a->next)
+	if (sym && sym->type == SYMBOL_ALIAS)
 	{
-		if (!Q_strcasecmp (cmd_argv[0], a->name))
-		{
-			if (++alias_count == ALIAS_LOOP_COUNT)
-			{
-				Com_Printf ("ALIAS_LOOP_COUNT\n");
-				return;
-			}
+		a = sym->data;
 
-			Cbuf_InsertText (a->value);
+		if (++alias_count == ALIAS_LOOP_COUNT)
+		{
+			Com_Printf ("ALIAS_LOOP_COUNT\n");
 			return;
 		}
+
+		Cbuf_InsertText (a->value);
+		return;
 	}
 
 	// check cvars
-	if (Cvar_Command ())
+	if (sym && Cvar_Command ())
 		return;
 
 	// send it as a server command if we are connected
@@ -933,6 +1041,71 @@ void Cmd_List_f (void)
 	Com_Printf ("%i commands\n", i);
 }
 
+/*
+============
+Cmd_Bench_f
+
+Executes a config file repeatedly and reports the time per line
+============
+*/
+void Cmd_Bench_f (void)
+{
+	char	*f, *text, *name;
+	int		len, i, passes, lines;
+	unsigned	start, elapsed;
+
+	name = (Cmd_Argc () > 1) ? Cmd_Argv (1) : "config.cfg";
+	passes = (Cmd_Argc () > 2) ? atoi (Cmd_Argv (2)) : 100;
+
+	if (passes < 1)
+		passes = 1;
+
+	len = FS_LoadFile (name, (void **) &f);
+
+	if (!f)
+	{
+		Com_Printf ("couldn't load %s\n", name);
+		return;
+	}
+
+	if (len >= cmd_text.maxsize - cmd_text.cursize)
+	{
+		Com_Printf ("%s is too large for the command buffer\n", name);
+		FS_FreeFile (f);
+		return;
+	}
+
+	// the file doesn't have a trailing 0, so we need to copy it off
+	text = Z_Malloc (len + 1);
+	memcpy (text, f, len);
+	text[len] = 0;
+	FS_FreeFile (f);
+
+	for (i = 0, lines = 0; i < len; i++)
+	{
+		if (text[i] == '\n' || text[i] == ';')
+			lines++;
+	}
+
+	// run whatever is already queued so it isn't timed
+	Cbuf_Execute ();
+
+	start = Sys_Microseconds ();
+
+	for (i = 0; i < passes; i++)
+	{
+		Cbuf_AddText (text);
+		Cbuf_Execute ();
+	}
+
+	elapsed = Sys_Microseconds () - start;
+
+	Z_Free (text);
+
+	Com_Printf ("%s: %i passes of %i lines in %u usec (%.3f usec/line)\n", name, passes, lines, elapsed,
+		(lines ? (float) elapsed / (float) (passes * lines) : 0.0f));
+}
+
 /*
 ============
 Cmd_Init
@@ -943,6 +1116,7 @@ void Cmd_Init (void)
 	//
 	// register our commands
 	//
+	Cmd_AddCommand ("cmdbench", Cmd_Bench_f);
 	Cmd_AddCommand ("cmdlist", Cmd_List_f);
 	Cmd_AddCommand ("exec", Cmd_Exec_f);
 	Cmd_AddCommand ("echo", Cmd_Echo_f);
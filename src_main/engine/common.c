@@ -28,13 +28,6 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #define MAX_NUM_ARGVS	50
 
-void *Scratch_Alloc (void)
-{
-	// this buffer should never be accessed directly but always via a call to here
-	static char scratchbuf[20 * 1024 * 1024];
-	return scratchbuf;
-}
-
 int		com_argc;
 char	*com_argv[MAX_NUM_ARGVS+1];
 
@@ -50,8 +43,8 @@ cvar_t	*log_stats;
 cvar_t	*developer;
 cvar_t	*timescale;
 cvar_t	*fixedtime;
-cvar_t	*logfile_active;	// 1 = buffer log, 2 = flush after each print
 cvar_t	*showtrace;
+cvar_t	*showcvarlookups;
 cvar_t	*dedicated;
 
 // for timing calculations
@@ -60,7 +53,6 @@ cvar_t	*cl_async;
 cvar_t	*cl_maxfps;
 cvar_t	*r_maxfps;
 
-FILE	*logfile;
 
 int		server_state;
 
@@ -150,26 +142,7 @@ void Com_Printf (char *fmt, ...)
 	Sys_ConsoleOutput (msg);
 
 	// logfile
-	if (logfile_active && logfile_active->value)
-	{
-		char	name[MAX_QPATH];
-
-		if (!logfile)
-		{
-			Com_sprintf (name, sizeof (name), "%s/qconsole.log", FS_Gamedir ());
-
-			if (logfile_active->value > 2)
-				logfile = fopen (name, "a");
-			else
-				logfile = fopen (name, "w");
-		}
-
-		if (logfile)
-			fprintf (logfile, "%s", msg);
-
-		if (logfile_active->value > 1)
-			fflush (logfile);		// force it to save every time
-	}
+	Log_Print (msg);
 }
 
 
@@ -239,11 +212,7 @@ void Com_Error (int code, char *fmt, ...)
 		CL_Shutdown ();
 	}
 
-	if (logfile)
-	{
-		fclose (logfile);
-		logfile = NULL;
-	}
+	Log_Shutdown ();
 
 	Sys_Error ("%s", msg);
 }
@@ -262,11 +231,7 @@ void Com_Quit (void)
 	SV_Shutdown ("Server quit\n", false);
 	CL_Shutdown ();
 
-	if (logfile)
-	{
-		fclose (logfile);
-		logfile = NULL;
-	}
+	Log_Shutdown ();
 
 	Sys_Quit ();
 }
@@ -1275,6 +1240,182 @@ void *Z_Malloc (int size)
 }
 
 
+/*
+==============================================================================
+
+SCRATCH MEMORY
+
+A linear allocator for short-lived temp memory.  Each thread owns its own
+arena; allocations are released by popping back to a previously taken mark,
+and the main thread's arena is rewound at the start of every frame so an
+ERR_DROP can't leak it.
+
+==============================================================================
+*/
+
+#define	SCRATCH_ALIGN	16
+
+typedef struct scratch_s
+{
+	byte	*base;
+	int		size;
+	int		used;
+	int		highwater;
+} scratch_t;
+
+static scratch_t				scratch_main;
+static THREAD_LOCAL scratch_t	*scratch_current;
+
+static void Scratch_Create (scratch_t *scratch, int size)
+{
+	scratch->base = malloc (size);
+	if (!scratch->base)
+		Com_Error (ERR_FATAL, "Scratch_Create: failed on allocation of %i bytes", size);
+
+	scratch->size = size;
+	scratch->used = 0;
+	scratch->highwater = 0;
+}
+
+static scratch_t *Scratch_Get (void)
+{
+	if (!scratch_current)
+		Com_Error (ERR_FATAL, "Scratch: no arena for this thread");
+
+	return scratch_current;
+}
+
+/*
+========================
+Scratch_Mark
+
+Returns a mark that Scratch_Release can later pop back to
+========================
+*/
+int Scratch_Mark (void)
+{
+	return Scratch_Get ()->used;
+}
+
+/*
+========================
+Scratch_Alloc
+========================
+*/
+void *Scratch_Alloc (int size)
+{
+	scratch_t	*scratch = Scratch_Get ();
+	byte		*buf;
+
+	size = (size + SCRATCH_ALIGN - 1) & ~(SCRATCH_ALIGN - 1);
+
+	if (size < 0 || scratch->used + size > scratch->size)
+		Com_Error (ERR_FATAL, "Scratch_Alloc: overflow allocating %i bytes (%i of %i used)", size, scratch->used, scratch->size);
+
+	buf = scratch->base + scratch->used;
+	scratch->used += size;
+
+	if (scratch->used > scratch->highwater)
+		scratch->highwater = scratch->used;
+
+	return buf;
+}
+
+/*
+========================
+Scratch_Release
+
+Pops everything allocated since mark.  Releasing a mark that an outer
+release has already popped is a no-op.
+========================
+*/
+void Scratch_Release (int mark)
+{
+	scratch_t	*scratch = Scratch_Get ();
+
+	if (mark < 0 || mark > scratch->size)
+		Com_Error (ERR_FATAL, "Scratch_Release: bad mark %i", mark);
+
+	if (mark < scratch->used)
+		scratch->used = mark;
+}
+
+/*
+========================
+Scratch_InitThread
+
+Gives a thread a private arena; called first thing from every thread
+entry point and paired with Scratch_ShutdownThread on the way out
+========================
+*/
+void Scratch_InitThread (int size)
+{
+	if (scratch_current)
+		Com_Error (ERR_FATAL, "Scratch_InitThread: thread already has an arena");
+
+	scratch_current = malloc (sizeof (scratch_t));
+	if (!scratch_current)
+		Com_Error (ERR_FATAL, "Scratch_InitThread: out of memory");
+
+	Scratch_Create (scratch_current, size);
+}
+
+/*
+========================
+Scratch_ShutdownThread
+========================
+*/
+void Scratch_ShutdownThread (void)
+{
+	if (!scratch_current || scratch_current == &scratch_main)
+		return;
+
+	free (scratch_current->base);
+	free (scratch_current);
+	scratch_current = NULL;
+}
+
+/*
+========================
+Scratch_BeginFrame
+
+Rewinds the main thread's arena; anything still held here was leaked by
+the previous frame
+========================
+*/
+static void Scratch_BeginFrame (void)
+{
+	if (scratch_main.used)
+	{
+		Com_DPrintf ("Scratch_BeginFrame: %i bytes leaked by last frame\n", scratch_main.used);
+		scratch_main.used = 0;
+	}
+}
+
+/*
+========================
+Scratch_Init
+========================
+*/
+static void Scratch_Init (void)
+{
+	cvar_t	*scratch_size = Cvar_Get ("scratch_size", "20", CVAR_NOSET);
+
+	Scratch_Create (&scratch_main, max (scratch_size->value, 1) * 1024 * 1024);
+	scratch_current = &scratch_main;
+}
+
+/*
+========================
+Scratch_Stats_f
+========================
+*/
+static void Scratch_Stats_f (void)
+{
+	Com_Printf ("%i bytes in use, %i high water, %i size\n", scratch_main.used, scratch_main.highwater, scratch_main.size);
+}
+
+
 //============================================================================
 
 static byte chktbl[1024] =
@@ -1436,6 +1577,8 @@ void Qcommon_Init (int argc, char **argv)
 	Cbuf_AddEarlyCommands (false);
 	Cbuf_Execute ();
 
+	Scratch_Init ();
+
 	FS_InitFilesystem ();
 
 	Cbuf_AddText ("exec default.cfg\n");
@@ -1447,14 +1590,17 @@ void Qcommon_Init (int argc, char **argv)
 
 	// init commands and vars
 	Cmd_AddCommand ("z_stats", Z_Stats_f);
+	Cmd_AddCommand ("scratch_stats", Scratch_Stats_f);
 
 	host_speeds = Cvar_Get ("host_speeds", "0", 0);
 	log_stats = Cvar_Get ("log_stats", "0", 0);
 	developer = Cvar_Get ("developer", "0", 0);
 	timescale = Cvar_Get ("timescale", "1", 0);
 	fixedtime = Cvar_Get ("fixedtime", "0", 0);
-	logfile_active = Cvar_Get ("logfile", "0", 0);
+	Log_Init ();
+	Job_Init ();
 	showtrace = Cvar_Get ("showtrace", "0", 0);
+	showcvarlookups = Cvar_Get ("showcvarlookups", "0", 0);
 
 #ifdef DEDICATED_ONLY
 	dedicated = Cvar_Get ("dedicated", "1", CVAR_NOSET);
@@ -1532,6 +1678,8 @@ void Qcommon_Frame (int msec)
 	if (setjmp (abortframe))
 		return;
 
+	Scratch_BeginFrame ();
+
 	if (log_stats->modified)
 	{
 		log_stats->modified = false;
@@ -1581,6 +1729,14 @@ void Qcommon_Frame (int msec)
 		c_pointcontents = 0;
 	}
 
+	// cvar lookup debug
+	if (showcvarlookups->value)
+	{
+		Com_Printf ("%4i cvar lookups\n", cvar_lookups);
+	}
+
+	cvar_lookups = 0;
+
 	// r_maxfps > 1000 breaks things, and so does <= 0
 	// so cap to 1000 and treat <= 0 as "as fast as possible", which is 1000
 	if (r_maxfps->value > 1000 || r_maxfps->value < 1)
@@ -1719,6 +1875,8 @@ void Qcommon_Frame(int msec)
 	if (setjmp(abortframe))
 		return;
 
+	Scratch_BeginFrame ();
+
 	// timing debug
 	if (fixedtime->value)
 	{
@@ -1773,5 +1931,7 @@ Qcommon_Shutdown
 */
 void Qcommon_Shutdown (void)
 {
+	Job_Shutdown ();
+	Log_Shutdown ();
 	Cvar_Shutdown ();
 }
@@ -24,20 +24,47 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #define	NUM_CON_TIMES 4
 
-#define		CON_TEXTSIZE	4194304
+// the text is kept unpadded in a ring; lines and their wrapped rows point into it
+#define	CON_TEXTSIZE	0x200000		// must be a power of two
+#define	CON_TEXTMASK	(CON_TEXTSIZE - 1)
+#define	CON_MAXLINES	0x10000			// must be a power of two
+#define	CON_MAXROWS		0x10000			// must be a power of two
+#define	CON_MAXLINELEN	4096			// longer prints are broken into several lines
+
+typedef struct
+{
+	unsigned int	start;		// offset in the text ring, masked when read
+	int				length;
+	int				firstrow;	// row its text starts on
+} conline_t;
+
+typedef struct
+{
+	unsigned int	start;
+	int				length;
+} conrow_t;
+
 typedef struct
 {
 	qboolean	initialized;
 
-	char	text[CON_TEXTSIZE];
-	int		current;		// line where next message will be printed
-	int		x;				// offset in current line for next print
-	int		display;		// bottom of console displays this line
+	char		text[CON_TEXTSIZE];
+	unsigned int	textend;	// where the next character goes
+
+	conline_t	lines[CON_MAXLINES];
+	int			numlines;		// lines ever printed, the last one is still open
+	int			firstline;		// oldest line whose text hasn't been overwritten
+	qboolean	linefeed;		// the open line has ended
+	qboolean	cr;				// the next character rewrites the open line
+
+	conrow_t	rows[CON_MAXROWS];	// lines laid out at linewidth
+	int			current;		// last row
+	int			display;		// bottom of console displays this row
 
 	int		ormask;			// high bit mask for colored characters
 
 	int 	linewidth;		// characters across screen
-	int		totallines;		// total lines in console scrollback
+	int		totallines;		// rows still in the scrollback
 
 	float	cursorspeed;
 
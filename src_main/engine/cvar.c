@@ -23,6 +23,33 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 cvar_t	*cvar_vars;
 
+int		cvar_sequence;		// bumped on every value change
+int		cvar_lookups;		// Cvar_FindVar calls, reset every frame
+
+// the info strings are only rebuilt after a flagged cvar changes
+static char		cvar_userinfo[MAX_INFO_STRING];
+static char		cvar_serverinfo[MAX_INFO_STRING];
+static qboolean	cvar_userinfo_dirty = true;
+static qboolean	cvar_serverinfo_dirty = true;
+
+/*
+============
+Cvar_Changed
+
+Stamps a new value and invalidates any info string it appears in
+============
+*/
+static void Cvar_Changed (cvar_t *var, int flags)
+{
+	var->sequence = ++cvar_sequence;
+
+	if (flags & CVAR_USERINFO)
+		cvar_userinfo_dirty = true;
+
+	if (flags & CVAR_SERVERINFO)
+		cvar_serverinfo_dirty = true;
+}
+
 /*
 ============
 Cvar_InfoValidate
@@ -44,13 +71,9 @@ Cvar_FindVar
 */
 static cvar_t *Cvar_FindVar (char *var_name)
 {
-	cvar_t	*var;
+	cvar_lookups++;
 
-	for (var = cvar_vars; var; var = var->next)
-		if (!strcmp (var_name, var->name))
-			return var;
-
-	return NULL;
+	return Cmd_FindSymbol (var_name, SYMBOL_CVAR);
 }
 
 /*
@@ -121,9 +144,8 @@ char *Cvar_CompleteVariable (char *partial)
 		return NULL;
 
 	// check exact match
-	for (cvar = cvar_vars; cvar; cvar = cvar->next)
-		if (!strcmp (partial, cvar->name))
-			return cvar->name;
+	if ((cvar = Cvar_FindVar (partial)) != NULL)
+		return cvar->name;
 
 	// check partial match
 	for (cvar = cvar_vars; cvar; cvar = cvar->next)
@@ -159,6 +181,10 @@ cvar_t *Cvar_Get (char *var_name, char *var_value, int flags)
 
 	if (var)
 	{
+		// newly flagged info vars have to show up in the info strings
+		if (flags & ~var->flags)
+			Cvar_Changed (var, flags & ~var->flags);
+
 		var->flags |= flags;
 		return var;
 	}
@@ -185,8 +211,10 @@ cvar_t *Cvar_Get (char *var_name, char *var_value, int flags)
 	// link the variable in
 	var->next = cvar_vars;
 	cvar_vars = var;
+	Cmd_AddSymbol (var->name, SYMBOL_CVAR, var);
 
 	var->flags = flags;
+	Cvar_Changed (var, flags);
 
 	return var;
 }
@@ -250,6 +278,7 @@ cvar_t *Cvar_Set2 (char *var_name, char *value, qboolean force)
 				var->string = CopyString (value);
 				var->value = atof (var->string);
 				var->integer = atoi (var->string);
+				Cvar_Changed (var, var->flags);
 
 				if (!strcmp (var->name, "game"))
 				{
@@ -282,6 +311,7 @@ cvar_t *Cvar_Set2 (char *var_name, char *value, qboolean force)
 	var->string = CopyString (value);
 	var->value = atof (var->string);
 	var->integer = atoi (var->string);
+	Cvar_Changed (var, var->flags);
 
 	return var;
 }
@@ -333,6 +363,7 @@ cvar_t *Cvar_FullSet (char *var_name, char *value, int flags)
 	var->string = CopyString (value);
 	var->value = atof (var->string);
 	var->integer = atoi (var->string);
+	Cvar_Changed (var, var->flags | flags);
 	var->flags = flags;
 
 	return var;
@@ -377,6 +408,7 @@ void Cvar_GetLatchedVars (void)
 		var->latched_string = NULL;
 		var->value = atof (var->string);
 		var->integer = atoi (var->string);
+		Cvar_Changed (var, var->flags);
 
 		if (!strcmp (var->name, "game"))
 		{
@@ -528,9 +560,8 @@ void Cvar_List_f (void)
 qboolean userinfo_modified;
 
 
-char	*Cvar_BitInfo (int bit)
+static void Cvar_BitInfo (char *info, int bit)
 {
-	static char	info[MAX_INFO_STRING];
 	cvar_t	*var;
 
 	info[0] = 0;
@@ -540,20 +571,30 @@ char	*Cvar_BitInfo (int bit)
 		if (var->flags & bit)
 			Info_SetValueForKey (info, var->name, var->string);
 	}
-
-	return info;
 }
 
 // returns an info string containing all the CVAR_USERINFO cvars
 char	*Cvar_Userinfo (void)
 {
-	return Cvar_BitInfo (CVAR_USERINFO);
+	if (cvar_userinfo_dirty)
+	{
+		Cvar_BitInfo (cvar_userinfo, CVAR_USERINFO);
+		cvar_userinfo_dirty = false;
+	}
+
+	return cvar_userinfo;
 }
 
 // returns an info string containing all the CVAR_SERVERINFO cvars
 char	*Cvar_Serverinfo (void)
 {
-	return Cvar_BitInfo (CVAR_SERVERINFO);
+	if (cvar_serverinfo_dirty)
+	{
+		Cvar_BitInfo (cvar_serverinfo, CVAR_SERVERINFO);
+		cvar_serverinfo_dirty = false;
+	}
+
+	return cvar_serverinfo;
 }
 
 /*
@@ -581,6 +622,7 @@ void Cvar_Shutdown (void)
 	for (var = cvar_vars; var;)
 	{
 		cvar_t *c = var->next;
+		Cmd_RemoveSymbol(var->name, var);
 		Z_Free(var->string);
 		Z_Free(var->name);
 		Z_Free(var);
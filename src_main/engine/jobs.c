@@ -0,0 +1,216 @@
+/*
+Copyright (C) 1997-2001 Id Software, Inc.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+// jobs.c -- worker threads for data parallel loops
+
+/*
+Job_ParallelFor hands out the indexes of a loop to a pool of worker
+threads, with the calling thread pitching in, and returns once every
+index has been run.  It is only meant to be called from the main thread
+and doesn't nest.
+
+The work function must not touch anything that isn't safe to share:
+no printing, no cvars, and no allocation other than scratch memory
+released before it returns.  Traces are fine as long as the
+content mask doesn't include CONTENTS_MONSTER, since clipping against
+a bounding box entity rebuilds the shared box hull.
+
+job_threads sets the number of workers; negative uses one per core
+less the main thread, 0 runs everything on the calling thread.
+*/
+
+#include "qcommon.h"
+
+#define	MAX_JOB_THREADS		16
+
+static cvar_t	*job_threads;
+
+static void		*job_workers[MAX_JOB_THREADS];
+static int		job_numworkers;
+static void		*job_start;			// posted once per worker for each loop
+static void		*job_done;			// posted by each worker when it runs dry
+static int		job_quit;
+
+static void		(*job_func) (int index, void *data);
+static void		*job_data;
+static int		job_count;
+static int		job_next;			// next index to hand out
+
+
+/*
+================
+Job_Work
+
+Runs indexes until there are none left
+================
+*/
+static void Job_Work (void)
+{
+	int		i;
+
+	while ((i = Sys_AtomicAdd (&job_next, 1)) < job_count)
+		job_func (i, job_data);
+}
+
+/*
+================
+Job_Thread
+================
+*/
+static int Job_Thread (void *data)
+{
+	Scratch_InitThread (SCRATCH_THREAD_SIZE);
+
+	for (;;)
+	{
+		Sys_SemWait (job_start, -1);
+
+		if (Sys_AtomicGet (&job_quit))
+			break;
+
+		Job_Work ();
+		Sys_SemPost (job_done);
+	}
+
+	Scratch_ShutdownThread ();
+
+	return 0;
+}
+
+/*
+================
+Job_StopWorkers
+================
+*/
+static void Job_StopWorkers (void)
+{
+	int		i;
+
+	if (!job_numworkers)
+		return;
+
+	Sys_AtomicSet (&job_quit, 1);
+
+	for (i = 0; i < job_numworkers; i++)
+		Sys_SemPost (job_start);
+
+	for (i = 0; i < job_numworkers; i++)
+		Sys_WaitThread (job_workers[i]);
+
+	Sys_DestroySemaphore (job_start);
+	Sys_DestroySemaphore (job_done);
+
+	job_start = job_done = NULL;
+	job_numworkers = 0;
+}
+
+/*
+================
+Job_StartWorkers
+================
+*/
+static void Job_StartWorkers (void)
+{
+	int		i, count;
+
+	Job_StopWorkers ();
+
+	count = job_threads->value;
+
+	if (count < 0)
+		count = Sys_CPUCount () - 1;
+
+	if (count > MAX_JOB_THREADS)
+		count = MAX_JOB_THREADS;
+
+	job_threads->modified = false;
+
+	if (count <= 0)
+		return;
+
+	job_quit = 0;
+	job_start = Sys_CreateSemaphore (0);
+	job_done = Sys_CreateSemaphore (0);
+
+	for (i = 0; i < count; i++)
+		job_workers[i] = Sys_CreateThread (Job_Thread, NULL, "job");
+
+	job_numworkers = count;
+}
+
+/*
+================
+Job_ParallelFor
+
+Calls func (i, data) for every i in [0, count) and waits for them all
+================
+*/
+void Job_ParallelFor (void (*func) (int index, void *data), int count, void *data)
+{
+	int		i, workers;
+
+	if (job_threads->modified)
+		Job_StartWorkers ();
+
+	workers = job_numworkers;
+
+	if (workers > count - 1)
+		workers = count - 1;
+
+	if (workers <= 0)
+	{
+		for (i = 0; i < count; i++)
+			func (i, data);
+		return;
+	}
+
+	job_func = func;
+	job_data = data;
+	job_count = count;
+	Sys_AtomicSet (&job_next, 0);
+
+	for (i = 0; i < workers; i++)
+		Sys_SemPost (job_start);
+
+	Job_Work ();
+
+	for (i = 0; i < workers; i++)
+		Sys_SemWait (job_done, -1);
+}
+
+/*
+================
+Job_Shutdown
+================
+*/
+void Job_Shutdown (void)
+{
+	Job_StopWorkers ();
+}
+
+/*
+================
+Job_Init
+================
+*/
+void Job_Init (void)
+{
+	job_threads = Cvar_Get ("job_threads", "-1", CVAR_ARCHIVE);
+	job_threads->modified = true;
+}
@@ -0,0 +1,394 @@
+/*
+Copyright (C) 1997-2001 Id Software, Inc.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+// log.c -- asynchronous console logfile
+
+/*
+Com_Printf never touches the disk.  Printed text is timestamped and copied
+into a ring buffer, and a writer thread drains the ring into qconsole.log.
+The ring is single consumer: the writer only ever advances the tail and
+printing threads only ever advance the head, so draining never blocks a
+frame.  If the writer falls behind and the ring fills up, text is dropped
+and the loss is noted in the log rather than stalling the caller.
+
+logfile 1 buffers writes, 2 flushes after every drain, 3 appends instead of
+truncating.  logfile_maxsize (in kb) rotates the log to qconsole.1.log and
+so on when it grows too large.
+*/
+
+#include "qcommon.h"
+#include <time.h>
+
+#define	LOG_RING_SIZE		0x40000		// must be a power of two
+#define	LOG_RING_MASK		(LOG_RING_SIZE - 1)
+#define	LOG_WAKE_MSEC		100
+#define	LOG_BACKUPS			4
+
+static cvar_t	*logfile_active;	// 1 = buffer log, 2 = flush after each print, 3 = append
+static cvar_t	*logfile_maxsize;
+static cvar_t	*logfile_timestamps;
+
+static char		log_ring[LOG_RING_SIZE];
+static int		log_head;			// only advanced by printing threads
+static int		log_tail;			// only advanced by the writer thread
+static int		log_dropped;		// bytes lost to a full ring, guarded by log_lock
+static qboolean	log_linestart = true;
+
+static int		log_flush;			// settings the writer picks up
+static int		log_maxsize;
+static int		log_quit;
+
+static void		*log_thread;
+static void		*log_wake;
+static void		*log_lock;
+static qboolean	log_closed;			// don't reopen once shut down
+
+static FILE		*log_file;
+static char		log_name[MAX_OSPATH];
+static int		log_size;
+
+
+/*
+==============================================================================
+
+WRITER THREAD
+
+==============================================================================
+*/
+
+/*
+================
+Log_Rotate
+
+Shifts qconsole.log to qconsole.1.log and so on, dropping the oldest
+================
+*/
+static void Log_Rotate (void)
+{
+	char	from[MAX_OSPATH];
+	char	to[MAX_OSPATH];
+	int		i;
+
+	fclose (log_file);
+
+	Com_sprintf (to, sizeof (to), "%s.%i.log", log_name, LOG_BACKUPS);
+	remove (to);
+
+	for (i = LOG_BACKUPS - 1; i > 0; i--)
+	{
+		Com_sprintf (from, sizeof (from), "%s.%i.log", log_name, i);
+		Com_sprintf (to, sizeof (to), "%s.%i.log", log_name, i + 1);
+		rename (from, to);
+	}
+
+	Com_sprintf (from, sizeof (from), "%s.log", log_name);
+	Com_sprintf (to, sizeof (to), "%s.1.log", log_name);
+	rename (from, to);
+
+	log_file = fopen (from, "w");
+	log_size = 0;
+}
+
+/*
+================
+Log_Drain
+
+Writes everything currently in the ring
+================
+*/
+static void Log_Drain (void)
+{
+	int		head = Sys_AtomicGet (&log_head);
+	int		maxsize;
+
+	if (head == log_tail)
+		return;
+
+	while (log_tail != head)
+	{
+		int		offset = log_tail & LOG_RING_MASK;
+		int		len = head - log_tail;
+
+		// the ring may wrap, so write it in two pieces
+		if (len > LOG_RING_SIZE - offset)
+			len = LOG_RING_SIZE - offset;
+
+		if (log_file)
+			fwrite (log_ring + offset, 1, len, log_file);
+
+		log_size += len;
+		Sys_AtomicSet (&log_tail, log_tail + len);
+	}
+
+	if (!log_file)
+		return;
+
+	if (Sys_AtomicGet (&log_flush))
+		fflush (log_file);
+
+	maxsize = Sys_AtomicGet (&log_maxsize);
+
+	if (maxsize > 0 && log_size >= maxsize)
+		Log_Rotate ();
+}
+
+/*
+================
+Log_Thread
+================
+*/
+static int Log_Thread (void *data)
+{
+	Scratch_InitThread (SCRATCH_THREAD_SIZE);
+
+	while (!Sys_AtomicGet (&log_quit))
+	{
+		Sys_SemWait (log_wake, LOG_WAKE_MSEC);
+		Log_Drain ();
+	}
+
+	// pick up anything printed while we were shutting down
+	Log_Drain ();
+
+	if (log_file)
+	{
+		fclose (log_file);
+		log_file = NULL;
+	}
+
+	Scratch_ShutdownThread ();
+
+	return 0;
+}
+
+
+/*
+==============================================================================
+
+PRINTING SIDE
+
+==============================================================================
+*/
+
+/*
+================
+Log_Push
+
+Copies text into the ring; must be called with log_lock held.
+Returns false if there was no room.
+================
+*/
+static qboolean Log_Push (char *text, int len)
+{
+	int		head = log_head;
+	int		offset = head & LOG_RING_MASK;
+	int		room = LOG_RING_SIZE - (head - Sys_AtomicGet (&log_tail));
+
+	if (len > room)
+		return false;
+
+	if (len > LOG_RING_SIZE - offset)
+	{
+		memcpy (log_ring + offset, text, LOG_RING_SIZE - offset);
+		memcpy (log_ring, text + (LOG_RING_SIZE - offset), len - (LOG_RING_SIZE - offset));
+	}
+	else
+		memcpy (log_ring + offset, text, len);
+
+	// publish to the writer
+	Sys_AtomicSet (&log_head, head + len);
+
+	return true;
+}
+
+/*
+================
+Log_PushLine
+================
+*/
+static void Log_PushLine (char *text, int len)
+{
+	char	stamp[64];
+
+	if (log_dropped)
+	{
+		Com_sprintf (stamp, sizeof (stamp), "\n[%i bytes dropped]\n", log_dropped);
+
+		if (!Log_Push (stamp, strlen (stamp)))
+		{
+			log_dropped += len;
+			return;
+		}
+
+		log_dropped = 0;
+		log_linestart = true;
+	}
+
+	if (log_linestart && logfile_timestamps->value)
+	{
+		time_t		now = time (NULL);
+
+		strftime (stamp, sizeof (stamp), "[%Y-%m-%d %H:%M:%S] ", localtime (&now));
+
+		if (!Log_Push (stamp, strlen (stamp)))
+		{
+			log_dropped += len;
+			return;
+		}
+	}
+
+	if (!Log_Push (text, len))
+	{
+		log_dropped += len;
+		return;
+	}
+
+	log_linestart = (text[len - 1] == '\n');
+}
+
+/*
+================
+Log_Open
+================
+*/
+static qboolean Log_Open (void)
+{
+	char	name[MAX_OSPATH];
+
+	if (log_closed)
+		return false;
+
+	Com_sprintf (log_name, sizeof (log_name), "%s/qconsole", FS_Gamedir ());
+	Com_sprintf (name, sizeof (name), "%s.log", log_name);
+
+	if (logfile_active->value > 2)
+		log_file = fopen (name, "a");
+	else
+		log_file = fopen (name, "w");
+
+	if (!log_file)
+	{
+		log_closed = true;
+		return false;
+	}
+
+	fseek (log_file, 0, SEEK_END);
+	log_size = ftell (log_file);
+
+	log_head = log_tail = 0;
+	log_quit = 0;
+	log_linestart = true;
+
+	log_lock = Sys_CreateMutex ();
+	log_wake = Sys_CreateSemaphore (0);
+	log_thread = Sys_CreateThread (Log_Thread, NULL, "log");
+
+	return true;
+}
+
+/*
+================
+Log_Print
+
+Queues text for the logfile without touching the disk
+================
+*/
+void Log_Print (char *msg)
+{
+	char	*s, *line;
+	int		used;
+
+	if (!logfile_active || !logfile_active->value)
+		return;
+
+	if (!log_thread && !Log_Open ())
+		return;
+
+	if (logfile_active->modified || logfile_maxsize->modified)
+	{
+		Sys_AtomicSet (&log_flush, logfile_active->value == 2);
+		Sys_AtomicSet (&log_maxsize, (int) logfile_maxsize->value * 1024);
+
+		logfile_active->modified = false;
+		logfile_maxsize->modified = false;
+	}
+
+	Sys_LockMutex (log_lock);
+
+	// break the text at newlines so every line gets a timestamp
+	for (line = s = msg; *s; s++)
+	{
+		if (*s == '\n')
+		{
+			Log_PushLine (line, s - line + 1);
+			line = s + 1;
+		}
+	}
+
+	if (s > line)
+		Log_PushLine (line, s - line);
+
+	used = Sys_AtomicGet (&log_head) - Sys_AtomicGet (&log_tail);
+
+	Sys_UnlockMutex (log_lock);
+
+	// don't wait for the timeout if we're flushing or filling up
+	if (Sys_AtomicGet (&log_flush) || used > LOG_RING_SIZE / 2)
+		Sys_SemPost (log_wake);
+}
+
+/*
+================
+Log_Shutdown
+
+Drains everything queued so far to disk and closes the log; called on
+quit and on fatal errors
+================
+*/
+void Log_Shutdown (void)
+{
+	if (!log_thread)
+		return;
+
+	Sys_AtomicSet (&log_quit, 1);
+	Sys_SemPost (log_wake);
+	Sys_WaitThread (log_thread);
+
+	Sys_DestroySemaphore (log_wake);
+	Sys_DestroyMutex (log_lock);
+
+	log_thread = NULL;
+	log_wake = NULL;
+	log_lock = NULL;
+	log_closed = true;
+}
+
+/*
+================
+Log_Init
+================
+*/
+void Log_Init (void)
+{
+	logfile_active = Cvar_Get ("logfile", "0", 0);
+	logfile_maxsize = Cvar_Get ("logfile_maxsize", "0", 0);
+	logfile_timestamps = Cvar_Get ("logfile_timestamps", "1", 0);
+
+	logfile_active->modified = true;
+}
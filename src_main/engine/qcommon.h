@@ -454,6 +454,19 @@ void	Cmd_RemoveCommand (char *cmd_name);
 qboolean Cmd_Exists (char *cmd_name);
 // used by the cvar code to check for cvar / command name overlap
 
+typedef enum
+{
+	SYMBOL_COMMAND,
+	SYMBOL_ALIAS,
+	SYMBOL_CVAR
+} symboltype_t;
+
+void	Cmd_AddSymbol (char *name, symboltype_t type, void *data);
+void	Cmd_RemoveSymbol (char *name, void *data);
+void	*Cmd_FindSymbol (char *name, symboltype_t type);
+// hashed name table shared by commands, aliases and cvars.
+// name is referenced, not copied, and must outlive the symbol
+
 char 	*Cmd_CompleteCommand (char *partial);
 // attempts to match a partial command for automatic command line completion
 // returns NULL if nothing fits
@@ -547,9 +560,18 @@ void	Cvar_Shutdown(void);
 
 char	*Cvar_Userinfo (void);
 // returns an info string containing all the CVAR_USERINFO cvars
+// the string is cached until one of those cvars changes, don't modify it
 
 char	*Cvar_Serverinfo (void);
 // returns an info string containing all the CVAR_SERVERINFO cvars
+// the string is cached until one of those cvars changes, don't modify it
+
+extern	int		cvar_sequence;
+// incremented on every cvar value change; compare against cvar_t->sequence
+// to find out whether anything changed since a previous snapshot
+
+extern	int		cvar_lookups;
+// number of by-name cvar lookups since the start of the frame
 
 extern	qboolean	userinfo_modified;
 // this is set each time a CVAR_USERINFO variable is changed
@@ -709,7 +731,8 @@ qboolean	CM_AreasConnected (int area1, int area2);
 int			CM_WriteAreaBits (byte *buffer, int area);
 qboolean	CM_HeadnodeVisible (int headnode, byte *visbits);
 
-void		CM_WritePortalState (FILE *f);
+int			CM_PortalStateSize (void);
+void		CM_WritePortalState (sizebuf_t *buf);
 void		CM_ReadPortalState (FILE *f);
 
 /*
@@ -839,6 +862,16 @@ void Qcommon_Init (int argc, char **argv);
 void Qcommon_Frame (int msec);
 void Qcommon_Shutdown (void);
 
+void Log_Init (void);
+void Log_Print (char *msg);
+void Log_Shutdown (void);
+// asynchronous logfile; Log_Shutdown drains pending text to disk
+
+void Job_Init (void);
+void Job_ParallelFor (void (*func) (int index, void *data), int count, void *data);
+void Job_Shutdown (void);
+// runs func for every index on the worker threads and returns when all are done
+
 #define NUMVERTEXNORMALS	162
 
 extern float r_avertexnormals[NUMVERTEXNORMALS][3];
@@ -871,6 +904,31 @@ char	*Sys_GetClipboardData (void);
 void    Sys_ShowMessageBox (const char* title, const char* message);
 void	Sys_SetIcon (void);
 
+void	*Sys_CreateThread (int (*function) (void *), void *data, char *name);
+void	Sys_WaitThread (void *thread);
+void	*Sys_CreateMutex (void);
+void	Sys_DestroyMutex (void *mutex);
+void	Sys_LockMutex (void *mutex);
+void	Sys_UnlockMutex (void *mutex);
+void	*Sys_CreateSemaphore (int value);
+void	Sys_DestroySemaphore (void *sem);
+void	Sys_SemPost (void *sem);
+qboolean Sys_SemWait (void *sem, int msec);
+// msec < 0 waits forever, returns false on timeout
+
+int		Sys_AtomicGet (int *value);
+void	Sys_AtomicSet (int *value, int v);
+int		Sys_AtomicAdd (int *value, int v);
+// full barrier atomics; Sys_AtomicAdd returns the previous value
+
+int		Sys_CPUCount (void);
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
 
 /*
 ==============================================================
@@ -891,4 +949,11 @@ void SV_Init (void);
 void SV_Shutdown (char *finalmsg, qboolean reconnect);
 void SV_Frame (int msec);
 
-void *Scratch_Alloc (void);
+// per-thread linear temp allocator; pop with Scratch_Release (mark)
+#define	SCRATCH_THREAD_SIZE		0x40000		// arena for threads other than the main one
+
+int Scratch_Mark (void);
+void *Scratch_Alloc (int size);
+void Scratch_Release (int mark);
+void Scratch_InitThread (int size);
+void Scratch_ShutdownThread (void);
@@ -19,6 +19,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 */
 // sys.c
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // for mremap() - must be before any system include!
+#endif
+
 #include "qcommon.h"
 #include "input.h"
 
@@ -40,10 +44,6 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 extern _declspec(dllexport) DWORD NvOptimusEnablement = 0x00000001;
 extern _declspec(dllexport) int AmdPowerXpressRequestHighPerformance = 1;
 #else
-//#define WANT_MMAP 0 // HACK!!!
-#if defined(__linux__) && !defined(_GNU_SOURCE)
-#define _GNU_SOURCE // for mremap() - must be before sys/mman.h include!
-#endif
 #include <sys/mman.h>
 #include <sys/time.h>
 #include <dirent.h>
@@ -72,48 +72,103 @@ SYSTEM MEMORY
 ===============================================================================
 */
 
+/*
+The hunk is a single reserved block of address space that is committed on
+demand as Hunk_Alloc walks through it. Every live hunk is tracked so that
+"hunklist" can report how much of each reservation is actually resident.
+
+On POSIX the whole reservation (plus one trailing guard page) is mapped
+PROT_NONE and pages are made accessible in HUNK_COMMIT_CHUNK steps, so any
+overrun past the committed area faults instead of silently trashing memory.
+Hunk_End gives the unused tail back to the kernel, keeping the guard page.
+*/
+
+#define	MAX_HUNKS			1024
+#define	HUNK_COMMIT_CHUNK	0x10000		// 64k commit granularity
+
+typedef struct
+{
+	byte	*base;
+	size_t	reserved;		// bytes of address space currently mapped
+	size_t	committed;		// bytes made accessible
+	size_t	used;			// bytes handed out by Hunk_Alloc
+	char	name[MAX_QPATH];
+} hunk_t;
+
+static hunk_t	hunks[MAX_HUNKS];
+static hunk_t	*curhunk;
+
 byte	*membase;
 int		maxhunksize;
 int		curhunksize;
 
-void *Hunk_Begin(int maxsize)
+#ifndef _WIN32
+static size_t	hunk_pagesize;
+
+static size_t Hunk_PageRound (size_t size)
 {
-	// reserve a huge chunk of memory, but don't commit any yet
-#ifdef _WIN32
-	maxhunksize = maxsize;
-#else
-	maxhunksize = maxsize + sizeof(int);
+	return (size + hunk_pagesize - 1) & ~(hunk_pagesize - 1);
+}
 #endif
+
+static hunk_t *Hunk_FindSlot (void *base)
+{
+	int		i;
+
+	for (i = 0; i < MAX_HUNKS; i++)
+	{
+		if (hunks[i].base == base)
+			return &hunks[i];
+	}
+
+	return NULL;
+}
+
+void *Hunk_Begin(int maxsize, char *name)
+{
+	curhunk = Hunk_FindSlot (NULL);
+	if (!curhunk)
+		Sys_Error("Hunk_Begin: MAX_HUNKS");
+
+	maxhunksize = maxsize;
 	curhunksize = 0;
 
-	// do the allocation
+	// reserve a huge chunk of memory, but don't commit any yet
 #ifdef _WIN32
 	membase = VirtualAlloc(NULL, maxhunksize, MEM_RESERVE, PAGE_NOACCESS);
 	if (!membase)
 		Sys_Error("unable to virtual allocate %d bytes", maxhunksize);
+
+	curhunk->reserved = maxhunksize;
 #else
-#ifdef WANT_MMAP
-	membase = mmap(0, maxhunksize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-	if ((membase == NULL) || (membase == (byte *)-1))
-		Sys_Error("unable to virtual allocate %d bytes", maxhunksize);
-#else
-	maxhunksize = maxsize;
-	membase = malloc(maxhunksize);
-	if (membase == NULL)
-		Sys_Error("unable to allocate %d bytes", maxsize);
+	if (!hunk_pagesize)
+	{
+		long page_size = sysconf(_SC_PAGESIZE);
+
+		if (page_size == -1)
+			Sys_Error("Hunk_Begin: sysconf _SC_PAGESIZE failed (%d)", errno);
+
+		hunk_pagesize = page_size;
+	}
+
+	// the extra page past the end is never committed and acts as a guard
+	curhunk->reserved = Hunk_PageRound (maxhunksize) + hunk_pagesize;
+
+	membase = mmap(0, curhunk->reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS
+#ifdef MAP_NORESERVE
+		| MAP_NORESERVE
 #endif
+		, -1, 0);
+	if ((membase == NULL) || (membase == (byte *)MAP_FAILED))
+		Sys_Error("unable to virtual allocate %d bytes", maxhunksize);
 #endif
 
-#ifdef _WIN32
-	return (void *)membase;
-#else
-#ifdef WANT_MMAP
-	*((int *)membase) = curhunksize;
-	return membase + sizeof(int);
-#else
+	curhunk->base = membase;
+	curhunk->committed = 0;
+	curhunk->used = 0;
+	Q_strlcpy (curhunk->name, name ? name : "?", sizeof (curhunk->name));
+
 	return (void *)membase;
-#endif
-#endif
 }
 
 void *Hunk_Alloc(int size)
@@ -123,6 +178,9 @@ void *Hunk_Alloc(int size)
 	// round to cacheline
 	size = (size + 31) &~31;
 
+	if (curhunksize + size > maxhunksize)
+		Sys_Error("Hunk_Alloc overflow");
+
 #ifdef _WIN32
 	// commit pages as needed
 	buf = VirtualAlloc(membase + curhunksize, size, MEM_COMMIT, PAGE_READWRITE);
@@ -133,123 +191,127 @@ void *Hunk_Alloc(int size)
 		Sys_Error("VirtualAlloc commit failed.\n%s", buf);
 	}
 
-	curhunksize += size;
+	curhunk->committed = curhunksize + size;
+#else
+	// commit pages as needed
+	if (curhunksize + size > curhunk->committed)
+	{
+		size_t	commit;
 
-	if (curhunksize > maxhunksize)
-		Sys_Error("Hunk_Alloc overflow");
+		commit = (curhunksize + size + HUNK_COMMIT_CHUNK - 1) & ~(HUNK_COMMIT_CHUNK - 1);
+		if (commit > curhunk->reserved - hunk_pagesize)
+			commit = curhunk->reserved - hunk_pagesize;
 
-	return (void *)(membase + curhunksize - size);
-#else
-	if (curhunksize + size > maxhunksize)
-		Sys_Error("Hunk_Alloc overflow");
+		if (mprotect(membase + curhunk->committed, commit - curhunk->committed, PROT_READ | PROT_WRITE))
+			Sys_Error("Hunk_Alloc: mprotect commit failed (%d)", errno);
+
+		curhunk->committed = commit;
+	}
+#endif
 
-#ifdef WANT_MMAP
-	buf = membase + sizeof(int) + curhunksize;
-	curhunksize += size;
-#else
 	buf = membase + curhunksize;
 	curhunksize += size;
-#endif
+	curhunk->used = curhunksize;
+
 	return buf;
-#endif
 }
 
 int Hunk_End(void)
 {
-#ifdef _WIN32
-	return curhunksize;
-#else
-#ifdef WANT_MMAP
-	byte *n = NULL;
+#ifndef _WIN32
+	size_t	keep;
+	byte	*n = NULL;
 
-#if defined( __linux__ )
-	n = (byte *)mremap(membase, maxhunksize, curhunksize + sizeof(int), 0);
-#elif defined( __FreeBSD__ )
-	size_t old_size = maxhunksize;
-	size_t new_size = curhunksize + sizeof(int);
-	void *unmap_base;
-	size_t unmap_len;
+	// keep the used pages plus a fresh guard page
+	keep = Hunk_PageRound (curhunksize);
 
-	new_size = round_page(new_size);
-	old_size = round_page(old_size);
-
-	if (new_size > old_size)
-	{
-		n = 0; // error
-	}
-	else if (new_size < old_size)
+	if (keep + hunk_pagesize < curhunk->reserved)
 	{
-		unmap_base = (caddr_t)(membase + new_size);
-		unmap_len = old_size - new_size;
-		n = munmap(unmap_base, unmap_len) + membase;
-	}
+#if defined( __linux__ )
+		n = (byte *)mremap(membase, curhunk->reserved, keep + hunk_pagesize, 0);
 #else
-#ifndef round_page
-	#define round_page(x) (((size_t)(x) + (page_size - 1)) / page_size) * page_size
+		n = (byte *)membase;
+		if (munmap(membase + keep + hunk_pagesize, curhunk->reserved - (keep + hunk_pagesize)))
+			n = NULL;
 #endif
-	size_t old_size = maxhunksize;
-	size_t new_size = curhunksize + sizeof(int);
-	void *unmap_base;
-	size_t unmap_len;
-	long page_size;
 
-	page_size = sysconf(_SC_PAGESIZE);
-	if (page_size == -1)
-		Sys_Error("Hunk_End: sysconf _SC_PAGESIZE failed (%d)", errno);
+		if (n != membase)
+			Sys_Error("Hunk_End: Could not remap virtual block (%d)", errno);
 
-	new_size = round_page(new_size);
-	old_size = round_page(old_size);
-
-	if (new_size > old_size)
-	{
-		n = 0; // error
+		curhunk->reserved = keep + hunk_pagesize;
 	}
-	else if (new_size < old_size)
+
+	if (curhunk->committed > keep)
 	{
-		unmap_base = (caddr_t)(membase + new_size);
-		unmap_len = old_size - new_size;
-		n = munmap(unmap_base, unmap_len) + membase;
+		// the page after the last used one may have been committed by the
+		// 64k rounding, so revoke it to restore the guard
+		if (mprotect(membase + keep, curhunk->reserved - keep, PROT_NONE))
+			Sys_Error("Hunk_End: mprotect guard failed (%d)", errno);
+
+		curhunk->committed = keep;
 	}
 #endif
 
-	if (n != membase)
-		Sys_Error("Hunk_End: Could not remap virtual block (%d)", errno);
-
-	*((int *)membase) = curhunksize + sizeof(int);
+	curhunk = NULL;
 
 	return curhunksize;
-#else
-	byte *n;
-
-	n = realloc(membase, curhunksize);
-	if (n != membase)
-		Sys_Error("Hunk_End:  Could not remap virtual block (%d)", errno);
-
-	return curhunksize;
-#endif
-#endif
 }
 
 void Hunk_Free(void *base)
 {
+	hunk_t	*hunk;
+
+	if (!base)
+		return;
+
+	hunk = Hunk_FindSlot (base);
+	if (!hunk)
+		Sys_Error("Hunk_Free: unknown hunk %p", base);
+
 #ifdef _WIN32
-	if (base)
-		VirtualFree(base, 0, MEM_RELEASE);
+	VirtualFree(base, 0, MEM_RELEASE);
 #else
-#ifdef WANT_MMAP
-	byte *m;
-	if (base)
+	if (munmap(base, hunk->reserved))
+		Sys_Error("Hunk_Free: munmap failed (%d)", errno);
+#endif
+
+	memset (hunk, 0, sizeof (*hunk));
+}
+
+/*
+================
+Hunk_List_f
+
+Reports reserved vs. committed address space for every live hunk
+================
+*/
+static void Hunk_List_f (void)
+{
+	int		i, count;
+	size_t	reserved, committed, used;
+
+	count = 0;
+	reserved = committed = used = 0;
+
+	Com_Printf ("  reserved committed      used name\n");
+
+	for (i = 0; i < MAX_HUNKS; i++)
 	{
-		m = ((byte *)base) - sizeof(int);
+		hunk_t *hunk = &hunks[i];
 
-		if (munmap(m, *((int *)m)))
-			Sys_Error("Hunk_Free: munmap failed (%d)", errno);
+		if (!hunk->base)
+			continue;
+
+		Com_Printf ("%10u %9u %9u %s%s\n", (unsigned)hunk->reserved, (unsigned)hunk->committed,
+			(unsigned)hunk->used, hunk->name, (hunk == curhunk) ? " (loading)" : "");
+
+		reserved += hunk->reserved;
+		committed += hunk->committed;
+		used += hunk->used;
+		count++;
 	}
-#else
-	if (base)
-		free(base);
-#endif
-#endif
+
+	Com_Printf ("%i hunks, %u reserved, %u committed, %u used\n", count, (unsigned)reserved, (unsigned)committed, (unsigned)used);
 }
 
 
@@ -489,6 +551,114 @@ void Sys_FindClose(void)
 }
 
 
+/*
+===============================================================================
+
+THREADS
+
+Thin wrappers so the engine doesn't talk to SDL directly
+
+===============================================================================
+*/
+
+void *Sys_CreateThread (int (*function) (void *), void *data, char *name)
+{
+	SDL_Thread	*thread = SDL_CreateThread (function, name, data);
+
+	if (!thread)
+		Sys_Error ("Sys_CreateThread: %s", SDL_GetError ());
+
+	return thread;
+}
+
+void Sys_WaitThread (void *thread)
+{
+	SDL_WaitThread ((SDL_Thread *) thread, NULL);
+}
+
+void *Sys_CreateMutex (void)
+{
+	SDL_mutex	*mutex = SDL_CreateMutex ();
+
+	if (!mutex)
+		Sys_Error ("Sys_CreateMutex: %s", SDL_GetError ());
+
+	return mutex;
+}
+
+void Sys_DestroyMutex (void *mutex)
+{
+	SDL_DestroyMutex ((SDL_mutex *) mutex);
+}
+
+void Sys_LockMutex (void *mutex)
+{
+	SDL_LockMutex ((SDL_mutex *) mutex);
+}
+
+void Sys_UnlockMutex (void *mutex)
+{
+	SDL_UnlockMutex ((SDL_mutex *) mutex);
+}
+
+void *Sys_CreateSemaphore (int value)
+{
+	SDL_sem		*sem = SDL_CreateSemaphore (value);
+
+	if (!sem)
+		Sys_Error ("Sys_CreateSemaphore: %s", SDL_GetError ());
+
+	return sem;
+}
+
+void Sys_DestroySemaphore (void *sem)
+{
+	SDL_DestroySemaphore ((SDL_sem *) sem);
+}
+
+void Sys_SemPost (void *sem)
+{
+	SDL_SemPost ((SDL_sem *) sem);
+}
+
+/*
+================
+Sys_SemWait
+
+Waits up to msec milliseconds, or forever if msec is negative.
+Returns false on timeout.
+================
+*/
+qboolean Sys_SemWait (void *sem, int msec)
+{
+	if (msec < 0)
+		return SDL_SemWait ((SDL_sem *) sem) == 0;
+
+	return SDL_SemWaitTimeout ((SDL_sem *) sem, msec) == 0;
+}
+
+// the atomics operate on plain ints, which is all SDL_atomic_t wraps
+int Sys_AtomicGet (int *value)
+{
+	return SDL_AtomicGet ((SDL_atomic_t *) value);
+}
+
+void Sys_AtomicSet (int *value, int v)
+{
+	SDL_AtomicSet ((SDL_atomic_t *) value, v);
+}
+
+int Sys_AtomicAdd (int *value, int v)
+{
+	return SDL_AtomicAdd ((SDL_atomic_t *) value, v);
+}
+
+int Sys_CPUCount (void)
+{
+	return SDL_GetCPUCount ();
+}
+
+
 //================================================================
 
 
@@ -685,6 +855,8 @@ void Sys_Init (void)
 
 	// setup FPU if necessary
 	Sys_SetupFPU();
+
+	Cmd_AddCommand ("hunklist", Hunk_List_f);
 }
 
 
@@ -57,6 +57,10 @@ typedef struct
 	char		configstrings[MAX_CONFIGSTRINGS][MAX_QPATH];
 	entity_state_t	baselines[MAX_EDICTS];
 
+	// edicts that have been passed to linkentity, which are the only
+	// ones that can be sent to clients; cleared lazily once freed
+	unsigned	linkedbits[MAX_EDICTS / 32];
+
 	// the multicast buffer is used to send a message to a set of clients
 	// it is only used to marshall data until SV_Multicast is called
 	sizebuf_t	multicast;
@@ -197,6 +201,7 @@ extern	cvar_t		*sv_noreload;			// don't reload level state when reentering
 extern	cvar_t		*sv_airaccelerate;		// don't reload level state when reentering
 // development tool
 extern	cvar_t		*sv_enforcetime;
+extern	cvar_t		*sv_entscan;			// 0 = pick per frame, 1 = always linear, 2 = always linked bits
 
 extern	client_t	*sv_client;
 extern	edict_t		*sv_player;
@@ -268,6 +273,9 @@ void SV_ExecuteClientMessage (client_t *cl);
 // sv_ccmds.c
 //
 void SV_ReadLevelFile (void);
+void SV_WaitSaveGame (void);
+void SV_StartSaveGame (void);
+void SV_WriteSaveFile (char *name, void *data, int len);
 void SV_Status_f (void);
 
 //
@@ -276,6 +284,7 @@ void SV_Status_f (void);
 void SV_WriteFrameToClient (client_t *client, sizebuf_t *msg);
 void SV_RecordDemoMessage (void);
 void SV_BuildClientFrame (client_t *client, qboolean clientonly);
+void SV_EntScanBench_f (void);
 
 
 void SV_Error (char *error, ...);
@@ -166,6 +166,8 @@ void SV_WipeSavegame (char *savename)
 
 	Com_DPrintf ("SV_WipeSaveGame(%s)\n", savename);
 
+	SV_WaitSaveGame ();
+
 	Com_sprintf (name, sizeof (name), "%s/save/%s/server.ssv", FS_Gamedir (), savename);
 	remove (name);
 	Com_sprintf (name, sizeof (name), "%s/save/%s/game.ssv", FS_Gamedir (), savename);
@@ -294,30 +296,404 @@ void SV_CopySaveGame (char *src, char *dst)
 
 
 /*
-==============
-SV_WriteLevelFile
+===============================================================================
 
-==============
+BACKGROUND SAVEGAME WRITES
+
+Saving used to block the server for as long as the disk took.  The level and
+server files are now serialized into memory on the server thread and queued
+here together with any slot copies; a save thread then does all of the
+reading, writing and removing in queue order, each write going through a
+temporary file that is renamed into place so a crash never leaves a half
+written file behind.  server.ssv is copied last, so a slot doesn't look
+loadable until the rest of it is there.
+
+Directory listings stay on the server thread, as Sys_FindFirst isn't safe
+to call from two threads at once.
+
+===============================================================================
 */
-void SV_WriteLevelFile (void)
+
+typedef struct savefile_s
 {
+	struct savefile_s	*next;
 	char	name[MAX_OSPATH];
-	FILE	*f;
+	char	src[MAX_OSPATH];		// copy from here; empty = use data
+	int		len;					// -1 = remove the file
+	byte	*data;
+} savefile_t;
 
-	Com_DPrintf ("SV_WriteLevelFile()\n");
+static void			*sv_savethread;
+static savefile_t	*sv_savefiles;
+static savefile_t	**sv_savetail;		// non NULL while a job is being queued
+static int			sv_savefailed;
 
-	Com_sprintf (name, sizeof (name), "%s/save/current/%s.sv2", FS_Gamedir(), sv.name);
-	f = fopen (name, "wb");
+/*
+================
+SV_QueueSaveFile
 
-	if (!f)
+Appends a file to the save job being built, starting a new job if needed;
+the new entry removes name unless the caller fills it in
+================
+*/
+static savefile_t *SV_QueueSaveFile (char *name)
+{
+	savefile_t	*file;
+
+	if (!sv_savetail)
 	{
-		Com_Printf ("Failed to open %s\n", name);
+		SV_WaitSaveGame ();
+
+		sv_savefiles = NULL;
+		sv_savetail = &sv_savefiles;
+	}
+
+	file = malloc (sizeof (*file));
+	memset (file, 0, sizeof (*file));
+	Q_strlcpy (file->name, name, sizeof (file->name));
+	file->len = -1;
+
+	*sv_savetail = file;
+	sv_savetail = &file->next;
+
+	return file;
+}
+
+/*
+================
+SV_QueueSaveCopy
+
+Queues a copy of src over name; if src is missing when the save thread
+gets to it, name is removed instead
+================
+*/
+static void SV_QueueSaveCopy (char *src, char *name)
+{
+	savefile_t	*file = SV_QueueSaveFile (name);
+
+	Q_strlcpy (file->src, src, sizeof (file->src));
+}
+
+/*
+================
+SV_SaveFileQueued
+
+Returns true if the job being built already touches dir followed by base
+================
+*/
+static qboolean SV_SaveFileQueued (char *dir, int dirlen, char *base)
+{
+	savefile_t	*file;
+
+	if (!sv_savetail)
+		return false;
+
+	for (file = sv_savefiles; file; file = file->next)
+	{
+		if (!Q_strncasecmp (file->name, dir, dirlen) && !Q_stricmp (file->name + dirlen, base))
+			return true;
+	}
+
+	return false;
+}
+
+/*
+================
+SV_WriteSaveFile
+
+Queues len bytes of data to be written to name; the data is copied, so the
+caller can reuse its buffer straight away.  Also given to the game for its
+own save files.
+================
+*/
+void SV_WriteSaveFile (char *name, void *data, int len)
+{
+	savefile_t	*file = SV_QueueSaveFile (name);
+
+	file->data = malloc (len + 1);
+	memcpy (file->data, data, len);
+	file->len = len;
+}
+
+/*
+================
+SV_LoadSaveSource
+
+Reads a queued copy's source into memory on the save thread
+================
+*/
+static void SV_LoadSaveSource (savefile_t *file)
+{
+	FILE	*f;
+
+	f = fopen (file->src, "rb");
+
+	if (!f)
 		return;
+
+	fseek (f, 0, SEEK_END);
+	file->len = ftell (f);
+	fseek (f, 0, SEEK_SET);
+
+	file->data = malloc (file->len + 1);
+
+	if ((int) fread (file->data, 1, file->len, f) != file->len)
+	{
+		free (file->data);
+		file->data = NULL;
+		file->len = -1;
+		sv_savefailed++;
 	}
 
-	fwrite (sv.configstrings, sizeof (sv.configstrings), 1, f);
-	CM_WritePortalState (f);
 	fclose (f);
+}
+
+/*
+================
+SV_SaveThread
+================
+*/
+static int SV_SaveThread (void *data)
+{
+	savefile_t	*file, *next;
+	char		tmp[MAX_OSPATH + 4];
+	FILE		*f;
+	int			written;
+
+	Scratch_InitThread (SCRATCH_THREAD_SIZE);
+
+	for (file = sv_savefiles; file; file = next)
+	{
+		next = file->next;
+
+		if (file->src[0])
+			SV_LoadSaveSource (file);
+
+		if (file->len < 0)
+		{
+			remove (file->name);
+		}
+		else
+		{
+			Com_sprintf (tmp, sizeof (tmp), "%s.tmp", file->name);
+			f = fopen (tmp, "wb");
+
+			if (f)
+			{
+				written = fwrite (file->data, 1, file->len, f);
+
+				if (fclose (f) || written != file->len)
+				{
+					remove (tmp);
+					sv_savefailed++;
+				}
+				else
+				{
+#ifdef _WIN32
+					// rename won't replace an existing file
+					remove (file->name);
+#endif
+					if (rename (tmp, file->name))
+						sv_savefailed++;
+				}
+			}
+			else
+				sv_savefailed++;
+
+			free (file->data);
+		}
+
+		free (file);
+	}
+
+	sv_savefiles = NULL;
+
+	Scratch_ShutdownThread ();
+
+	return 0;
+}
+
+/*
+================
+SV_StartSaveGame
+
+Hands the queued save job to the save thread
+================
+*/
+void SV_StartSaveGame (void)
+{
+	if (!sv_savetail)
+		return;
+
+	sv_savetail = NULL;
+
+	if (!sv_savefiles)
+		return;
+
+	sv_savefailed = 0;
+	sv_savethread = Sys_CreateThread (SV_SaveThread, NULL, "savegame");
+}
+
+/*
+================
+SV_WaitSaveGame
+
+Blocks until everything queued has been written; called before anything
+else touches the savegame directories
+================
+*/
+void SV_WaitSaveGame (void)
+{
+	SV_StartSaveGame ();
+
+	if (!sv_savethread)
+		return;
+
+	Sys_WaitThread (sv_savethread);
+	sv_savethread = NULL;
+
+	if (sv_savefailed)
+		Com_Printf ("WARNING: %i savegame files couldn't be written\n", sv_savefailed);
+
+	sv_savefailed = 0;
+}
+
+/*
+================
+SV_BackgroundCopySaveGame
+
+Same as SV_CopySaveGame, but queued behind any level and server files that
+are still waiting to be written, and done on the save thread.  mapshot.tga
+is left alone when the caller writes its own.
+================
+*/
+void SV_BackgroundCopySaveGame (char *src, char *dst, qboolean mapshot)
+{
+	char		name[MAX_OSPATH], name2[MAX_OSPATH];
+	char		srcdir[MAX_OSPATH], dstdir[MAX_OSPATH];
+	char		*found, *base;
+	char		*pattern[2] = {"*.sav", "*.sv2"};
+	savefile_t	*file, *pending;
+	int			i, srclen, dstlen;
+
+	Com_DPrintf ("SV_BackgroundCopySaveGame(%s, %s)\n", src, dst);
+
+	Com_sprintf (srcdir, sizeof (srcdir), "%s/save/%s/", FS_Gamedir(), src);
+	srclen = strlen (srcdir);
+	Com_sprintf (dstdir, sizeof (dstdir), "%s/save/%s/", FS_Gamedir(), dst);
+	dstlen = strlen (dstdir);
+
+	FS_CreatePath (dstdir);
+
+	// remember what is already queued for src, since those files may not
+	// be on disk yet
+	pending = sv_savetail ? sv_savefiles : NULL;
+
+	// take the old server.ssv away before anything else is replaced, so an
+	// interrupted copy never leaves a slot that mixes two games
+	Com_sprintf (name2, sizeof (name2), "%sserver.ssv", dstdir);
+	SV_QueueSaveFile (name2);
+
+	Com_sprintf (name, sizeof (name), "%sgame.ssv", srcdir);
+	Com_sprintf (name2, sizeof (name2), "%sgame.ssv", dstdir);
+	SV_QueueSaveCopy (name, name2);
+
+	if (mapshot)
+	{
+		Com_sprintf (name, sizeof (name), "%smapshot.tga", srcdir);
+		Com_sprintf (name2, sizeof (name2), "%smapshot.tga", dstdir);
+		SV_QueueSaveCopy (name, name2);
+	}
+
+	// copy the level files that are waiting to be written
+	for (file = pending; file; file = file->next)
+	{
+		if (Q_strncasecmp (file->name, srcdir, srclen) || file->len < 0)
+			continue;
+
+		base = file->name + srclen;
+		i = strlen (base);
+
+		if (i < 4 || (Q_stricmp (base + i - 4, ".sav") && Q_stricmp (base + i - 4, ".sv2")))
+			continue;
+
+		if (SV_SaveFileQueued (dstdir, dstlen, base))
+			continue;
+
+		Com_sprintf (name2, sizeof (name2), "%s%s", dstdir, base);
+		SV_QueueSaveCopy (file->name, name2);
+	}
+
+	// and the ones already on disk
+	for (i = 0; i < 2; i++)
+	{
+		Com_sprintf (name, sizeof (name), "%s%s", srcdir, pattern[i]);
+		found = Sys_FindFirst (name, 0, 0);
+
+		while (found)
+		{
+			if (!SV_SaveFileQueued (dstdir, dstlen, found + srclen))
+			{
+				Com_sprintf (name2, sizeof (name2), "%s%s", dstdir, found + srclen);
+				SV_QueueSaveCopy (found, name2);
+			}
+
+			found = Sys_FindNext (0, 0);
+		}
+
+		Sys_FindClose ();
+	}
+
+	// remove level files that the source doesn't have
+	for (i = 0; i < 2; i++)
+	{
+		Com_sprintf (name, sizeof (name), "%s%s", dstdir, pattern[i]);
+		found = Sys_FindFirst (name, 0, 0);
+
+		while (found)
+		{
+			if (!SV_SaveFileQueued (dstdir, dstlen, found + dstlen))
+				SV_QueueSaveFile (found);
+
+			found = Sys_FindNext (0, 0);
+		}
+
+		Sys_FindClose ();
+	}
+
+	Com_sprintf (name, sizeof (name), "%sserver.ssv", srcdir);
+	Com_sprintf (name2, sizeof (name2), "%sserver.ssv", dstdir);
+	SV_QueueSaveCopy (name, name2);
+
+	SV_StartSaveGame ();
+}
+
+
+/*
+==============
+SV_WriteLevelFile
+
+Queues current/<map>.sv2 and has the game queue its .sav
+==============
+*/
+void SV_WriteLevelFile (void)
+{
+	char		name[MAX_OSPATH];
+	sizebuf_t	buf;
+	int			mark, size;
+
+	Com_DPrintf ("SV_WriteLevelFile()\n");
+
+	mark = Scratch_Mark ();
+	size = sizeof (sv.configstrings) + CM_PortalStateSize ();
+	SZ_Init (&buf, Scratch_Alloc (size), size);
+
+	SZ_Write (&buf, sv.configstrings, sizeof (sv.configstrings));
+	CM_WritePortalState (&buf);
+
+	Com_sprintf (name, sizeof (name), "%s/save/current/%s.sv2", FS_Gamedir(), sv.name);
+	SV_WriteSaveFile (name, buf.data, buf.cursize);
+	Scratch_Release (mark);
 
 	Com_sprintf (name, sizeof (name), "%s/save/current/%s.sav", FS_Gamedir(), sv.name);
 	ge->WriteLevel (name);
@@ -336,6 +712,8 @@ void SV_ReadLevelFile (void)
 
 	Com_DPrintf ("SV_ReadLevelFile()\n");
 
+	SV_WaitSaveGame ();
+
 	Com_sprintf (name, sizeof (name), "%s/save/current/%s.sv2", FS_Gamedir(), sv.name);
 	f = fopen (name, "rb");
 
@@ -357,28 +735,32 @@ void SV_ReadLevelFile (void)
 ==============
 SV_WriteServerFile
 
+Queues current/server.ssv and has the game queue game.ssv
 ==============
 */
 void SV_WriteServerFile (qboolean autosave)
 {
-	FILE	*f;
-	cvar_t	*var;
-	char	name[MAX_OSPATH], string[128];
-	char	comment[32];
-	time_t	aclock;
+	cvar_t		*var;
+	char		name[MAX_OSPATH], string[128];
+	char		comment[32];
+	time_t		aclock;
 	struct tm	*newtime;
+	sizebuf_t	buf;
+	int			mark, size;
 
 	Com_DPrintf ("SV_WriteServerFile(%s)\n", autosave ? "true" : "false");
 
-	Com_sprintf (name, sizeof (name), "%s/save/current/server.ssv", FS_Gamedir());
-	f = fopen (name, "wb");
+	size = sizeof (comment) + sizeof (svs.mapcmd);
 
-	if (!f)
+	for (var = cvar_vars; var; var = var->next)
 	{
-		Com_Printf ("Couldn't write %s\n", name);
-		return;
+		if (var->flags & CVAR_LATCH)
+			size += sizeof (name) + sizeof (string);
 	}
 
+	mark = Scratch_Mark ();
+	SZ_Init (&buf, Scratch_Alloc (size), size);
+
 	// write the comment field
 	memset (comment, 0, sizeof (comment));
 
@@ -395,10 +777,10 @@ void SV_WriteServerFile (qboolean autosave)
 		Com_sprintf (comment, sizeof (comment), "ENTERING %s", sv.configstrings[CS_NAME]);
 	}
 
-	fwrite (comment, 1, sizeof (comment), f);
+	SZ_Write (&buf, comment, sizeof (comment));
 
 	// write the mapcmd
-	fwrite (svs.mapcmd, 1, sizeof (svs.mapcmd), f);
+	SZ_Write (&buf, svs.mapcmd, sizeof (svs.mapcmd));
 
 	// write all CVAR_LATCH cvars
 	// these will be things like coop, skill, deathmatch, etc
@@ -418,11 +800,13 @@ void SV_WriteServerFile (qboolean autosave)
 		memset (string, 0, sizeof (string));
 		strcpy (name, var->name);
 		strcpy (string, var->string);
-		fwrite (name, 1, sizeof (name), f);
-		fwrite (string, 1, sizeof (string), f);
+		SZ_Write (&buf, name, sizeof (name));
+		SZ_Write (&buf, string, sizeof (string));
 	}
 
-	fclose (f);
+	Com_sprintf (name, sizeof (name), "%s/save/current/server.ssv", FS_Gamedir());
+	SV_WriteSaveFile (name, buf.data, buf.cursize);
+	Scratch_Release (mark);
 
 	// write game state
 	Com_sprintf (name, sizeof (name), "%s/save/current/game.ssv", FS_Gamedir());
@@ -444,6 +828,8 @@ void SV_ReadServerFile (void)
 
 	Com_DPrintf ("SV_ReadServerFile()\n");
 
+	SV_WaitSaveGame ();
+
 	Com_sprintf (name, sizeof (name), "%s/save/current/server.ssv", FS_Gamedir());
 	f = fopen (name, "rb");
 
@@ -561,6 +947,7 @@ void SV_GameMap_f (void)
 			}
 
 			SV_WriteLevelFile ();
+			SV_StartSaveGame ();
 
 			// we must restore these for clients to transfer over correctly
 			for (i = 0, cl = svs.clients; i < maxclients->value; i++, cl++)
@@ -580,7 +967,7 @@ void SV_GameMap_f (void)
 	if (!dedicated->value)
 	{
 		SV_WriteServerFile (true);
-		SV_CopySaveGame ("current", "save0");
+		SV_BackgroundCopySaveGame ("current", "save0", true);
 	}
 }
 
@@ -658,7 +1045,9 @@ void SV_Loadgame_f (void)
 		Com_Printf ("Bad savedir.\n");
 	}
 
-	// make sure the server.ssv file exists
+	// make sure the server.ssv file exists, once any save to it is done
+	SV_WaitSaveGame ();
+
 	Com_sprintf (name, sizeof (name), "%s/save/%s/server.ssv", FS_Gamedir(), Cmd_Argv (1));
 	f = fopen (name, "rb");
 
@@ -739,8 +1128,8 @@ void SV_Savegame_f (void)
 	// save server state
 	SV_WriteServerFile (false);
 
-	// copy it off
-	SV_CopySaveGame ("current", dir);
+	// copy it off; the save thread does the writing
+	SV_BackgroundCopySaveGame ("current", dir, false);
 
 	GL_MapShot_f (dir);
 
@@ -1109,6 +1498,7 @@ void SV_InitOperatorCommands (void)
 	Cmd_AddCommand ("load", SV_Loadgame_f);
 
 	Cmd_AddCommand ("killserver", SV_KillServer_f);
+	Cmd_AddCommand ("entscanbench", SV_EntScanBench_f);
 
 	Cmd_AddCommand ("sv", SV_ServerCommand_f);
 }
@@ -889,10 +889,11 @@ CM_BoxLeafnums
 Fills in a list of all the leafs touched
 =============
 */
-int		leaf_count, leaf_maxcount;
-int		*leaf_list;
-float	*leaf_mins, *leaf_maxs;
-int		leaf_topnode;
+// per thread, so the server can trace from worker threads
+THREAD_LOCAL int	leaf_count, leaf_maxcount;
+THREAD_LOCAL int	*leaf_list;
+THREAD_LOCAL float	*leaf_mins, *leaf_maxs;
+THREAD_LOCAL int	leaf_topnode;
 
 void CM_BoxLeafnums_r (int nodenum)
 {
@@ -1026,13 +1027,15 @@ BOX TRACING
 // 1/32 epsilon to keep floating point happy
 #define	DIST_EPSILON	(0.03125)
 
-vec3_t	trace_start, trace_end;
-vec3_t	trace_mins, trace_maxs;
-vec3_t	trace_extents;
+// per thread, so the server can trace from worker threads
+THREAD_LOCAL vec3_t		trace_start, trace_end;
+THREAD_LOCAL vec3_t		trace_mins, trace_maxs;
+THREAD_LOCAL vec3_t		trace_extents;
 
-trace_t	trace_trace;
-int		trace_contents;
-qboolean	trace_ispoint;		// optimized case
+THREAD_LOCAL trace_t	trace_trace;
+THREAD_LOCAL int		trace_contents;
+THREAD_LOCAL qboolean	trace_ispoint;		// optimized case
+THREAD_LOCAL int		trace_checkcount;
 
 /*
 ================
@@ -1240,10 +1243,10 @@ void CM_TraceToLeaf (int leafnum)
 		brushnum = map_leafbrushes[leaf->firstleafbrush+k];
 		b = &map_brushes[brushnum];
 
-		if (b->checkcount == checkcount)
+		if (b->checkcount == trace_checkcount)
 			continue;	// already checked this brush in another leaf
 
-		b->checkcount = checkcount;
+		b->checkcount = trace_checkcount;
 
 		if (!(b->contents & trace_contents))
 			continue;
@@ -1280,10 +1283,10 @@ void CM_TestInLeaf (int leafnum)
 		brushnum = map_leafbrushes[leaf->firstleafbrush+k];
 		b = &map_brushes[brushnum];
 
-		if (b->checkcount == checkcount)
+		if (b->checkcount == trace_checkcount)
 			continue;	// already checked this brush in another leaf
 
-		b->checkcount = checkcount;
+		b->checkcount = trace_checkcount;
 
 		if (!(b->contents & trace_contents))
 			continue;
@@ -1438,7 +1441,9 @@ trace_t		CM_BoxTrace (vec3_t start, vec3_t end,
 {
 	int		i;
 
-	checkcount++;		// for multi-check avoidance
+	// for multi-check avoidance; every trace gets its own count, so
+	// concurrent traces can at worst test a brush twice
+	trace_checkcount = Sys_AtomicAdd (&checkcount, 1) + 1;
 
 	c_traces++;			// for statistics, may be zeroed
 
@@ -1815,16 +1820,28 @@ int CM_WriteAreaBits (byte *buffer, int area)
 }
 
 
+/*
+===================
+CM_PortalStateSize
+
+Bytes CM_WritePortalState will add
+===================
+*/
+int		CM_PortalStateSize (void)
+{
+	return sizeof (portalopen);
+}
+
 /*
 ===================
 CM_WritePortalState
 
-Writes the portal state to a savegame file
+Writes the portal state to a savegame buffer
 ===================
 */
-void	CM_WritePortalState (FILE *f)
+void	CM_WritePortalState (sizebuf_t *buf)
 {
-	fwrite (portalopen, sizeof (portalopen), 1, f);
+	SZ_Write (buf, portalopen, sizeof (portalopen));
 }
 
 /*
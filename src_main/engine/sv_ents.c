@@ -487,6 +487,11 @@ Build a client frame structure
 
 byte		fatpvs[65536/8];	// 32767 is MAX_MAP_LEAFS
 
+// SV_BuildClientFrame loops over every edict rather than the linked bits
+// once more than MUL / DIV of them are linked
+#define	SV_LINKED_DENSE_MUL		3
+#define	SV_LINKED_DENSE_DIV		4
+
 /*
 ============
 SV_FatPVS
@@ -540,6 +545,137 @@ void SV_FatPVS (vec3_t org)
 }
 
 
+/*
+=============
+SV_AddFrameEntity
+
+Adds edict e to the client's frame if it can be seen or heard from org
+=============
+*/
+static void SV_AddFrameEntity (client_t *client, client_frame_t *frame, int e, vec3_t org,
+							   int clientarea, byte *clientphs, qboolean clientonly)
+{
+	int		i, l;
+	edict_t	*ent;
+	edict_t	*clent;
+	entity_state_t	*state;
+	byte	*bitvector;
+
+	clent = client->edict;
+	ent = EDICT_NUM (e);
+
+	// ignore ents without visible models
+	if (ent->svflags & SVF_NOCLIENT)
+		return;
+
+	// ignore ents without visible models unless they have an effect
+	if (!ent->s.modelindex && !ent->s.effects && !ent->s.sound && !ent->s.event)
+	{
+		// freed edicts drop out of the linked set until relinked
+		if (!ent->inuse)
+			sv.linkedbits[e >> 5] &= ~(1u << (e & 31));
+
+		return;
+	}
+
+	// if we're only sending the client (i.e. we overflowed on last try) then we must skip other ents
+	if (ent != clent && clientonly) return;
+
+	// ignore if not touching a PV leaf
+	if (ent != clent)
+	{
+		// check area
+		if (!CM_AreasConnected (clientarea, ent->areanum))
+		{
+			// doors can legally straddle two areas, so
+			// we may need to check another one
+			if (!ent->areanum2
+					|| !CM_AreasConnected (clientarea, ent->areanum2))
+				return;		// blocked by a door
+		}
+
+		// beams just check one point for PHS
+		if (ent->s.renderfx & RF_BEAM)
+		{
+			l = ent->clusternums[0];
+
+			if (!(clientphs[l >> 3] & (1 << (l & 7))))
+				return;
+		}
+		else
+		{
+			// FIXME: if an ent has a model and a sound, but isn't
+			// in the PVS, only the PHS, clear the model
+			if (ent->s.sound)
+			{
+				bitvector = fatpvs;	//clientphs;
+			}
+			else
+				bitvector = fatpvs;
+
+			if (ent->num_clusters == -1)
+			{
+				// too many leafs for individual check, go by headnode
+				if (!CM_HeadnodeVisible (ent->headnode, bitvector))
+					return;
+			}
+			else
+			{
+				// check individual leafs
+				for (i = 0; i < ent->num_clusters; i++)
+				{
+					l = ent->clusternums[i];
+
+					if (bitvector[l >> 3] & (1 << (l & 7)))
+						break;
+				}
+
+				if (i == ent->num_clusters)
+					return;		// not visible
+			}
+
+			if (!ent->s.modelindex)
+			{
+				// don't send sounds if they will be attenuated away
+				vec3_t	delta;
+				float	len;
+
+				VectorSubtract (org, ent->s.origin, delta);
+				len = VectorLength (delta);
+
+				if (len > 400)
+					return;
+			}
+		}
+	}
+
+#if 0
+
+	if (SV_AddProjectileUpdate (ent))
+		return; // added as a special projectile
+
+#endif
+
+	// add it to the circular client_entities array
+	state = &svs.client_entities[svs.next_client_entities%svs.num_client_entities];
+
+	if (ent->s.number != e)
+	{
+		Com_DPrintf ("FIXING ENT->S.NUMBER!!!\n");
+		ent->s.number = e;
+	}
+
+	*state = ent->s;
+
+	// don't mark players missiles as solid
+	if (ent->owner == client->edict)
+		state->solid = 0;
+
+	svs.next_client_entities++;
+	frame->num_entities++;
+}
+
+
 /*
 =============
 SV_BuildClientFrame
@@ -552,16 +688,14 @@ void SV_BuildClientFrame (client_t *client, qboolean clientonly)
 {
 	int		e, i;
 	vec3_t	org;
-	edict_t	*ent;
 	edict_t	*clent;
 	client_frame_t	*frame;
-	entity_state_t	*state;
-	int		l;
 	int		clientarea, clientcluster;
 	int		leafnum;
-	int		c_fullsend;
 	byte	*clientphs;
-	byte	*bitvector;
+	unsigned	linked[MAX_EDICTS / 32];
+	unsigned	bits;
+	int		w, numwords, numlinked, numedicts;
 
 	clent = client->edict;
 
@@ -598,117 +732,47 @@ void SV_BuildClientFrame (client_t *client, qboolean clientonly)
 	frame->num_entities = 0;
 	frame->first_entity = svs.next_client_entities;
 
-	c_fullsend = 0;
+	// only edicts that have been linked can be visible, but the client's
+	// own entity is always considered
+	memcpy (linked, sv.linkedbits, sizeof (linked));
+	e = NUM_FOR_EDICT (clent);
 
-	for (e = 1; e < ge->num_edicts; e++)
-	{
-		ent = EDICT_NUM (e);
+	if (e < MAX_EDICTS)
+		linked[e >> 5] |= 1u << (e & 31);
 
-		// ignore ents without visible models
-		if (ent->svflags & SVF_NOCLIENT)
-			continue;
+	numedicts = min (ge->num_edicts, MAX_EDICTS);
+	numwords = (numedicts + 31) >> 5;
 
-		// ignore ents without visible models unless they have an effect
-		if (!ent->s.modelindex && !ent->s.effects && !ent->s.sound && !ent->s.event)
-			continue;
+	// walking the bits only pays off when there are gaps to skip; with
+	// nearly every edict linked the straight loop is faster (entscanbench)
+	if (sv_entscan->value != 2)
+	{
+		numlinked = 0;
 
-		// if we're only sending the client (i.e. we overflowed on last try) then we must skip other ents
-		if (ent != clent && clientonly) continue;
+		for (w = 0; w < numwords && sv_entscan->value != 1; w++)
+			for (bits = linked[w]; bits; bits &= bits - 1)
+				numlinked++;
 
-		// ignore if not touching a PV leaf
-		if (ent != clent)
+		if (sv_entscan->value == 1 || numlinked * SV_LINKED_DENSE_DIV > numedicts * SV_LINKED_DENSE_MUL)
 		{
-			// check area
-			if (!CM_AreasConnected (clientarea, ent->areanum))
-			{
-				// doors can legally straddle two areas, so
-				// we may need to check another one
-				if (!ent->areanum2
-						|| !CM_AreasConnected (clientarea, ent->areanum2))
-					continue;		// blocked by a door
-			}
-
-			// beams just check one point for PHS
-			if (ent->s.renderfx & RF_BEAM)
-			{
-				l = ent->clusternums[0];
-
-				if (!(clientphs[l >> 3] & (1 << (l & 7))))
-					continue;
-			}
-			else
-			{
-				// FIXME: if an ent has a model and a sound, but isn't
-				// in the PVS, only the PHS, clear the model
-				if (ent->s.sound)
-				{
-					bitvector = fatpvs;	//clientphs;
-				}
-				else
-					bitvector = fatpvs;
-
-				if (ent->num_clusters == -1)
-				{
-					// too many leafs for individual check, go by headnode
-					if (!CM_HeadnodeVisible (ent->headnode, bitvector))
-						continue;
-
-					c_fullsend++;
-				}
-				else
-				{
-					// check individual leafs
-					for (i = 0; i < ent->num_clusters; i++)
-					{
-						l = ent->clusternums[i];
-
-						if (bitvector[l >> 3] & (1 << (l & 7)))
-							break;
-					}
+			for (e = 1; e < ge->num_edicts; e++)
+				SV_AddFrameEntity (client, frame, e, org, clientarea, clientphs, clientonly);
 
-					if (i == ent->num_clusters)
-						continue;		// not visible
-				}
-
-				if (!ent->s.modelindex)
-				{
-					// don't send sounds if they will be attenuated away
-					vec3_t	delta;
-					float	len;
-
-					VectorSubtract (org, ent->s.origin, delta);
-					len = VectorLength (delta);
-
-					if (len > 400)
-						continue;
-				}
-			}
+			return;
 		}
+	}
 
-#if 0
-
-		if (SV_AddProjectileUpdate (ent))
-			continue; // added as a special projectile
-
-#endif
-
-		// add it to the circular client_entities array
-		state = &svs.client_entities[svs.next_client_entities%svs.num_client_entities];
-
-		if (ent->s.number != e)
+	for (w = 0; w < numwords; w++)
+	{
+		for (bits = linked[w]; bits; bits &= bits - 1)
 		{
-			Com_DPrintf ("FIXING ENT->S.NUMBER!!!\n");
-			ent->s.number = e;
-		}
+			e = (w << 5) + Q_LowestBit (bits);
 
-		*state = ent->s;
+			if (e == 0 || e >= ge->num_edicts)
+				continue;
 
-		// don't mark players missiles as solid
-		if (ent->owner == client->edict)
-			state->solid = 0;
-
-		svs.next_client_entities++;
-		frame->num_entities++;
+			SV_AddFrameEntity (client, frame, e, org, clientarea, clientphs, clientonly);
+		}
 	}
 }
 
@@ -770,3 +834,80 @@ void SV_RecordDemoMessage (void)
 	fwrite (buf.data, buf.cursize, 1, svs.demofile);
 }
 
+
+/*
+=============
+SV_EntScanBench_f
+
+Times SV_BuildClientFrame for every client in the level as it stands,
+with the linear edict loop and with the linked bits, so the two can be
+compared on real maps
+=============
+*/
+void SV_EntScanBench_f (void)
+{
+	client_t	*cl;
+	client_frame_t	saved;
+	int			i, n, mode, count, oldnext, numlinked, numinuse;
+	unsigned	bits, start, times[2];
+	char		oldscan[16];
+
+	if (sv.state != ss_game)
+	{
+		Com_Printf ("You must be in a level to benchmark.\n");
+		return;
+	}
+
+	count = (Cmd_Argc () > 1) ? atoi (Cmd_Argv (1)) : 1000;
+
+	if (count < 1)
+		count = 1;
+
+	numlinked = numinuse = 0;
+
+	for (i = 1; i < ge->num_edicts; i++)
+	{
+		if (EDICT_NUM (i)->inuse)
+			numinuse++;
+	}
+
+	for (i = 0; i < MAX_EDICTS / 32; i++)
+		for (bits = sv.linkedbits[i]; bits; bits &= bits - 1)
+			numlinked++;
+
+	Q_strlcpy (oldscan, sv_entscan->string, sizeof (oldscan));
+	oldnext = svs.next_client_entities;
+
+	for (mode = 0; mode < 2; mode++)
+	{
+		Cvar_Set ("sv_entscan", mode ? "2" : "1");
+		times[mode] = 0;
+
+		for (i = 0, cl = svs.clients; i < maxclients->value; i++, cl++)
+		{
+			if (cl->state != cs_spawned)
+				continue;
+
+			// the frame already built for this server frame may be acked
+			// and used as a delta base later, so put it back afterwards
+			saved = cl->frames[sv.framenum & UPDATE_MASK];
+			start = Sys_Microseconds ();
+
+			for (n = 0; n < count; n++)
+			{
+				svs.next_client_entities = oldnext;
+				SV_BuildClientFrame (cl, false);
+			}
+
+			times[mode] += Sys_Microseconds () - start;
+			cl->frames[sv.framenum & UPDATE_MASK] = saved;
+		}
+	}
+
+	svs.next_client_entities = oldnext;
+	Cvar_Set ("sv_entscan", oldscan);
+
+	Com_Printf ("%i edicts, %i in use, %i linked\n", ge->num_edicts, numinuse, numlinked);
+	Com_Printf ("linear %.2f usec, linked bits %.2f usec per frame\n",
+		(float) times[0] / count, (float) times[1] / count);
+}
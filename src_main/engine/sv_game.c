@@ -394,6 +394,9 @@ void SV_InitGameProgs (void)
 	import.DebugGraph = SCR_DebugGraph;
 	import.SetAreaPortalState = CM_SetAreaPortalState;
 	import.AreasConnected = CM_AreasConnected;
+	import.ParallelFor = Job_ParallelFor;
+	import.Microseconds = Sys_Microseconds;
+	import.WriteSaveFile = SV_WriteSaveFile;
 
 	ge = (game_export_t *) Sys_GetGameAPI (&import);
 
@@ -130,6 +130,9 @@ void SV_CheckForSavegame (void)
 	if (Cvar_VariableValue ("deathmatch"))
 		return;
 
+	// the level file may still be on its way to disk
+	SV_WaitSaveGame ();
+
 	Com_sprintf (name, sizeof (name), "%s/save/current/%s.sav", FS_Gamedir(), sv.name);
 	f = fopen (name, "rb");
 
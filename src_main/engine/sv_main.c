@@ -28,6 +28,7 @@ cvar_t	*sv_paused;
 cvar_t	*sv_timedemo;
 
 cvar_t	*sv_enforcetime;
+cvar_t	*sv_entscan;
 
 cvar_t	*timeout;				// seconds without any message
 cvar_t	*zombietime;			// seconds to sink messages after disconnect
@@ -999,6 +1000,7 @@ void SV_Init (void)
 	sv_paused = Cvar_Get ("paused", "0", 0);
 	sv_timedemo = Cvar_Get ("timedemo", "0", 0);
 	sv_enforcetime = Cvar_Get ("sv_enforcetime", "0", 0);
+	sv_entscan = Cvar_Get ("sv_entscan", "0", 0);
 	allow_download = Cvar_Get ("allow_download", "1", CVAR_ARCHIVE);
 	allow_download_players = Cvar_Get ("allow_download_players", "0", CVAR_ARCHIVE);
 	allow_download_models = Cvar_Get ("allow_download_models", "1", CVAR_ARCHIVE);
@@ -1065,6 +1067,9 @@ before Sys_Quit or Sys_Error
 */
 void SV_Shutdown (char *finalmsg, qboolean reconnect)
 {
+	// let a pending autosave finish before the game goes away
+	SV_WaitSaveGame ();
+
 	if (svs.clients)
 		SV_FinalMessage (finalmsg, reconnect);
 
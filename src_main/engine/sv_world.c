@@ -53,10 +53,14 @@ typedef struct areanode_s
 areanode_t	sv_areanodes[AREA_NODES];
 int			sv_numareanodes;
 
-float	*area_mins, *area_maxs;
-edict_t	**area_list;
-int		area_count, area_maxcount;
-int		area_type;
+// kept on the caller's stack so area queries can run on worker threads
+typedef struct
+{
+	float	*mins, *maxs;
+	edict_t	**list;
+	int		count, maxcount;
+	int		type;
+} areaquery_t;
 
 int SV_HullForEntity (edict_t *ent);
 
@@ -137,6 +141,7 @@ SV_ClearWorld
 void SV_ClearWorld (void)
 {
 	memset (sv_areanodes, 0, sizeof (sv_areanodes));
+	memset (sv.linkedbits, 0, sizeof (sv.linkedbits));
 	sv_numareanodes = 0;
 	SV_CreateAreaNode (0, sv.models[1]->mins, sv.models[1]->maxs);
 }
@@ -180,6 +185,11 @@ void SV_LinkEdict (edict_t *ent)
 	if (ent == ge->edicts) return;		// don't add the world
 	if (!ent->inuse) return;
 
+	i = NUM_FOR_EDICT (ent);
+
+	if (i < MAX_EDICTS)
+		sv.linkedbits[i >> 5] |= 1u << (i & 31);
+
 	// set the size
 	VectorSubtract (ent->maxs, ent->mins, ent->size);
 
@@ -350,7 +360,7 @@ SV_AreaEdicts_r
 
 ====================
 */
-void SV_AreaEdicts_r (areanode_t *node)
+void SV_AreaEdicts_r (areanode_t *node, areaquery_t *q)
 {
 	link_t		*l, *next, *start;
 	edict_t		*check;
@@ -359,7 +369,7 @@ void SV_AreaEdicts_r (areanode_t *node)
 	count = 0;
 
 	// touch linked edicts
-	if (area_type == AREA_SOLID)
+	if (q->type == AREA_SOLID)
 		start = &node->solid_edicts;
 	else start = &node->trigger_edicts;
 
@@ -371,30 +381,30 @@ void SV_AreaEdicts_r (areanode_t *node)
 		if (check->solid == SOLID_NOT)
 			continue;		// deactivated
 
-		if (check->absmin[0] > area_maxs[0]
-				|| check->absmin[1] > area_maxs[1]
-				|| check->absmin[2] > area_maxs[2]
-				|| check->absmax[0] < area_mins[0]
-				|| check->absmax[1] < area_mins[1]
-				|| check->absmax[2] < area_mins[2])
+		if (check->absmin[0] > q->maxs[0]
+				|| check->absmin[1] > q->maxs[1]
+				|| check->absmin[2] > q->maxs[2]
+				|| check->absmax[0] < q->mins[0]
+				|| check->absmax[1] < q->mins[1]
+				|| check->absmax[2] < q->mins[2])
 			continue;		// not touching
 
-		if (area_count == area_maxcount)
+		if (q->count == q->maxcount)
 		{
 			Com_Printf ("SV_AreaEdicts: MAXCOUNT\n");
 			return;
 		}
 
-		area_list[area_count] = check;
-		area_count++;
+		q->list[q->count] = check;
+		q->count++;
 	}
 
 	if (node->axis == -1)
 		return;		// terminal node
 
 	// recurse down both sides
-	if (area_maxs[node->axis] > node->dist) SV_AreaEdicts_r (node->children[0]);
-	if (area_mins[node->axis] < node->dist) SV_AreaEdicts_r (node->children[1]);
+	if (q->maxs[node->axis] > node->dist) SV_AreaEdicts_r (node->children[0], q);
+	if (q->mins[node->axis] < node->dist) SV_AreaEdicts_r (node->children[1], q);
 }
 
 
@@ -406,16 +416,18 @@ SV_AreaEdicts
 int SV_AreaEdicts (vec3_t mins, vec3_t maxs, edict_t **list,
 				  int maxcount, int areatype)
 {
-	area_mins = mins;
-	area_maxs = maxs;
-	area_list = list;
-	area_count = 0;
-	area_maxcount = maxcount;
-	area_type = areatype;
+	areaquery_t	q;
 
-	SV_AreaEdicts_r (sv_areanodes);
+	q.mins = mins;
+	q.maxs = maxs;
+	q.list = list;
+	q.count = 0;
+	q.maxcount = maxcount;
+	q.type = areatype;
 
-	return area_count;
+	SV_AreaEdicts_r (sv_areanodes, &q);
+
+	return q.count;
 }
 
 
@@ -542,6 +554,11 @@ void SV_ClipMoveToEntities (moveclip_t *clip)
 		if (!(clip->contentmask & CONTENTS_DEADMONSTER) && (touch->svflags & SVF_DEADMONSTER))
 			continue;
 
+		// the box hull is always CONTENTS_MONSTER, so it can't be hit;
+		// skipping it also keeps sight traces off the shared box hull
+		if (touch->solid != SOLID_BSP && !(clip->contentmask & CONTENTS_MONSTER))
+			continue;
+
 		// might intersect, so do an exact clip
 		headnode = SV_HullForEntity (touch);
 		angles = touch->s.angles;
@@ -79,6 +79,325 @@ void AI_SetSightClient (void)
 	}
 }
 
+
+/*
+==============================================================================
+
+SENSING
+
+With ai_parallel set, the sight traces monsters are most likely to ask
+for during the frame, to their enemy and to the sight client, are run up
+front on the engine's worker threads.  visible() only takes a sensed
+answer while it is exactly what its own trace would return: both eye
+points unchanged and no brush model linked or unlinked since the
+traces ran.  Anything else falls through to a fresh trace, so the
+results are the same as the serial code.
+
+==============================================================================
+*/
+
+#define	MAX_SENSE	2
+
+typedef struct
+{
+	int			stamp;			// ai_sensestamp when these were traced
+	int			count;
+	edict_t		*other[MAX_SENSE];
+	vec3_t		spot1;
+	vec3_t		spot2[MAX_SENSE];
+	qboolean	visible[MAX_SENSE];
+} aisense_t;
+
+static aisense_t	ai_sense[MAX_EDICTS];
+static edict_t		*ai_sensers[MAX_EDICTS];
+static int			ai_sensestamp;
+static qboolean		ai_sensevalid;
+
+static int			ai_worldserial;		// bumped whenever sight may have changed
+
+/*
+=================
+AI_SenseMonster
+
+Runs on a worker thread, so it may only read game state and trace
+=================
+*/
+static void AI_SenseMonster (int index, void *data)
+{
+	edict_t		*self = ai_sensers[index];
+	aisense_t	*sense = &ai_sense[self - g_edicts];
+	trace_t		trace;
+	int			i;
+
+	for (i = 0; i < sense->count; i++)
+	{
+		trace = gi.trace (sense->spot1, vec3_origin, vec3_origin, sense->spot2[i], self, MASK_OPAQUE);
+		sense->visible[i] = (trace.fraction == 1.0);
+	}
+}
+
+/*
+=================
+AI_SenseAdd
+=================
+*/
+static void AI_SenseAdd (aisense_t *sense, edict_t *other)
+{
+	int		i;
+
+	if (!other || !other->inuse)
+		return;
+
+	for (i = 0; i < sense->count; i++)
+		if (sense->other[i] == other)
+			return;
+
+	sense->other[sense->count] = other;
+	VectorCopy (other->s.origin, sense->spot2[sense->count]);
+	sense->spot2[sense->count][2] += other->viewheight;
+	sense->count++;
+}
+
+/*
+=================
+AI_SenseMonsters
+
+Called at the start of each frame, before any monster thinks
+=================
+*/
+void AI_SenseMonsters (void)
+{
+	edict_t		*self;
+	aisense_t	*sense;
+	int			i, count;
+
+	ai_sensevalid = false;
+
+	if (!ai_parallel->value)
+		return;
+
+	count = 0;
+	ai_sensestamp++;
+
+	for (i = game.maxclients + 1; i < globals.num_edicts && i < MAX_EDICTS; i++)
+	{
+		self = &g_edicts[i];
+
+		if (!self->inuse || !(self->svflags & SVF_MONSTER) || self->deadflag)
+			continue;
+
+		sense = &ai_sense[i];
+		sense->stamp = ai_sensestamp;
+		sense->count = 0;
+
+		VectorCopy (self->s.origin, sense->spot1);
+		sense->spot1[2] += self->viewheight;
+
+		AI_SenseAdd (sense, self->enemy);
+		AI_SenseAdd (sense, level.sight_client);
+
+		if (sense->count)
+			ai_sensers[count++] = self;
+	}
+
+	if (!count)
+		return;
+
+	gi.ParallelFor (AI_SenseMonster, count, NULL);
+
+	ai_sensevalid = true;
+}
+
+/*
+=================
+AI_WorldChanged
+
+Drops all sensed and cached sight; called on level changes and when an
+areaportal opens or closes
+=================
+*/
+void AI_WorldChanged (void)
+{
+	ai_sensevalid = false;
+	ai_worldserial++;
+}
+
+/*
+=================
+AI_SenseLinked
+
+Called whenever an edict is linked or unlinked; a brush model moving
+can change what every monster sees
+=================
+*/
+void AI_SenseLinked (edict_t *ent)
+{
+	if (ent->solid == SOLID_BSP || (ent->model && ent->model[0] == '*'))
+		AI_WorldChanged ();
+}
+
+/*
+=================
+AI_SenseDone
+
+Called at the end of each frame
+=================
+*/
+void AI_SenseDone (void)
+{
+	ai_sensevalid = false;
+}
+
+/*
+=================
+AI_Sensed
+
+Returns true with the sensed answer if there is one that still holds
+=================
+*/
+static qboolean AI_Sensed (edict_t *self, edict_t *other, vec3_t spot1, vec3_t spot2, qboolean *result)
+{
+	aisense_t	*sense;
+	int			i, n;
+
+	if (!ai_sensevalid)
+		return false;
+
+	n = self - g_edicts;
+
+	if (n < 0 || n >= MAX_EDICTS)
+		return false;
+
+	sense = &ai_sense[n];
+
+	if (sense->stamp != ai_sensestamp || !VectorCompare (sense->spot1, spot1))
+		return false;
+
+	for (i = 0; i < sense->count; i++)
+	{
+		if (sense->other[i] == other && VectorCompare (sense->spot2[i], spot2))
+		{
+			*result = sense->visible[i];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/*
+==============================================================================
+
+SIGHT CACHE
+
+visible() answers are kept for ai_sightcache seconds, keyed by the pair
+of edicts.  An answer is dropped as soon as either edict is relinked
+(its linkcount changes), a brush model moves or an areaportal changes
+state, and it is only used if both eye points are exactly the ones that
+were traced, so a hit returns what a fresh trace would.  This catches
+FindTarget, ai_run and the attack checks asking about the same pair
+several times in a frame, and monsters standing around watching a
+stationary player.
+
+==============================================================================
+*/
+
+#define	SIGHT_CACHE_SIZE	4096		// must be a power of two
+
+typedef struct
+{
+	edict_t		*self, *other;
+	int			selflink, otherlink;
+	int			worldserial;
+	float		time;
+	vec3_t		spot1, spot2;
+	qboolean	visible;
+} sightcache_t;
+
+static sightcache_t	sight_cache[SIGHT_CACHE_SIZE];
+
+static int			sight_checks;
+static int			sight_cached;
+static int			sight_sensed;
+static int			sight_traced;
+
+/*
+=================
+AI_SightSlot
+=================
+*/
+static sightcache_t *AI_SightSlot (edict_t *self, edict_t *other)
+{
+	unsigned	hash;
+
+	hash = (unsigned)(self - g_edicts) * 0x9e3779b1 + (unsigned)(other - g_edicts);
+	hash ^= hash >> 15;
+
+	return &sight_cache[hash & (SIGHT_CACHE_SIZE - 1)];
+}
+
+/*
+=================
+AI_SightCached
+=================
+*/
+static qboolean AI_SightCached (sightcache_t *c, edict_t *self, edict_t *other, vec3_t spot1, vec3_t spot2)
+{
+	if (c->self != self || c->other != other)
+		return false;
+	if (c->worldserial != ai_worldserial)
+		return false;
+	if (c->selflink != self->linkcount || c->otherlink != other->linkcount)
+		return false;
+	if (c->time > level.time || level.time - c->time >= ai_sightcache->value)
+		return false;
+
+	return VectorCompare (c->spot1, spot1) && VectorCompare (c->spot2, spot2);
+}
+
+/*
+=================
+AI_SightStore
+=================
+*/
+static void AI_SightStore (sightcache_t *c, edict_t *self, edict_t *other, vec3_t spot1, vec3_t spot2, qboolean visible)
+{
+	c->self = self;
+	c->other = other;
+	c->selflink = self->linkcount;
+	c->otherlink = other->linkcount;
+	c->worldserial = ai_worldserial;
+	c->time = level.time;
+	VectorCopy (spot1, c->spot1);
+	VectorCopy (spot2, c->spot2);
+	c->visible = visible;
+}
+
+/*
+=================
+Svcmd_SightStats_f
+
+"sv sightstats [reset]"
+=================
+*/
+void Svcmd_SightStats_f (void)
+{
+	int		avoided;
+
+	if (gi.argc () > 2 && !Q_stricmp (gi.argv (2), "reset"))
+	{
+		sight_checks = sight_cached = sight_sensed = sight_traced = 0;
+		return;
+	}
+
+	avoided = sight_cached + sight_sensed;
+
+	gi.cprintf (NULL, PRINT_HIGH, "%i sight checks: %i cached, %i sensed, %i traced (%i%% of traces avoided)\n",
+		sight_checks, sight_cached, sight_sensed, sight_traced,
+		sight_checks ? avoided * 100 / sight_checks : 0);
+}
+
 //============================================================================
 
 /*
@@ -323,6 +642,8 @@ qboolean visible (edict_t *self, edict_t *other)
 	vec3_t	spot1;
 	vec3_t	spot2;
 	trace_t	trace;
+	qboolean	sensed;
+	sightcache_t	*cache = NULL;
 
 	if (!self || !other)
 	{
@@ -333,11 +654,34 @@ qboolean visible (edict_t *self, edict_t *other)
 	spot1[2] += self->viewheight;
 	VectorCopy (other->s.origin, spot2);
 	spot2[2] += other->viewheight;
+
+	sight_checks++;
+
+	if (AI_Sensed (self, other, spot1, spot2, &sensed))
+	{
+		sight_sensed++;
+		return sensed;
+	}
+
+	if (ai_sightcache->value > 0)
+	{
+		cache = AI_SightSlot (self, other);
+
+		if (AI_SightCached (cache, self, other, spot1, spot2))
+		{
+			sight_cached++;
+			return cache->visible;
+		}
+	}
+
+	sight_traced++;
 	trace = gi.trace (spot1, vec3_origin, vec3_origin, spot2, self, MASK_OPAQUE);
-	
-	if (trace.fraction == 1.0)
-		return true;
-	return false;
+	sensed = (trace.fraction == 1.0);
+
+	if (cache)
+		AI_SightStore (cache, self, other, spot1, spot2, sensed);
+
+	return sensed;
 }
 
 
@@ -437,7 +781,7 @@ void FoundTarget (edict_t *self)
 	self->monsterinfo.aiflags |= AI_COMBAT_POINT;
 
 	// clear the targetname, that point is ours!
-	self->movetarget->targetname = NULL;
+	G_SetTargetname (self->movetarget, NULL);
 	self->monsterinfo.pausetime = 0;
 
 	// run for it
@@ -121,6 +121,7 @@ void Killed (edict_t *targ, edict_t *inflictor, edict_t *attacker, int damage, v
 
 	if (targ->movetype == MOVETYPE_PUSH || targ->movetype == MOVETYPE_STOP || targ->movetype == MOVETYPE_NONE)
 	{	// doors, triggers, etc
+		G_WakeForCallback (targ);
 		targ->die (targ, inflictor, attacker, damage, point);
 		return;
 	}
@@ -131,6 +132,7 @@ void Killed (edict_t *targ, edict_t *inflictor, edict_t *attacker, int damage, v
 		monster_death_use (targ);
 	}
 
+	G_WakeForCallback (targ);
 	targ->die (targ, inflictor, attacker, damage, point);
 }
 
@@ -535,6 +537,7 @@ void T_Damage (edict_t *targ, edict_t *inflictor, edict_t *attacker, vec3_t dir,
 		M_ReactToDamage (targ, attacker);
 		if (!(targ->monsterinfo.aiflags & AI_DUCKED) && (take))
 		{
+			G_WakeForCallback (targ);
 			targ->pain (targ, attacker, knockback, take);
 			// nightmare mode monsters don't go into pain frames often
 			if (skill->value == 3)
@@ -544,12 +547,18 @@ void T_Damage (edict_t *targ, edict_t *inflictor, edict_t *attacker, vec3_t dir,
 	else if (client)
 	{
 		if (!(targ->flags & FL_GODMODE) && (take))
+		{
+			G_WakeForCallback (targ);
 			targ->pain (targ, attacker, knockback, take);
+		}
 	}
 	else if (take)
 	{
 		if (targ->pain)
+		{
+			G_WakeForCallback (targ);
 			targ->pain (targ, attacker, knockback, take);
+		}
 	}
 
 	// add to the damage inflicted on a player this frame
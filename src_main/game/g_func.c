@@ -103,7 +103,7 @@ void Move_Final (edict_t *ent)
 	VectorScale (ent->moveinfo.dir, ent->moveinfo.remaining_distance / FRAMETIME, ent->velocity);
 
 	ent->think = Move_Done;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (ent, level.time + FRAMETIME);
 }
 
 void Move_Begin (edict_t *ent)
@@ -123,7 +123,7 @@ void Move_Begin (edict_t *ent)
 	VectorScale (ent->moveinfo.dir, ent->moveinfo.speed, ent->velocity);
 	frames = floor((ent->moveinfo.remaining_distance / ent->moveinfo.speed) / FRAMETIME);
 	ent->moveinfo.remaining_distance -= frames * ent->moveinfo.speed * FRAMETIME;
-	ent->nextthink = level.time + (frames * FRAMETIME);
+	G_SetNextThink (ent, level.time + (frames * FRAMETIME));
 	ent->think = Move_Final;
 }
 
@@ -147,7 +147,7 @@ void Move_Calc (edict_t *ent, vec3_t dest, void(*func)(edict_t*))
 		}
 		else
 		{
-			ent->nextthink = level.time + FRAMETIME;
+			G_SetNextThink (ent, level.time + FRAMETIME);
 			ent->think = Move_Begin;
 		}
 	}
@@ -156,7 +156,7 @@ void Move_Calc (edict_t *ent, vec3_t dest, void(*func)(edict_t*))
 		// accelerative
 		ent->moveinfo.current_speed = 0;
 		ent->think = Think_AccelMove;
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink (ent, level.time + FRAMETIME);
 	}
 }
 
@@ -199,7 +199,7 @@ void AngleMove_Final (edict_t *ent)
 	VectorScale (move, 1.0/FRAMETIME, ent->avelocity);
 
 	ent->think = AngleMove_Done;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (ent, level.time + FRAMETIME);
 }
 
 void AngleMove_Begin (edict_t *ent)
@@ -238,7 +238,7 @@ void AngleMove_Begin (edict_t *ent)
 	VectorScale (destdelta, 1.0 / traveltime, ent->avelocity);
 
 	// set nextthink to trigger a think when dest is reached
-	ent->nextthink = level.time + frames * FRAMETIME;
+	G_SetNextThink (ent, level.time + frames * FRAMETIME);
 	ent->think = AngleMove_Final;
 }
 
@@ -257,7 +257,7 @@ void AngleMove_Calc (edict_t *ent, void(*func)(edict_t*))
 	}
 	else
 	{
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink (ent, level.time + FRAMETIME);
 		ent->think = AngleMove_Begin;
 	}
 }
@@ -404,7 +404,7 @@ void Think_AccelMove (edict_t *ent)
 	}
 
 	VectorScale (ent->moveinfo.dir, ent->moveinfo.current_speed * 10, ent->velocity);
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (ent, level.time + FRAMETIME);
 	ent->think = Think_AccelMove;
 }
 
@@ -425,7 +425,7 @@ void plat_hit_top (edict_t *ent)
 	ent->moveinfo.state = STATE_TOP;
 
 	ent->think = plat_go_down;
-	ent->nextthink = level.time + 3;
+	G_SetNextThink (ent, level.time + 3);
 }
 
 void plat_hit_bottom (edict_t *ent)
@@ -538,7 +538,7 @@ void Touch_Plat_Center (edict_t *ent, edict_t *other, cplane_t *plane, csurface_
 	if (ent->moveinfo.state == STATE_BOTTOM)
 		plat_go_up (ent);
 	else if (ent->moveinfo.state == STATE_TOP)
-		ent->nextthink = level.time + 1;	// the player is still on the plat, so delay going down
+		G_SetNextThink (ent, level.time + 1);	// the player is still on the plat, so delay going down
 }
 
 void plat_spawn_inside_trigger (edict_t *ent)
@@ -856,7 +856,7 @@ void button_wait (edict_t *self)
 	self->s.frame = 1;
 	if (self->moveinfo.wait >= 0)
 	{
-		self->nextthink = level.time + self->moveinfo.wait;
+		G_SetNextThink (self, level.time + self->moveinfo.wait);
 		self->think = button_return;
 	}
 }
@@ -1030,6 +1030,7 @@ void door_use_areaportals (edict_t *self, qboolean open)
 		if (Q_stricmp(t->classname, "func_areaportal") == 0)
 		{
 			gi.SetAreaPortalState (t->style, open);
+			AI_WorldChanged ();
 		}
 	}
 }
@@ -1057,7 +1058,7 @@ void door_hit_top (edict_t *self)
 	if (self->moveinfo.wait >= 0)
 	{
 		self->think = door_go_down;
-		self->nextthink = level.time + self->moveinfo.wait;
+		G_SetNextThink (self, level.time + self->moveinfo.wait);
 	}
 }
 
@@ -1120,7 +1121,7 @@ void door_go_up (edict_t *self, edict_t *activator)
 	if (self->moveinfo.state == STATE_TOP)
 	{	// reset top wait time
 		if (self->moveinfo.wait >= 0)
-			self->nextthink = level.time + self->moveinfo.wait;
+			G_SetNextThink (self, level.time + self->moveinfo.wait);
 		return;
 	}
 	
@@ -1461,7 +1462,7 @@ void SP_func_door (edict_t *ent)
 
 	gi.linkentity (ent);
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (ent, level.time + FRAMETIME);
 	if (ent->health || ent->targetname)
 		ent->think = Think_CalcMoveSpeed;
 	else
@@ -1597,7 +1598,7 @@ void SP_func_door_rotating (edict_t *ent)
 
 	gi.linkentity (ent);
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (ent, level.time + FRAMETIME);
 	if (ent->health || ent->targetname)
 		ent->think = Think_CalcMoveSpeed;
 	else
@@ -1686,7 +1687,7 @@ void SP_func_water (edict_t *self)
 	if (self->wait == -1)
 		self->spawnflags |= DOOR_TOGGLE;
 
-	self->classname = "func_door";
+	G_SetClassname (self, "func_door");
 
 	gi.linkentity (self);
 }
@@ -1765,7 +1766,7 @@ void train_wait (edict_t *self)
 	{
 		if (self->moveinfo.wait > 0)
 		{
-			self->nextthink = level.time + self->moveinfo.wait;
+			G_SetNextThink (self, level.time + self->moveinfo.wait);
 			self->think = train_next;
 		}
 		else if (self->spawnflags & TRAIN_TOGGLE)  // && wait < 0
@@ -1773,7 +1774,7 @@ void train_wait (edict_t *self)
 			train_next (self);
 			self->spawnflags &= ~TRAIN_START_ON;
 			VectorClear (self->velocity);
-			self->nextthink = 0;
+			G_SetNextThink (self, 0);
 		}
 
 		if (!(self->flags & FL_TEAMSLAVE))
@@ -1904,7 +1905,7 @@ void func_train_find (edict_t *self)
 
 	if (self->spawnflags & TRAIN_START_ON)
 	{
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink (self, level.time + FRAMETIME);
 		self->think = train_next;
 		self->activator = self;
 	}
@@ -1925,7 +1926,7 @@ void train_use (edict_t *self, edict_t *other, edict_t *activator)
 			return;
 		self->spawnflags &= ~TRAIN_START_ON;
 		VectorClear (self->velocity);
-		self->nextthink = 0;
+		G_SetNextThink (self, 0);
 	}
 	else
 	{
@@ -1975,7 +1976,7 @@ void SP_func_train (edict_t *self)
 	{
 		// start trains on the second frame, to make sure their targets have had
 		// a chance to spawn
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink (self, level.time + FRAMETIME);
 		self->think = func_train_find;
 	}
 	else
@@ -2056,7 +2057,7 @@ void SP_trigger_elevator (edict_t *self)
 	}
 
 	self->think = trigger_elevator_init;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 }
 
 
@@ -2082,7 +2083,7 @@ void func_timer_think (edict_t *self)
 	}
 
 	G_UseTargets (self, self->activator);
-	self->nextthink = level.time + self->wait + crandom() * self->random;
+	G_SetNextThink (self, level.time + self->wait + crandom() * self->random);
 }
 
 void func_timer_use (edict_t *self, edict_t *other, edict_t *activator)
@@ -2097,13 +2098,13 @@ void func_timer_use (edict_t *self, edict_t *other, edict_t *activator)
 	// if on, turn it off
 	if (self->nextthink)
 	{
-		self->nextthink = 0;
+		G_SetNextThink (self, 0);
 		return;
 	}
 
 	// turn it on
 	if (self->delay)
-		self->nextthink = level.time + self->delay;
+		G_SetNextThink (self, level.time + self->delay);
 	else
 		func_timer_think (self);
 }
@@ -2129,7 +2130,7 @@ void SP_func_timer (edict_t *self)
 
 	if (self->spawnflags & 1)
 	{
-		self->nextthink = level.time + 1.0 + st.pausetime + self->delay + self->wait + crandom() * self->random;
+		G_SetNextThink (self, level.time + 1.0 + st.pausetime + self->delay + self->wait + crandom() * self->random);
 		self->activator = self;
 	}
 
@@ -2236,7 +2237,7 @@ void door_secret_move1 (edict_t *self)
 		return;
 	}
 
-	self->nextthink = level.time + 1.0;
+	G_SetNextThink (self, level.time + 1.0);
 	self->think = door_secret_move2;
 }
 
@@ -2259,7 +2260,7 @@ void door_secret_move3 (edict_t *self)
 
 	if (self->wait == -1)
 		return;
-	self->nextthink = level.time + self->wait;
+	G_SetNextThink (self, level.time + self->wait);
 	self->think = door_secret_move4;
 }
 
@@ -2280,7 +2281,7 @@ void door_secret_move5 (edict_t *self)
 		return;
 	}
 
-	self->nextthink = level.time + 1.0;
+	G_SetNextThink (self, level.time + 1.0);
 	self->think = door_secret_move6;
 }
 
@@ -2415,7 +2416,7 @@ void SP_func_door_secret (edict_t *ent)
 		ent->touch = door_touch;
 	}
 	
-	ent->classname = "func_door";
+	G_SetClassname (ent, "func_door");
 
 	gi.linkentity (ent);
 }
@@ -2439,7 +2440,7 @@ void use_killbox (edict_t *self, edict_t *other, edict_t *activator)
 	if (!self->count)
 	{
 		self->think = G_FreeEdict;
-		self->nextthink = level.time + 1;
+		G_SetNextThink (self, level.time + 1);
 	}
 }
 
@@ -167,7 +167,7 @@ void SetRespawn (edict_t *ent, float delay)
 	ent->flags |= FL_RESPAWN;
 	ent->svflags |= SVF_NOCLIENT;
 	ent->solid = SOLID_NOT;
-	ent->nextthink = level.time + delay;
+	G_SetNextThink (ent, level.time + delay);
 	ent->think = DoRespawn;
 	gi.linkentity (ent);
 }
@@ -637,7 +637,7 @@ void MegaHealth_think (edict_t *self)
 
 	if (self->owner->health > self->owner->max_health)
 	{
-		self->nextthink = level.time + 1;
+		G_SetNextThink (self, level.time + 1);
 		self->owner->health -= 1;
 		return;
 	}
@@ -670,7 +670,7 @@ qboolean Pickup_Health (edict_t *ent, edict_t *other)
 	if (ent->style & HEALTH_TIMED)
 	{
 		ent->think = MegaHealth_think;
-		ent->nextthink = level.time + 5;
+		G_SetNextThink (ent, level.time + 5);
 		ent->owner = other;
 		ent->flags |= FL_RESPAWN;
 		ent->svflags |= SVF_NOCLIENT;
@@ -981,7 +981,7 @@ static void drop_make_touchable (edict_t *ent)
 
 	if (deathmatch->value)
 	{
-		ent->nextthink = level.time + 29;
+		G_SetNextThink (ent, level.time + 29);
 		ent->think = G_FreeEdict;
 	}
 }
@@ -999,7 +999,7 @@ edict_t *Drop_Item (edict_t *ent, gitem_t *item)
 
 	dropped = G_Spawn();
 
-	dropped->classname = item->classname;
+	G_SetClassname (dropped, item->classname);
 	dropped->item = item;
 	dropped->spawnflags = DROPPED_ITEM;
 	dropped->s.effects = item->world_model_flags;
@@ -1043,7 +1043,7 @@ edict_t *Drop_Item (edict_t *ent, gitem_t *item)
 	dropped->velocity[2] = 300;
 
 	dropped->think = drop_make_touchable;
-	dropped->nextthink = level.time + 1;
+	G_SetNextThink (dropped, level.time + 1);
 
 	gi.linkentity (dropped);
 
@@ -1129,7 +1129,7 @@ void droptofloor (edict_t *ent)
 
 		if (ent == ent->teammaster)
 		{
-			ent->nextthink = level.time + FRAMETIME;
+			G_SetNextThink (ent, level.time + FRAMETIME);
 			ent->think = DoRespawn;
 		}
 	}
@@ -1298,7 +1298,7 @@ void SpawnItem (edict_t *ent, gitem_t *item)
 	}
 
 	ent->item = item;
-	ent->nextthink = level.time + 2 * FRAMETIME;    // items start after other solids
+	G_SetNextThink (ent, level.time + 2 * FRAMETIME);    // items start after other solids
 	ent->think = droptofloor;
 	ent->s.effects = item->world_model_flags;
 	ent->s.renderfx = RF_GLOW;
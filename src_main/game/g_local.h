@@ -398,6 +398,19 @@ typedef struct
 } moveinfo_t;
 
 
+// hash index links for G_Find, maintained in g_utils.c
+#define	FIND_CLASSNAME		0
+#define	FIND_TARGETNAME		1
+#define	FIND_NUMINDEXES		2
+
+typedef struct
+{
+	edict_t		*prev, *next;	// bucket chain, sorted by edict number
+	char		*name;			// string indexed under, NULL if not linked
+	int			bucket;
+} findlink_t;
+
+
 typedef struct
 {
 	void	(*aifunc)(edict_t *self, float dist);
@@ -506,6 +519,10 @@ extern	int	meansOfDeath;
 
 
 extern	edict_t			*g_edicts;
+extern	unsigned		*g_activebits;	// edicts that may be in use, see G_MarkActive
+extern	unsigned		*g_sleepbits;	// edicts waiting in the think queue
+extern	void			(*gi_linkentity) (edict_t *ent);
+extern	void			(*gi_unlinkentity) (edict_t *ent);
 
 #define	FOFS(x) (size_t)&(((edict_t *)0)->x)
 #define	STOFS(x) (size_t)&(((spawn_temp_t *)0)->x)
@@ -553,6 +570,12 @@ extern	cvar_t	*flood_waitdelay;
 
 extern	cvar_t	*sv_maplist;
 
+extern	cvar_t	*g_thinkqueue;
+extern	cvar_t	*g_thinkverify;
+
+extern	cvar_t	*ai_parallel;
+extern	cvar_t	*ai_sightcache;
+
 #define world	(&g_edicts[0])
 
 // item spawnflags
@@ -631,6 +654,23 @@ void Touch_Item (edict_t *ent, edict_t *other, cplane_t *plane, csurface_t *surf
 qboolean	KillBox (edict_t *ent);
 void	G_ProjectSource (vec3_t point, vec3_t distance, vec3_t forward, vec3_t right, vec3_t result);
 edict_t *G_Find (edict_t *from, int fieldofs, char *match);
+void	G_SetClassname (edict_t *ent, char *classname);
+void	G_SetTargetname (edict_t *ent, char *targetname);
+void	G_RelinkFind (edict_t *ent);
+void	G_UnlinkFind (edict_t *ent);
+void	G_ResetFindIndex (void);
+void	G_AllocActiveEdicts (void);
+void	G_MarkActive (edict_t *ent);
+void	G_ResetActiveEdicts (void);
+void	G_SleepEdict (edict_t *ent);
+void	G_WakeEdict (edict_t *ent);
+void	G_WakeThinkers (void);
+void	G_WakeForCallback (edict_t *ent);
+void	G_RecheckSleepers (void);
+qboolean	G_CanSleep (edict_t *ent);
+void	G_SetNextThink (edict_t *ent, float nextthink);
+void	G_LinkEntity (edict_t *ent);
+void	G_UnlinkEntity (edict_t *ent);
 edict_t *findradius (edict_t *from, vec3_t org, float rad);
 edict_t *G_PickTarget (char *targetname);
 void	G_UseTargets (edict_t *ent, edict_t *activator);
@@ -709,6 +749,11 @@ void BecomeExplosion1(edict_t *self);
 // g_ai.c
 //
 void AI_SetSightClient (void);
+void AI_SenseMonsters (void);
+void AI_SenseLinked (edict_t *ent);
+void AI_SenseDone (void);
+void AI_WorldChanged (void);
+void Svcmd_SightStats_f (void);
 
 void ai_stand (edict_t *self, float dist);
 void ai_move (edict_t *self, float dist);
@@ -1025,6 +1070,8 @@ struct edict_s
 	char		*combattarget;
 	edict_t		*target_ent;
 
+	findlink_t	findlinks[FIND_NUMINDEXES];	// classname / targetname index
+
 	float		speed, accel, decel;
 	vec3_t		movedir;
 	vec3_t		pos1, pos2;
@@ -75,6 +75,12 @@ cvar_t	*flood_waitdelay;
 
 cvar_t	*sv_maplist;
 
+cvar_t	*g_thinkqueue;
+cvar_t	*g_thinkverify;
+
+cvar_t	*ai_parallel;
+cvar_t	*ai_sightcache;
+
 cvar_t *gib_on;
 
 void SpawnEntities (char *mapname, char *entities, char *spawnpoint);
@@ -117,6 +123,13 @@ Q_DLL_EXPORT game_export_t *GetGameAPI (game_import_t *import)
 {
 	gi = *import;
 
+	// relinking an edict has to wake it from the think queue, and
+	// moving brush models makes sensed monster sight stale
+	gi_linkentity = gi.linkentity;
+	gi.linkentity = G_LinkEntity;
+	gi_unlinkentity = gi.unlinkentity;
+	gi.unlinkentity = G_UnlinkEntity;
+
 	globals.apiversion = GAME_API_VERSION;
 	globals.Init = InitGame;
 	globals.Shutdown = ShutdownGame;
@@ -212,7 +225,7 @@ edict_t *CreateTargetChangeLevel(char *map)
 	}
 
 	ent = G_Spawn ();
-	ent->classname = "target_changelevel";
+	G_SetClassname (ent, "target_changelevel");
 	Com_sprintf(level.nextmap, sizeof(level.nextmap), "%s", map);
 	ent->map = level.nextmap;
 	return ent;
@@ -395,7 +408,12 @@ Advances the world by 0.1 seconds
 void G_RunFrame (void)
 {
 	int		i;
+	unsigned	bits;
 	edict_t	*ent;
+	qboolean	asleep;
+	vec3_t	origin, angles, velocity;
+	float	nextthink;
+	int		movetype, frame;
 
 	level.framenum++;
 	level.time = level.framenum*FRAMETIME;
@@ -411,15 +429,56 @@ void G_RunFrame (void)
 		return;
 	}
 
+	// wake anything in the think queue that is due this frame
+	G_WakeThinkers ();
+
+	// run the monster sight traces up front
+	AI_SenseMonsters ();
+
 	//
 	// treat each object in turn
 	// even the world gets a chance to think
 	//
-	ent = &g_edicts[0];
-	for (i=0 ; i<globals.num_edicts ; i++, ent++)
+	for (i=0 ; i<globals.num_edicts ; i++)
 	{
+		// skip straight to the next edict that may be in use and isn't
+		// asleep; the bits are reread every time so anything spawned or
+		// woken this frame still runs
+		bits = g_activebits[i >> 5];
+		if (!g_thinkverify->value)
+			bits &= ~g_sleepbits[i >> 5];
+		bits >>= i & 31;
+		if (!bits)
+		{
+			i |= 31;
+			continue;
+		}
+
+		i += Q_LowestBit (bits);
+		if (i >= globals.num_edicts)
+			break;
+
+		ent = &g_edicts[i];
+
 		if (!ent->inuse)
+		{
+			g_activebits[i >> 5] &= ~(1u << (i & 31));
 			continue;
+		}
+
+		// only visited with g_thinkverify set; it is run the way the full
+		// scan would, and reported below if that did anything
+		asleep = (g_sleepbits[i >> 5] & (1u << (i & 31))) != 0;
+
+		if (asleep)
+		{
+			VectorCopy (ent->s.origin, origin);
+			VectorCopy (ent->s.angles, angles);
+			VectorCopy (ent->velocity, velocity);
+			nextthink = ent->nextthink;
+			movetype = ent->movetype;
+			frame = ent->s.frame;
+		}
 
 		level.current_entity = ent;
 
@@ -442,8 +501,29 @@ void G_RunFrame (void)
 		}
 
 		G_RunEntity (ent);
+
+		if (asleep)
+		{
+			if (ent->inuse && VectorCompare (ent->s.origin, origin) && VectorCompare (ent->s.angles, angles)
+				&& VectorCompare (ent->velocity, velocity) && ent->nextthink == nextthink
+				&& ent->movetype == movetype && ent->s.frame == frame)
+				continue;
+
+			gi.dprintf ("think queue: %s (%i) moved or thought while asleep\n", ent->classname, i);
+			G_WakeEdict (ent);
+		}
+
+		// nothing to do until the next think, so drop out of the loop
+		if (g_thinkqueue->value && G_CanSleep (ent)
+			&& !(ent->nextthink > 0 && ent->nextthink <= level.time + FRAMETIME + 0.001))
+			G_SleepEdict (ent);
 	}
 
+	// callbacks may have handed work to edicts that are asleep
+	G_RecheckSleepers ();
+
+	AI_SenseDone ();
+
 	// see if it is time to end a deathmatch
 	CheckDMRules ();
 
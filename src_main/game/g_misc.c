@@ -40,6 +40,7 @@ void Use_Areaportal (edict_t *ent, edict_t *other, edict_t *activator)
 	ent->count ^= 1;		// toggle state
 //	gi.dprintf ("portalstate: %i = %i\n", ent->style, ent->count);
 	gi.SetAreaPortalState (ent->style, ent->count);
+	AI_WorldChanged ();
 }
 
 /*QUAKED func_areaportal (0 0 0) ?
@@ -114,12 +115,12 @@ void gib_think (edict_t *self)
 	}
 
 	self->s.frame++;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 
 	if (self->s.frame == 10)
 	{
 		self->think = G_FreeEdict;
-		self->nextthink = level.time + 8 + random()*10;
+		G_SetNextThink (self, level.time + 8 + random()*10);
 	}
 }
 
@@ -149,7 +150,7 @@ void gib_touch (edict_t *self, edict_t *other, cplane_t *plane, csurface_t *surf
 		{
 			self->s.frame++;
 			self->think = gib_think;
-			self->nextthink = level.time + FRAMETIME;
+			G_SetNextThink (self, level.time + FRAMETIME);
 		}
 	}
 }
@@ -225,7 +226,7 @@ void ThrowGib (edict_t *self, char *gibname, int damage, int type)
 	gib->avelocity[2] = random()*600;
 
 	gib->think = G_FreeEdict;
-	gib->nextthink = level.time + 10 + random()*10;
+	G_SetNextThink (gib, level.time + 10 + random()*10);
 
 	gi.linkentity (gib);
 }
@@ -254,7 +255,7 @@ void ThrowHead (edict_t *self, char *gibname, int damage, int type)
 	self->flags |= FL_NO_KNOCKBACK;
 	self->svflags &= ~SVF_MONSTER;
 	self->takedamage = DAMAGE_YES;
-	self->targetname = NULL;
+	G_SetTargetname (self, NULL);
 	self->die = gib_die;
 
 	if (type == GIB_ORGANIC)
@@ -276,7 +277,7 @@ void ThrowHead (edict_t *self, char *gibname, int damage, int type)
 	self->avelocity[YAW] = crandom()*600;
 
 	self->think = G_FreeEdict;
-	self->nextthink = level.time + 10 + random()*10;
+	G_SetNextThink (self, level.time + 10 + random()*10);
 
 	gi.linkentity (self);
 }
@@ -327,7 +328,7 @@ void ThrowClientHead (edict_t *self, int damage)
 	else
 	{
 		self->think = NULL;
-		self->nextthink = 0;
+		G_SetNextThink (self, 0);
 	}
 
 	gi.linkentity (self);
@@ -385,10 +386,10 @@ void ThrowDebris (edict_t *self, char *modelname, float speed, vec3_t origin)
 	chunk->avelocity[1] = random()*600;
 	chunk->avelocity[2] = random()*600;
 	chunk->think = G_FreeEdict;
-	chunk->nextthink = level.time + 5 + random()*5;
+	G_SetNextThink (chunk, level.time + 5 + random()*5);
 	chunk->s.frame = 0;
 	chunk->flags = 0;
-	chunk->classname = "debris";
+	G_SetClassname (chunk, "debris");
 	chunk->takedamage = DAMAGE_YES;
 	chunk->die = debris_die;
 	gi.linkentity (chunk);
@@ -614,7 +615,7 @@ void TH_viewthing(edict_t *ent)
 	}
 
 	ent->s.frame = (ent->s.frame + 1) % 7;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (ent, level.time + FRAMETIME);
 }
 
 void SP_viewthing(edict_t *ent)
@@ -633,7 +634,7 @@ void SP_viewthing(edict_t *ent)
 	Vector3Set (ent->maxs, 16, 16, 32);
 	ent->s.modelindex = gi.modelindex ("models/objects/banner/tris.md2");
 	gi.linkentity (ent);
-	ent->nextthink = level.time + 0.5;
+	G_SetNextThink (ent, level.time + 0.5);
 	ent->think = TH_viewthing;
 	return;
 }
@@ -887,7 +888,7 @@ void SP_func_object (edict_t *self)
 		self->solid = SOLID_BSP;
 		self->movetype = MOVETYPE_PUSH;
 		self->think = func_object_release;
-		self->nextthink = level.time + 2 * FRAMETIME;
+		G_SetNextThink (self, level.time + 2 * FRAMETIME);
 	}
 	else
 	{
@@ -1170,7 +1171,7 @@ void barrel_delay (edict_t *self, edict_t *inflictor, edict_t *attacker, int dam
 	}
 
 	self->takedamage = DAMAGE_NO;
-	self->nextthink = level.time + 2 * FRAMETIME;
+	G_SetNextThink (self, level.time + 2 * FRAMETIME);
 	self->think = barrel_explode;
 	self->activator = attacker;
 }
@@ -1215,7 +1216,7 @@ void SP_misc_explobox (edict_t *self)
 	self->touch = barrel_touch;
 
 	self->think = M_droptofloor;
-	self->nextthink = level.time + 2 * FRAMETIME;
+	G_SetNextThink (self, level.time + 2 * FRAMETIME);
 
 	gi.linkentity (self);
 }
@@ -1253,11 +1254,11 @@ void misc_blackhole_think (edict_t *self)
 	}
 
 	if (++self->s.frame < 19)
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink (self, level.time + FRAMETIME);
 	else
 	{		
 		self->s.frame = 0;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink (self, level.time + FRAMETIME);
 	}
 }
 
@@ -1285,7 +1286,7 @@ void SP_misc_blackhole (edict_t *ent)
 	ent->use = misc_blackhole_use;
 	ent->think = misc_blackhole_think;
     ent->prethink = misc_blackhole_transparent;
-	ent->nextthink = level.time + 2 * FRAMETIME;
+	G_SetNextThink (ent, level.time + 2 * FRAMETIME);
 	gi.linkentity (ent);
 }
 
@@ -1302,9 +1303,9 @@ void commander_body_think (edict_t *self)
 	}
 
 	if (++self->s.frame < 24)
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink (self, level.time + FRAMETIME);
 	else
-		self->nextthink = 0;
+		G_SetNextThink (self, 0);
 
 	if (self->s.frame == 22)
 		gi.sound (self, CHAN_BODY, gi.soundindex ("tank/thud.wav"), 1, ATTN_NORM, 0);
@@ -1318,7 +1319,7 @@ void commander_body_use (edict_t *self, edict_t *other, edict_t *activator)
 	}
 
 	self->think = commander_body_think;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 	gi.sound (self, CHAN_BODY, gi.soundindex ("tank/pain.wav"), 1, ATTN_NORM, 0);
 }
 
@@ -1356,7 +1357,7 @@ void SP_monster_commander_body (edict_t *self)
 	gi.soundindex ("tank/pain.wav");
 
 	self->think = commander_body_drop;
-	self->nextthink = level.time + 5 * FRAMETIME;
+	G_SetNextThink (self, level.time + 5 * FRAMETIME);
 }
 
 
@@ -1372,7 +1373,7 @@ void misc_banner_think (edict_t *ent)
 	}
 
 	ent->s.frame = (ent->s.frame + 1) % 16;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (ent, level.time + FRAMETIME);
 }
 
 void SP_misc_banner (edict_t *ent)
@@ -1389,7 +1390,7 @@ void SP_misc_banner (edict_t *ent)
 	gi.linkentity (ent);
 
 	ent->think = misc_banner_think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (ent, level.time + FRAMETIME);
 }
 
 /*QUAKED misc_deadsoldier (1 .5 0) (-16 -16 0) (16 16 16) ON_BACK ON_STOMACH BACK_DECAP FETAL_POS SIT_DECAP IMPALED
@@ -1503,7 +1504,7 @@ void SP_misc_viper (edict_t *ent)
 	Vector3Set (ent->maxs, 16, 16, 32);
 
 	ent->think = func_train_find;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (ent, level.time + FRAMETIME);
 	ent->use = misc_viper_use;
 	ent->svflags |= SVF_NOCLIENT;
 	ent->moveinfo.accel = ent->moveinfo.decel = ent->moveinfo.speed = ent->speed;
@@ -1663,7 +1664,7 @@ void SP_misc_strogg_ship (edict_t *ent)
 	Vector3Set (ent->maxs, 16, 16, 32);
 
 	ent->think = func_train_find;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (ent, level.time + FRAMETIME);
 	ent->use = misc_strogg_ship_use;
 	ent->svflags |= SVF_NOCLIENT;
 	ent->moveinfo.accel = ent->moveinfo.decel = ent->moveinfo.speed = ent->speed;
@@ -1684,7 +1685,7 @@ void misc_satellite_dish_think (edict_t *self)
 	self->s.frame++;
 
 	if (self->s.frame < 38)
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink (self, level.time + FRAMETIME);
 }
 
 void misc_satellite_dish_use (edict_t *self, edict_t *other, edict_t *activator)
@@ -1696,7 +1697,7 @@ void misc_satellite_dish_use (edict_t *self, edict_t *other, edict_t *activator)
 
 	self->s.frame = 0;
 	self->think = misc_satellite_dish_think;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 }
 
 void SP_misc_satellite_dish (edict_t *ent)
@@ -1770,7 +1771,7 @@ void SP_misc_gib_arm (edict_t *ent)
 	ent->avelocity[1] = random()*200;
 	ent->avelocity[2] = random()*200;
 	ent->think = G_FreeEdict;
-	ent->nextthink = level.time + 30;
+	G_SetNextThink (ent, level.time + 30);
 	gi.linkentity (ent);
 }
 
@@ -1796,7 +1797,7 @@ void SP_misc_gib_leg (edict_t *ent)
 	ent->avelocity[1] = random()*200;
 	ent->avelocity[2] = random()*200;
 	ent->think = G_FreeEdict;
-	ent->nextthink = level.time + 30;
+	G_SetNextThink (ent, level.time + 30);
 	gi.linkentity (ent);
 }
 
@@ -1822,7 +1823,7 @@ void SP_misc_gib_head (edict_t *ent)
 	ent->avelocity[1] = random()*200;
 	ent->avelocity[2] = random()*200;
 	ent->think = G_FreeEdict;
-	ent->nextthink = level.time + 30;
+	G_SetNextThink (ent, level.time + 30);
 	gi.linkentity (ent);
 }
 
@@ -1999,6 +2000,7 @@ void func_clock_think (edict_t *self)
 	}
 
 	self->enemy->message = self->message;
+	G_WakeForCallback (self->enemy);
 	self->enemy->use (self->enemy, self, self);
 
 	if (((self->spawnflags & 1) && (self->health > self->wait)) ||
@@ -2021,7 +2023,7 @@ void func_clock_think (edict_t *self)
 		if (!(self->spawnflags & 8))
 		{
 			self->think = G_FreeEdict;
-			self->nextthink = level.time + 1;
+			G_SetNextThink (self, level.time + 1);
 			return;
 		}
 
@@ -2031,7 +2033,7 @@ void func_clock_think (edict_t *self)
 			return;
 	}
 
-	self->nextthink = level.time + 1;
+	G_SetNextThink (self, level.time + 1);
 }
 
 void func_clock_use (edict_t *self, edict_t *other, edict_t *activator)
@@ -2082,7 +2084,7 @@ void SP_func_clock (edict_t *self)
 	if (self->spawnflags & 4)
 		self->use = func_clock_use;
 	else
-		self->nextthink = level.time + 1;
+		G_SetNextThink (self, level.time + 1);
 }
 
 //=================================================================================
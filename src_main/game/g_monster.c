@@ -162,7 +162,7 @@ static void M_FliesOn (edict_t *self)
 	self->s.effects |= EF_FLIES;
 	self->s.sound = gi.soundindex ("infantry/inflies1.wav");
 	self->think = M_FliesOff;
-	self->nextthink = level.time + 60;
+	G_SetNextThink (self, level.time + 60);
 }
 
 void M_FlyCheck (edict_t *self)
@@ -179,7 +179,7 @@ void M_FlyCheck (edict_t *self)
 		return;
 
 	self->think = M_FliesOn;
-	self->nextthink = level.time + 5 + 10 * random();
+	G_SetNextThink (self, level.time + 5 + 10 * random());
 }
 
 void AttackFinished (edict_t *self, float time)
@@ -445,7 +445,7 @@ void M_MoveFrame (edict_t *self)
 	}
 
 	move = self->monsterinfo.currentmove;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 
 	if ((self->monsterinfo.nextframe) && (self->monsterinfo.nextframe >= move->firstframe) && (self->monsterinfo.nextframe <= move->lastframe))
 	{
@@ -587,7 +587,7 @@ void monster_triggered_spawn_use (edict_t *self, edict_t *other, edict_t *activa
 
 	// we have a one frame delay here so we don't telefrag the guy who activated us
 	self->think = monster_triggered_spawn;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 	if (activator->client)
 		self->enemy = activator;
 	self->use = monster_use;
@@ -603,7 +603,7 @@ void monster_triggered_start (edict_t *self)
 	self->solid = SOLID_NOT;
 	self->movetype = MOVETYPE_NONE;
 	self->svflags |= SVF_NOCLIENT;
-	self->nextthink = 0;
+	G_SetNextThink (self, 0);
 	self->use = monster_triggered_spawn_use;
 }
 
@@ -666,7 +666,7 @@ qboolean monster_start (edict_t *self)
 	if (!(self->monsterinfo.aiflags & AI_GOOD_GUY))
 		level.total_monsters++;
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 	self->svflags |= SVF_MONSTER;
 	self->s.renderfx |= RF_FRAMELERP;
 	self->takedamage = DAMAGE_AIM;
@@ -791,7 +791,7 @@ void monster_start_go (edict_t *self)
 	}
 
 	self->think = monster_think;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 }
 
 
@@ -120,7 +120,7 @@ qboolean SV_RunThink (edict_t *ent)
 	if (thinktime > level.time+0.001)
 		return true;
 	
-	ent->nextthink = 0;
+	G_SetNextThink (ent, 0);
 	if (!ent->think)
 		gi.error ("NULL ent->think");
 	ent->think (ent);
@@ -148,10 +148,16 @@ void SV_Impact (edict_t *e1, trace_t *trace)
 	e2 = trace->ent;
 
 	if (e1->touch && (e1->solid != SOLID_NOT))
+	{
+		G_WakeForCallback (e1);
 		e1->touch (e1, e2, &trace->plane, trace->surface);
+	}
 	
 	if (e2->touch && (e2->solid != SOLID_NOT))
+	{
+		G_WakeForCallback (e2);
 		e2->touch (e2, e1, NULL, NULL);
+	}
 }
 
 
@@ -547,9 +553,52 @@ typedef struct
 	vec3_t	angles;
 	float	deltayaw;
 } pushed_t;
-pushed_t	pushed[MAX_EDICTS], *pushed_p;
 
-edict_t	*obstacle;
+// everything a pusher team has moved this frame, so a blocked
+// move can be backed out
+typedef struct
+{
+	pushed_t	pushed[MAX_EDICTS];
+	pushed_t	*top;
+	edict_t		*obstacle;
+} pushstack_t;
+
+static pushstack_t	team_push;		// reused by every team
+
+static edict_t	*push_list[MAX_EDICTS];
+
+static int PushSort (void const *a, void const *b)
+{
+	edict_t	*e1 = *(edict_t **)a;
+	edict_t	*e2 = *(edict_t **)b;
+
+	if (e1 < e2)
+		return -1;
+	if (e1 > e2)
+		return 1;
+	return 0;
+}
+
+/*
+============
+SV_PushCandidates
+
+Gathers the edicts touching a pusher's swept bounds into push_list.
+They are sorted into edict order so pushes resolve the same way as
+a scan over every edict would.
+============
+*/
+static int SV_PushCandidates (vec3_t mins, vec3_t maxs)
+{
+	int		count;
+
+	count = gi.BoxEdicts (mins, maxs, push_list, MAX_EDICTS, AREA_SOLID);
+	count += gi.BoxEdicts (mins, maxs, push_list + count, MAX_EDICTS - count, AREA_TRIGGERS);
+
+	qsort (push_list, count, sizeof(push_list[0]), PushSort);
+
+	return count;
+}
 
 /*
 ============
@@ -557,15 +606,19 @@ SV_Push
 
 Objects need to be moved back on a failed push,
 otherwise riders would continue to slide.
+
+Only edicts touching the pusher's swept bounds are considered; anything
+standing on the pusher touches its bounds before the move.
 ============
 */
-qboolean SV_Push (edict_t *pusher, vec3_t move, vec3_t amove)
+static qboolean SV_Push (edict_t *pusher, vec3_t move, vec3_t amove, pushstack_t *stack)
 {
-	int			i, e;
+	int			i, e, count;
 	edict_t		*check, *block;
 	pushed_t	*p;
 	vec3_t		org, org2, move2, forward, right, up;
 	vec3_t realmins, realmaxs;
+	vec3_t		sweptmins, sweptmaxs;
 
 	if (!pusher)
 	{
@@ -591,12 +644,15 @@ qboolean SV_Push (edict_t *pusher, vec3_t move, vec3_t amove)
 	AngleVectors (org, forward, right, up);
 
 // save the pusher's original position
-	pushed_p->ent = pusher;
-	VectorCopy (pusher->s.origin, pushed_p->origin);
-	VectorCopy (pusher->s.angles, pushed_p->angles);
+	stack->top->ent = pusher;
+	VectorCopy (pusher->s.origin, stack->top->origin);
+	VectorCopy (pusher->s.angles, stack->top->angles);
 	if (pusher->client)
-		pushed_p->deltayaw = pusher->client->ps.pmove.delta_angles[YAW];
-	pushed_p++;
+		stack->top->deltayaw = pusher->client->ps.pmove.delta_angles[YAW];
+	stack->top++;
+
+	VectorCopy (pusher->absmin, sweptmins);
+	VectorCopy (pusher->absmax, sweptmaxs);
 
 // move the pusher to it's final position
 	VectorAdd (pusher->s.origin, move, pusher->s.origin);
@@ -606,10 +662,21 @@ qboolean SV_Push (edict_t *pusher, vec3_t move, vec3_t amove)
 	// create a real bounding box for rotating brush models
 	RealBoundingBox(pusher,realmins,realmaxs);
 
+	for (i=0 ; i<3 ; i++)
+	{
+		if (realmins[i] < sweptmins[i])
+			sweptmins[i] = realmins[i];
+		if (realmaxs[i] > sweptmaxs[i])
+			sweptmaxs[i] = realmaxs[i];
+	}
+
+	count = SV_PushCandidates (sweptmins, sweptmaxs);
+
 // see if any solid entities are inside the final position
-	check = g_edicts+1;
-	for (e = 1; e < globals.num_edicts; e++, check++)
+	for (e = 0; e < count; e++)
 	{
+		check = push_list[e];
+
 		if (!check->inuse)
 			continue;
 		if (check->movetype == MOVETYPE_PUSH
@@ -641,10 +708,10 @@ qboolean SV_Push (edict_t *pusher, vec3_t move, vec3_t amove)
 		if ((pusher->movetype == MOVETYPE_PUSH) || (check->groundentity == pusher))
 		{
 			// move this entity
-			pushed_p->ent = check;
-			VectorCopy (check->s.origin, pushed_p->origin);
-			VectorCopy (check->s.angles, pushed_p->angles);
-			pushed_p++;
+			stack->top->ent = check;
+			VectorCopy (check->s.origin, stack->top->origin);
+			VectorCopy (check->s.angles, stack->top->angles);
+			stack->top++;
 
 			// try moving the contacted entity 
 			VectorAdd (check->s.origin, move, check->s.origin);
@@ -680,18 +747,18 @@ qboolean SV_Push (edict_t *pusher, vec3_t move, vec3_t amove)
 			block = SV_TestEntityPosition (check);
 			if (!block)
 			{
-				pushed_p--;
+				stack->top--;
 				continue;
 			}
 		}
 		
 		// save off the obstacle so we can call the block function
-		obstacle = check;
+		stack->obstacle = check;
 
 		// move back any entities we already moved
 		// go backwards, so if the same entity was pushed
 		// twice, it goes back to the original position
-		for (p=pushed_p-1 ; p>=pushed ; p--)
+		for (p=stack->top-1 ; p>=stack->pushed ; p--)
 		{
 			VectorCopy (p->origin, p->ent->s.origin);
 			VectorCopy (p->angles, p->ent->s.angles);
@@ -706,7 +773,7 @@ qboolean SV_Push (edict_t *pusher, vec3_t move, vec3_t amove)
 
 //FIXME: is there a better way to handle this?
 	// see if anything we moved has touched a trigger
-	for (p=pushed_p-1 ; p>=pushed ; p--)
+	for (p=stack->top-1 ; p>=stack->pushed ; p--)
 		G_TouchTriggers (p->ent);
 
 	return true;
@@ -737,7 +804,8 @@ void SV_Physics_Pusher (edict_t *ent)
 	// make sure all team slaves can move before commiting
 	// any moves or calling any think functions
 	// if the move is blocked, all moved objects will be backed out
-	pushed_p = pushed;
+	team_push.top = team_push.pushed;
+	team_push.obstacle = NULL;
 	for (part = ent ; part ; part=part->teamchain)
 	{
 		if (part->velocity[0] || part->velocity[1] || part->velocity[2] ||
@@ -747,12 +815,12 @@ void SV_Physics_Pusher (edict_t *ent)
 			VectorScale (part->velocity, FRAMETIME, move);
 			VectorScale (part->avelocity, FRAMETIME, amove);
 
-			if (!SV_Push (part, move, amove))
+			if (!SV_Push (part, move, amove, &team_push))
 				break;	// move was blocked
 		}
 	}
-	if (pushed_p > &pushed[MAX_EDICTS])
-		gi.error (ERR_FATAL, "pushed_p > &pushed[MAX_EDICTS], memory corrupted");
+	if (team_push.top > &team_push.pushed[MAX_EDICTS])
+		gi.error (ERR_FATAL, "SV_Physics_Pusher: push stack overflow, memory corrupted");
 
 	if (part)
 	{
@@ -760,13 +828,16 @@ void SV_Physics_Pusher (edict_t *ent)
 		for (mv = ent ; mv ; mv=mv->teamchain)
 		{
 			if (mv->nextthink > 0)
-				mv->nextthink += FRAMETIME;
+				G_SetNextThink (mv, mv->nextthink + FRAMETIME);
 		}
 
 		// if the pusher has a "blocked" function, call it
 		// otherwise, just stay in place until the obstacle is gone
 		if (part->blocked)
-			part->blocked (part, obstacle);
+		{
+			G_WakeForCallback (part);
+			part->blocked (part, team_push.obstacle);
+		}
 	}
 	else
 	{
@@ -126,6 +126,20 @@ typedef struct
 	mmove_t *mmovePtr;
 } mmoveList_t;
 
+/*
+ * Savegames are built up in memory
+ * and handed to the engine to write,
+ * and loaded by reading the whole
+ * file before parsing it.
+ */
+typedef struct
+{
+	byte	*data;
+	int		cursize;
+	int		maxsize;
+	int		readcount;
+} savebuf_t;
+
 //=========================================================
 
 /*
@@ -249,6 +263,16 @@ void InitGame (void)
 	// dm map list
 	sv_maplist = gi.cvar ("sv_maplist", "", 0);
 
+	// think scheduling
+	g_thinkqueue = gi.cvar ("g_thinkqueue", "1", 0);
+	g_thinkverify = gi.cvar ("g_thinkverify", "0", 0);
+
+	// monster sight traces on the worker threads
+	ai_parallel = gi.cvar ("ai_parallel", "0", 0);
+
+	// seconds to keep monster sight answers, 0 = always trace
+	ai_sightcache = gi.cvar ("ai_sightcache", "0.5", 0);
+
 	// items
 	InitItems ();
 
@@ -258,6 +282,7 @@ void InitGame (void)
 	// initialize all entities for this game
 	game.maxentities = maxentities->value;
 	g_edicts = (edict_t *) gi.TagMalloc (game.maxentities * sizeof(g_edicts[0]), TAG_GAME);
+	G_AllocActiveEdicts ();
 	globals.edicts = g_edicts;
 	globals.max_edicts = game.maxentities;
 
@@ -265,10 +290,123 @@ void InitGame (void)
 	game.maxclients = maxclients->value;
 	game.clients = (gclient_t *) gi.TagMalloc (game.maxclients * sizeof(game.clients[0]), TAG_GAME);
 	globals.num_edicts = game.maxclients+1;
+
+	G_ResetFindIndex ();
+	G_ResetActiveEdicts ();
 }
 
 //=========================================================
 
+/*
+ * Function and mmove lookups go
+ * through hash tables built the
+ * first time they are needed. Each
+ * slot holds a list index + 1, so
+ * zero marks an empty slot. Where
+ * a name or address appears twice
+ * the first entry wins, like the
+ * linear searches did.
+ */
+#define SAVE_HASH_SIZE 2048	// power of two, at least twice the table sizes
+
+static short funcByAddress[SAVE_HASH_SIZE];
+static short funcByName[SAVE_HASH_SIZE];
+static short mmoveByAddress[SAVE_HASH_SIZE];
+static short mmoveByName[SAVE_HASH_SIZE];
+static qboolean saveHashBuilt;
+
+static unsigned PointerHash(void *p)
+{
+	size_t v = (size_t)p;
+
+	v ^= v >> 16;
+	v *= 0x45d9f3b;
+	v ^= v >> 16;
+
+	return (unsigned)v & (SAVE_HASH_SIZE - 1);
+}
+
+static void BuildSaveHash(void)
+{
+	unsigned h;
+	int i;
+
+	if (saveHashBuilt)
+	{
+		return;
+	}
+
+	for (i = 0; functionList[i].funcStr; i++)
+	{
+		if (i + 1 >= SAVE_HASH_SIZE / 2)
+		{
+			gi.error ("BuildSaveHash: too many functions");
+		}
+
+		for (h = PointerHash(functionList[i].funcPtr); funcByAddress[h]; h = (h + 1) & (SAVE_HASH_SIZE - 1))
+		{
+			if (functionList[funcByAddress[h] - 1].funcPtr == functionList[i].funcPtr)
+			{
+				break;
+			}
+		}
+
+		if (!funcByAddress[h])
+		{
+			funcByAddress[h] = i + 1;
+		}
+
+		for (h = Com_HashKey(functionList[i].funcStr, SAVE_HASH_SIZE); funcByName[h]; h = (h + 1) & (SAVE_HASH_SIZE - 1))
+		{
+			if (!strcmp(functionList[funcByName[h] - 1].funcStr, functionList[i].funcStr))
+			{
+				break;
+			}
+		}
+
+		if (!funcByName[h])
+		{
+			funcByName[h] = i + 1;
+		}
+	}
+
+	for (i = 0; mmoveList[i].mmoveStr; i++)
+	{
+		if (i + 1 >= SAVE_HASH_SIZE / 2)
+		{
+			gi.error ("BuildSaveHash: too many mmoves");
+		}
+
+		for (h = PointerHash(mmoveList[i].mmovePtr); mmoveByAddress[h]; h = (h + 1) & (SAVE_HASH_SIZE - 1))
+		{
+			if (mmoveList[mmoveByAddress[h] - 1].mmovePtr == mmoveList[i].mmovePtr)
+			{
+				break;
+			}
+		}
+
+		if (!mmoveByAddress[h])
+		{
+			mmoveByAddress[h] = i + 1;
+		}
+
+		for (h = Com_HashKey(mmoveList[i].mmoveStr, SAVE_HASH_SIZE); mmoveByName[h]; h = (h + 1) & (SAVE_HASH_SIZE - 1))
+		{
+			if (!strcmp(mmoveList[mmoveByName[h] - 1].mmoveStr, mmoveList[i].mmoveStr))
+			{
+				break;
+			}
+		}
+
+		if (!mmoveByName[h])
+		{
+			mmoveByName[h] = i + 1;
+		}
+	}
+
+	saveHashBuilt = true;
+}
+
 /*
  * Helper function to get
  * the human readable function
@@ -278,13 +416,15 @@ void InitGame (void)
  */
 functionList_t *GetFunctionByAddress(byte *adr)
 {
-	int i;
+	unsigned h;
 
-	for (i = 0; functionList[i].funcStr; i++)
+	BuildSaveHash();
+
+	for (h = PointerHash(adr); funcByAddress[h]; h = (h + 1) & (SAVE_HASH_SIZE - 1))
 	{
-		if (functionList[i].funcPtr == adr)
+		if (functionList[funcByAddress[h] - 1].funcPtr == adr)
 		{
-			return &functionList[i];
+			return &functionList[funcByAddress[h] - 1];
 		}
 	}
 
@@ -300,13 +440,15 @@ functionList_t *GetFunctionByAddress(byte *adr)
  */
 byte *FindFunctionByName(char *name)
 {
-	int i;
+	unsigned h;
 
-	for (i = 0; functionList[i].funcStr; i++)
+	BuildSaveHash();
+
+	for (h = Com_HashKey(name, SAVE_HASH_SIZE); funcByName[h]; h = (h + 1) & (SAVE_HASH_SIZE - 1))
 	{
-		if (!strcmp(name, functionList[i].funcStr))
+		if (!strcmp(name, functionList[funcByName[h] - 1].funcStr))
 		{
-			return functionList[i].funcPtr;
+			return functionList[funcByName[h] - 1].funcPtr;
 		}
 	}
 
@@ -320,13 +462,15 @@ byte *FindFunctionByName(char *name)
  */
 mmoveList_t *GetMmoveByAddress(mmove_t *adr)
 {
-	int i;
+	unsigned h;
 
-	for (i = 0; mmoveList[i].mmoveStr; i++)
+	BuildSaveHash();
+
+	for (h = PointerHash(adr); mmoveByAddress[h]; h = (h + 1) & (SAVE_HASH_SIZE - 1))
 	{
-		if (mmoveList[i].mmovePtr == adr)
+		if (mmoveList[mmoveByAddress[h] - 1].mmovePtr == adr)
 		{
-			return &mmoveList[i];
+			return &mmoveList[mmoveByAddress[h] - 1];
 		}
 	}
 
@@ -340,19 +484,116 @@ mmoveList_t *GetMmoveByAddress(mmove_t *adr)
  */
 mmove_t *FindMmoveByName(char *name)
 {
-	int i;
+	unsigned h;
 
-	for (i = 0; mmoveList[i].mmoveStr; i++)
+	BuildSaveHash();
+
+	for (h = Com_HashKey(name, SAVE_HASH_SIZE); mmoveByName[h]; h = (h + 1) & (SAVE_HASH_SIZE - 1))
 	{
-		if (!strcmp(name, mmoveList[i].mmoveStr))
+		if (!strcmp(name, mmoveList[mmoveByName[h] - 1].mmoveStr))
 		{
-			return mmoveList[i].mmovePtr;
+			return mmoveList[mmoveByName[h] - 1].mmovePtr;
 		}
 	}
 
 	return NULL;
 }
 
+//=========================================================
+
+/*
+ * Save buffer handling. The buffer
+ * is kept between saves so that
+ * autosaves don't have to grow it
+ * again every level.
+ */
+
+static savebuf_t savebuf;
+
+static void SaveBuf_Clear(savebuf_t *buf)
+{
+	buf->cursize = 0;
+	buf->readcount = 0;
+}
+
+static void SaveBuf_Write(savebuf_t *buf, void *data, int len)
+{
+	if (buf->cursize + len > buf->maxsize)
+	{
+		int newsize = buf->maxsize ? buf->maxsize : 0x40000;
+
+		while (buf->cursize + len > newsize)
+		{
+			newsize *= 2;
+		}
+
+		buf->data = realloc(buf->data, newsize);
+		if (!buf->data)
+		{
+			gi.error ("SaveBuf_Write: failed to allocate %i bytes", newsize);
+		}
+
+		buf->maxsize = newsize;
+	}
+
+	memcpy(buf->data + buf->cursize, data, len);
+	buf->cursize += len;
+}
+
+static void SaveBuf_WriteFile(savebuf_t *buf, char *filename)
+{
+	// the engine copies the buffer and writes it on its save thread
+	gi.WriteSaveFile (filename, buf->data, buf->cursize);
+}
+
+static void SaveBuf_Read(savebuf_t *buf, void *data, int len)
+{
+	if (buf->readcount + len > buf->cursize)
+	{
+		gi.error ("Savegame is truncated");
+	}
+
+	memcpy(data, buf->data + buf->readcount, len);
+	buf->readcount += len;
+}
+
+static void SaveBuf_ReadFile(savebuf_t *buf, char *filename)
+{
+	FILE *f;
+	long len;
+
+	f = fopen (filename, "rb");
+	if (!f)
+		gi.error ("Couldn't open %s", filename);
+
+	fseek (f, 0, SEEK_END);
+	len = ftell (f);
+	fseek (f, 0, SEEK_SET);
+
+	SaveBuf_Clear(buf);
+
+	if (len > buf->maxsize)
+	{
+		buf->data = realloc(buf->data, len);
+		if (!buf->data)
+		{
+			fclose (f);
+			gi.error ("SaveBuf_ReadFile: failed to allocate %i bytes", (int)len);
+		}
+
+		buf->maxsize = len;
+	}
+
+	if (len <= 0 || fread (buf->data, 1, len, f) != len)
+	{
+		fclose (f);
+		gi.error ("Couldn't read %s", filename);
+	}
+
+	fclose (f);
+	buf->cursize = len;
+}
+
 
 //=========================================================
 
@@ -363,7 +604,7 @@ mmove_t *FindMmoveByName(char *name)
  * below this block into files.
  */
 
-void WriteField1 (FILE *f, field_t *field, byte *base)
+void WriteField1 (savebuf_t *f, field_t *field, byte *base)
 {
 	void		*p;
 	int			len;
@@ -460,7 +701,7 @@ void WriteField1 (FILE *f, field_t *field, byte *base)
 }
 
 
-void WriteField2 (FILE *f, field_t *field, byte *base)
+void WriteField2 (savebuf_t *f, field_t *field, byte *base)
 {
 	int			len;
 	void		*p;
@@ -477,7 +718,7 @@ void WriteField2 (FILE *f, field_t *field, byte *base)
 		if ( *(char **)p )
 		{
 			len = strlen(*(char **)p) + 1;
-			fwrite (*(char **)p, len, 1, f);
+			SaveBuf_Write (f, *(char **)p, len);
 		}
 
 			break;
@@ -491,7 +732,7 @@ void WriteField2 (FILE *f, field_t *field, byte *base)
 				}
 
 				len = strlen(func->funcStr)+1;
-				fwrite (func->funcStr, len, 1, f);
+				SaveBuf_Write (f, func->funcStr, len);
 			}
 			break;
 		case F_MMOVE:
@@ -504,7 +745,7 @@ void WriteField2 (FILE *f, field_t *field, byte *base)
 				}
 
 				len = strlen(mmove->mmoveStr)+1;
-				fwrite (mmove->mmoveStr, len, 1, f);
+				SaveBuf_Write (f, mmove->mmoveStr, len);
 			}
 		break;
 	default:
@@ -522,7 +763,7 @@ void WriteField2 (FILE *f, field_t *field, byte *base)
  * below
  */
 
-void ReadField (FILE *f, field_t *field, byte *base)
+void ReadField (savebuf_t *f, field_t *field, byte *base)
 {
 	void		*p;
 	int			len;
@@ -553,7 +794,7 @@ void ReadField (FILE *f, field_t *field, byte *base)
 			  string might not be long enough
 			 */
 			*(char **)p = (char *) gi.TagMalloc (32+len, TAG_LEVEL);
-			fread (*(char **)p, len, 1, f);
+			SaveBuf_Read (f, *(char **)p, len);
 		}
 		break;
 	case F_EDICT:
@@ -593,7 +834,7 @@ void ReadField (FILE *f, field_t *field, byte *base)
 						(int)sizeof(funcStr));
 			}
 
-			fread (funcStr, len, 1, f);
+			SaveBuf_Read (f, funcStr, len);
 
 			if ( !(*(byte **)p = FindFunctionByName (funcStr)) )
 			{
@@ -617,7 +858,7 @@ void ReadField (FILE *f, field_t *field, byte *base)
 						(int)sizeof(funcStr));
 			}
 
-			fread (funcStr, len, 1, f);
+			SaveBuf_Read (f, funcStr, len);
 
 			if ( !(*(mmove_t **)p = FindMmoveByName (funcStr)) )
 			{
@@ -640,7 +881,7 @@ WriteClient
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
-void WriteClient (FILE *f, gclient_t *client)
+void WriteClient (savebuf_t *f, gclient_t *client)
 {
 	field_t		*field;
 	gclient_t	temp;
@@ -655,7 +896,7 @@ void WriteClient (FILE *f, gclient_t *client)
 	}
 
 	// write the block
-	fwrite (&temp, sizeof(temp), 1, f);
+	SaveBuf_Write (f, &temp, sizeof(temp));
 
 	// now write any allocated data following the edict
 	for (field=clientfields ; field->name ; field++)
@@ -671,11 +912,11 @@ ReadClient
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
-void ReadClient (FILE *f, gclient_t *client)
+void ReadClient (savebuf_t *f, gclient_t *client)
 {
 	field_t		*field;
 
-	fread (client, sizeof(*client), 1, f);
+	SaveBuf_Read (f, client, sizeof(*client));
 
 	for (field=clientfields ; field->name ; field++)
 	{
@@ -699,7 +940,7 @@ last save position.
 */
 void WriteGame (char *filename, qboolean autosave)
 {
-	FILE	*f;
+	savebuf_t	*f = &savebuf;
 	int		i;
 	char str_ver[32];
 	char str_game[32];
@@ -709,9 +950,7 @@ void WriteGame (char *filename, qboolean autosave)
 	if (!autosave)
 		SaveClientData ();
 
-	f = fopen (filename, "wb");
-	if (!f)
-		gi.error ("Couldn't open %s", filename);
+	SaveBuf_Clear (f);
 
 	// Savegame identification
 	memset(str_ver, 0, sizeof(str_ver));
@@ -724,24 +963,24 @@ void WriteGame (char *filename, qboolean autosave)
 	strncpy(str_os, OS, sizeof(str_os) - 1);
 	strncpy(str_arch, ARCH, sizeof(str_arch) - 1);
 
-	fwrite(str_ver, sizeof(str_ver), 1, f);
-	fwrite(str_game, sizeof(str_game), 1, f);
-	fwrite(str_os, sizeof(str_os), 1, f);
-	fwrite(str_arch, sizeof(str_arch), 1, f);
+	SaveBuf_Write(f, str_ver, sizeof(str_ver));
+	SaveBuf_Write(f, str_game, sizeof(str_game));
+	SaveBuf_Write(f, str_os, sizeof(str_os));
+	SaveBuf_Write(f, str_arch, sizeof(str_arch));
  
 	game.autosaved = autosave;
-	fwrite (&game, sizeof(game), 1, f);
+	SaveBuf_Write (f, &game, sizeof(game));
 	game.autosaved = false;
 
 	for (i=0 ; i<game.maxclients ; i++)
 		WriteClient (f, &game.clients[i]);
 
-	fclose (f);
+	SaveBuf_WriteFile (f, filename);
 }
 
 void ReadGame (char *filename)
 {
-	FILE	*f;
+	savebuf_t	*f = &savebuf;
 	int		i;
 	char str_ver[32];
 	char str_game[32];
@@ -750,46 +989,41 @@ void ReadGame (char *filename)
 
 	gi.FreeTags (TAG_GAME);
 
-	f = fopen (filename, "rb");
-	if (!f)
-		gi.error ("Couldn't open %s", filename);
+	SaveBuf_ReadFile (f, filename);
 
 	// Sanity checks
-	fread(str_ver, sizeof(str_ver), 1, f);
-	fread(str_game, sizeof(str_game), 1, f);
-	fread(str_os, sizeof(str_os), 1, f);
-	fread(str_arch, sizeof(str_arch), 1, f);
+	SaveBuf_Read(f, str_ver, sizeof(str_ver));
+	SaveBuf_Read(f, str_game, sizeof(str_game));
+	SaveBuf_Read(f, str_os, sizeof(str_os));
+	SaveBuf_Read(f, str_arch, sizeof(str_arch));
 
 	if (strcmp(str_ver, SAVEGAMEVER))
 	{
-		fclose(f);
 		gi.error("Savegame from an incompatible version.\n");
 	}
 	else if (strcmp(str_game, GAMEVERSION))
 	{
-		fclose(f);
 		gi.error("Savegame from an other game module.\n");
 	}
  	else if (strcmp(str_os, OS))
 	{
-		fclose(f);
 		gi.error("Savegame from an other os.\n");
 	}
  	else if (strcmp(str_arch, ARCH))
 	{
-		fclose(f);
 		gi.error("Savegame from an other architecure.\n");
 	}
 
 	g_edicts = (edict_t *) gi.TagMalloc (game.maxentities * sizeof(g_edicts[0]), TAG_GAME);
+	G_AllocActiveEdicts ();
 	globals.edicts = g_edicts;
+	G_ResetFindIndex ();
+	G_ResetActiveEdicts ();
 
-	fread (&game, sizeof(game), 1, f);
+	SaveBuf_Read (f, &game, sizeof(game));
 	game.clients = (gclient_t *) gi.TagMalloc (game.maxclients * sizeof(game.clients[0]), TAG_GAME);
 	for (i=0 ; i<game.maxclients ; i++)
 		ReadClient (f, &game.clients[i]);
-
-	fclose (f);
 }
 
 // ==========================================================
@@ -801,7 +1035,7 @@ WriteEdict
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
-void WriteEdict (FILE *f, edict_t *ent)
+void WriteEdict (savebuf_t *f, edict_t *ent)
 {
 	field_t		*field;
 	edict_t		temp;
@@ -816,7 +1050,7 @@ void WriteEdict (FILE *f, edict_t *ent)
 	}
 
 	// write the block
-	fwrite (&temp, sizeof(temp), 1, f);
+	SaveBuf_Write (f, &temp, sizeof(temp));
 
 	// now write any allocated data following the edict
 	for (field=fields ; field->name ; field++)
@@ -832,7 +1066,7 @@ WriteLevelLocals
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
-void WriteLevelLocals (FILE *f)
+void WriteLevelLocals (savebuf_t *f)
 {
 	field_t		*field;
 	level_locals_t		temp;
@@ -847,7 +1081,7 @@ void WriteLevelLocals (FILE *f)
 	}
 
 	// write the block
-	fwrite (&temp, sizeof(temp), 1, f);
+	SaveBuf_Write (f, &temp, sizeof(temp));
 
 	// now write any allocated data following the edict
 	for (field=levelfields ; field->name ; field++)
@@ -866,15 +1100,13 @@ void WriteLevel (char *filename)
 {
 	int		i;
 	edict_t	*ent;
-	FILE	*f;
+	savebuf_t	*f = &savebuf;
 
-	f = fopen (filename, "wb");
-	if (!f)
-		gi.error ("Couldn't open %s", filename);
+	SaveBuf_Clear (f);
 
 	// write out edict size for checking
 	i = sizeof(edict_t);
-	fwrite (&i, sizeof(i), 1, f);
+	SaveBuf_Write (f, &i, sizeof(i));
 
 	// write out level_locals_t
 	WriteLevelLocals (f);
@@ -886,14 +1118,14 @@ void WriteLevel (char *filename)
 		if (!ent->inuse)
 			continue;
 
-		fwrite (&i, sizeof(i), 1, f);
+		SaveBuf_Write (f, &i, sizeof(i));
 		WriteEdict (f, ent);
 	}
 
 	i = -1;
-	fwrite (&i, sizeof(i), 1, f);
+	SaveBuf_Write (f, &i, sizeof(i));
 
-	fclose (f);
+	SaveBuf_WriteFile (f, filename);
 }
 
 // ==========================================================
@@ -905,11 +1137,11 @@ ReadEdict
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
-void ReadEdict (FILE *f, edict_t *ent)
+void ReadEdict (savebuf_t *f, edict_t *ent)
 {
 	field_t		*field;
 
-	fread (ent, sizeof(*ent), 1, f);
+	SaveBuf_Read (f, ent, sizeof(*ent));
 
 	for (field=fields ; field->name ; field++)
 	{
@@ -924,11 +1156,11 @@ ReadLevelLocals
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
-void ReadLevelLocals (FILE *f)
+void ReadLevelLocals (savebuf_t *f)
 {
 	field_t		*field;
 
-	fread (&level, sizeof(level), 1, f);
+	SaveBuf_Read (f, &level, sizeof(level));
 
 	for (field=levelfields ; field->name ; field++)
 	{
@@ -955,13 +1187,11 @@ No clients are connected yet.
 void ReadLevel (char *filename)
 {
 	int		entnum;
-	FILE	*f;
+	savebuf_t	*f = &savebuf;
 	int		i;
 	edict_t	*ent;
 
-	f = fopen (filename, "rb");
-	if (!f)
-		gi.error ("Couldn't open %s", filename);
+	SaveBuf_ReadFile (f, filename);
 
 	// free any dynamic memory allocated by loading the level
 	// base state
@@ -970,12 +1200,14 @@ void ReadLevel (char *filename)
 	// wipe all the entities
 	memset (g_edicts, 0, game.maxentities*sizeof(g_edicts[0]));
 	globals.num_edicts = maxclients->value+1;
+	G_ResetFindIndex ();
+	G_ResetActiveEdicts ();
+	AI_WorldChanged ();
 
 	// check edict size
-	fread (&i, sizeof(i), 1, f);
+	SaveBuf_Read (f, &i, sizeof(i));
 	if (i != sizeof(edict_t))
 	{
-		fclose (f);
 		gi.error ("ReadLevel: mismatched edict size");
 	}
 
@@ -985,15 +1217,14 @@ void ReadLevel (char *filename)
 	// load all the entities
 	while (1)
 	{
-		if (fread (&entnum, sizeof(entnum), 1, f) != 1)
-		{
-			fclose (f);
-			gi.error ("ReadLevel: failed to read entnum");
-		}
+		SaveBuf_Read (f, &entnum, sizeof(entnum));
 
 		if (entnum == -1)
 			break;
 
+		if (entnum < 0 || entnum >= game.maxentities)
+			gi.error ("ReadLevel: bad entnum %i", entnum);
+
 		if (entnum >= globals.num_edicts)
 			globals.num_edicts = entnum+1;
 
@@ -1005,7 +1236,9 @@ void ReadLevel (char *filename)
 		gi.linkentity (ent);
 	}
 
-	fclose (f);
+	// the saved index links point into the old edicts
+	G_ResetFindIndex ();
+	G_ResetActiveEdicts ();
 
 	// mark all clients as unconnected
 	for (i=0 ; i<maxclients->value ; i++)
@@ -1026,6 +1259,6 @@ void ReadLevel (char *filename)
 		// fire any cross-level triggers
 		if (ent->classname)
 			if (strcmp(ent->classname, "target_crosslevel_target") == 0)
-				ent->nextthink = level.time + ent->delay;
+				G_SetNextThink (ent, level.time + ent->delay);
 	}
 }
@@ -238,6 +238,74 @@ spawn_t	spawns[] = {
 	{NULL, NULL}
 };
 
+/*
+===============
+ED_BuildSpawnHash
+
+Hashes the item and spawn function classnames once so ED_CallSpawn doesn't
+have to strcmp its way through both tables for every entity in the map.
+Items are entered first, so they still win over a spawn function of the
+same name.
+===============
+*/
+#define	SPAWN_HASH_SIZE		1024	// power of two, well over the table sizes
+
+typedef struct
+{
+	char		*name;
+	gitem_t		*item;
+	void		(*spawn)(edict_t *ent);
+} spawnhash_t;
+
+static spawnhash_t	spawn_hash[SPAWN_HASH_SIZE];
+static qboolean		spawn_hash_built;
+
+static spawnhash_t *ED_HashSlot (char *classname)
+{
+	spawnhash_t	*slot;
+	unsigned	i;
+
+	// linear probing, the table is never more than half full
+	for (i = Com_HashKey (classname, SPAWN_HASH_SIZE) ; ; i = (i + 1) & (SPAWN_HASH_SIZE - 1))
+	{
+		slot = &spawn_hash[i];
+		if (!slot->name || !strcmp (slot->name, classname))
+			return slot;
+	}
+}
+
+static void ED_BuildSpawnHash (void)
+{
+	spawnhash_t	*slot;
+	spawn_t		*s;
+	gitem_t		*item;
+	int			i;
+
+	memset (spawn_hash, 0, sizeof(spawn_hash));
+
+	for (i=0,item=itemlist ; i<game.num_items ; i++,item++)
+	{
+		if (!item->classname)
+			continue;
+		slot = ED_HashSlot (item->classname);
+		if (slot->name)
+			continue;
+		slot->name = item->classname;
+		slot->item = item;
+	}
+
+	for (s=spawns ; s->name ; s++)
+	{
+		slot = ED_HashSlot (s->name);
+		if (slot->name)
+			continue;
+		slot->name = s->name;
+		slot->spawn = s->spawn;
+	}
+
+	spawn_hash_built = true;
+}
+
 /*
 ===============
 ED_CallSpawn
@@ -247,9 +315,7 @@ Finds the spawn function for the entity and calls it
 */
 void ED_CallSpawn (edict_t *ent)
 {
-	spawn_t	*s;
-	gitem_t	*item;
-	int		i;
+	spawnhash_t	*slot;
 
 	if (!ent)
 	{
@@ -263,27 +329,23 @@ void ED_CallSpawn (edict_t *ent)
 		return;
 	}
 
-	// check item spawn functions
-	for (i=0,item=itemlist ; i<game.num_items ; i++,item++)
-	{
-		if (!item->classname)
-			continue;
-		if (!strcmp(item->classname, ent->classname))
-		{	// found it
-			SpawnItem (ent, item);
-			return;
-		}
+	if (!spawn_hash_built)
+		ED_BuildSpawnHash ();
+
+	slot = ED_HashSlot (ent->classname);
+
+	if (slot->item)
+	{	// check item spawn functions
+		SpawnItem (ent, slot->item);
+		return;
 	}
 
-	// check normal spawn functions
-	for (s=spawns ; s->name ; s++)
-	{
-		if (!strcmp(s->name, ent->classname))
-		{	// found it
-			s->spawn (ent);
-			return;
-		}
+	if (slot->spawn)
+	{	// check normal spawn functions
+		slot->spawn (ent);
+		return;
 	}
+
 	gi.dprintf ("%s doesn't have a spawn function\n", ent->classname);
 }
 
@@ -444,7 +506,12 @@ char *ED_ParseEdict (char *data, edict_t *ent)
 	}
 
 	if (!init)
+	{
+		G_UnlinkFind (ent);
 		memset (ent, 0, sizeof(*ent));
+	}
+	else
+		G_RelinkFind (ent);
 
 	return data;
 }
@@ -517,6 +584,7 @@ void SpawnEntities (char *mapname, char *entities, char *spawnpoint)
 	char		*com_token;
 	int			i;
 	float		skill_level;
+	unsigned int	start, parsetime, spawntime;
 
 	if (!mapname || !entities || !spawnpoint)
 	{
@@ -537,6 +605,9 @@ void SpawnEntities (char *mapname, char *entities, char *spawnpoint)
 
 	memset (&level, 0, sizeof(level));
 	memset (g_edicts, 0, game.maxentities * sizeof (g_edicts[0]));
+	G_ResetFindIndex ();
+	G_ResetActiveEdicts ();
+	AI_WorldChanged ();
 
 	strncpy (level.mapname, mapname, sizeof(level.mapname)-1);
 	strncpy (game.spawnpoint, spawnpoint, sizeof(game.spawnpoint)-1);
@@ -547,6 +618,7 @@ void SpawnEntities (char *mapname, char *entities, char *spawnpoint)
 
 	ent = NULL;
 	inhibit = 0;
+	parsetime = spawntime = 0;
 
 // parse ents
 	while (1)
@@ -558,11 +630,13 @@ void SpawnEntities (char *mapname, char *entities, char *spawnpoint)
 		if (com_token[0] != '{')
 			gi.error ("ED_LoadFromFile: found %s when expecting {",com_token);
 
+		start = gi.Microseconds ();
 		if (!ent)
 			ent = g_edicts;
 		else
 			ent = G_Spawn ();
 		entities = ED_ParseEdict (entities, ent);
+		parsetime += gi.Microseconds () - start;
 
 		// yet another map hack
 		if (!Q_stricmp(level.mapname, "command") && !Q_stricmp(ent->classname, "trigger_once") && !Q_stricmp(ent->model, "*27"))
@@ -597,7 +671,9 @@ void SpawnEntities (char *mapname, char *entities, char *spawnpoint)
 			ent->spawnflags &= ~(SPAWNFLAG_NOT_EASY|SPAWNFLAG_NOT_MEDIUM|SPAWNFLAG_NOT_HARD|SPAWNFLAG_NOT_COOP|SPAWNFLAG_NOT_DEATHMATCH);
 		}
 
+		start = gi.Microseconds ();
 		ED_CallSpawn (ent);
+		spawntime += gi.Microseconds () - start;
 	}	
 
 	gi.dprintf ("%i entities inhibited\n", inhibit);
@@ -612,7 +688,12 @@ void SpawnEntities (char *mapname, char *entities, char *spawnpoint)
 	}
 #endif
 
+	start = gi.Microseconds ();
 	G_FindTeams ();
+	spawntime += gi.Microseconds () - start;
+
+	gi.dprintf ("entity parse %i ms, spawn %i ms\n",
+		(int)(parsetime / 1000), (int)(spawntime / 1000));
 
 	PlayerTrail_Init ();
 }
@@ -801,6 +882,7 @@ void SP_worldspawn (edict_t *ent)
 	ent->movetype = MOVETYPE_PUSH;
 	ent->solid = SOLID_BSP;
 	ent->inuse = true;			// since the world doesn't use G_Spawn()
+	G_MarkActive (ent);
 	ent->s.modelindex = 1;		// world model is always index 1
 
 	//---------------
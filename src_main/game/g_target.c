@@ -318,7 +318,7 @@ void use_target_explosion (edict_t *self, edict_t *other, edict_t *activator)
 	}
 
 	self->think = target_explosion_explode;
-	self->nextthink = level.time + self->delay;
+	G_SetNextThink (self, level.time + self->delay);
 }
 
 void SP_target_explosion (edict_t *ent)
@@ -477,7 +477,7 @@ void use_target_spawner (edict_t *self, edict_t *other, edict_t *activator)
 	}
 
 	ent = G_Spawn();
-	ent->classname = self->target;
+	G_SetClassname (ent, self->target);
 	VectorCopy (self->s.origin, ent->s.origin);
 	VectorCopy (self->s.angles, ent->s.angles);
 	ED_CallSpawn (ent);
@@ -606,7 +606,7 @@ void SP_target_crosslevel_target (edict_t *self)
 	self->svflags = SVF_NOCLIENT;
 
 	self->think = target_crosslevel_target_think;
-	self->nextthink = level.time + self->delay;
+	G_SetNextThink (self, level.time + self->delay);
 }
 
 //==========================================================
@@ -685,7 +685,7 @@ void target_laser_think (edict_t *self)
 
 	VectorCopy (tr.endpos, self->s.old_origin);
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 }
 
 void target_laser_on (edict_t *self)
@@ -711,7 +711,7 @@ void target_laser_off (edict_t *self)
 
 	self->spawnflags &= ~1;
 	self->svflags |= SVF_NOCLIENT;
-	self->nextthink = 0;
+	G_SetNextThink (self, 0);
 }
 
 void target_laser_use (edict_t *self, edict_t *other, edict_t *activator)
@@ -802,7 +802,7 @@ void SP_target_laser (edict_t *self)
 
 	// let everything else get spawned before we start firing
 	self->think = target_laser_start;
-	self->nextthink = level.time + 1;
+	G_SetNextThink (self, level.time + 1);
 }
 
 //==========================================================
@@ -826,7 +826,7 @@ void target_lightramp_think (edict_t *self)
 
 	if ((level.time - self->timestamp) < self->speed)
 	{
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink (self, level.time + FRAMETIME);
 	}
 	else if (self->spawnflags & 1)
 	{
@@ -957,7 +957,7 @@ void target_earthquake_think (edict_t *self)
 	}
 
 	if (level.time < self->timestamp)
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink (self, level.time + FRAMETIME);
 }
 
 void target_earthquake_use (edict_t *self, edict_t *other, edict_t *activator)
@@ -968,7 +968,7 @@ void target_earthquake_use (edict_t *self, edict_t *other, edict_t *activator)
 	}
 
 	self->timestamp = level.time + self->count;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 	self->activator = activator;
 	self->last_move_time = 0;
 }
@@ -45,7 +45,7 @@ void multi_wait (edict_t *ent)
 		return;
 	}
 
-	ent->nextthink = 0;
+	G_SetNextThink (ent, 0);
 }
 
 
@@ -67,13 +67,13 @@ void multi_trigger (edict_t *ent)
 	if (ent->wait > 0)	
 	{
 		ent->think = multi_wait;
-		ent->nextthink = level.time + ent->wait;
+		G_SetNextThink (ent, level.time + ent->wait);
 	}
 	else
 	{	// we can't just remove (self) here, because this is a touch function
 		// called while looping through area links...
 		ent->touch = NULL;
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink (ent, level.time + FRAMETIME);
 		ent->think = G_FreeEdict;
 	}
 }
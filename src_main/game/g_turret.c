@@ -170,7 +170,7 @@ void turret_breach_think (edict_t *self)
 
 	VectorScale (delta, 1.0/FRAMETIME, self->avelocity);
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 
 	for (ent = self->teammaster; ent; ent = ent->teamchain)
 		ent->avelocity[1] = self->avelocity[1];
@@ -272,7 +272,7 @@ void SP_turret_breach (edict_t *self)
 	self->blocked = turret_blocked;
 
 	self->think = turret_breach_finish_init;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 	gi.linkentity (self);
 }
 
@@ -344,7 +344,7 @@ void turret_driver_think (edict_t *self)
 		return;
 	}
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 
 	if (self->enemy && (!self->enemy->inuse || (self->enemy->health <= 0)))
 		self->enemy = NULL;
@@ -403,7 +403,7 @@ void turret_driver_link (edict_t *self)
 	}
 
 	self->think = turret_driver_think;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 
 	self->target_ent = G_PickTarget (self->target);
 	self->target_ent->owner = self;
@@ -477,7 +477,7 @@ void SP_turret_driver (edict_t *self)
 	}
 
 	self->think = turret_driver_link;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink (self, level.time + FRAMETIME);
 
 	gi.linkentity (self);
 }
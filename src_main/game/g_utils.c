@@ -30,6 +30,502 @@ void G_ProjectSource (vec3_t point, vec3_t distance, vec3_t forward, vec3_t righ
 }
 
 
+/*
+==============================================================================
+
+FIND INDEX
+
+classname and targetname are hashed so that G_Find doesn't have to walk
+every edict when firing targets.  Each bucket chain is kept sorted by edict
+number so searches still return entities in the same order as a linear
+scan.  The fields must be changed through G_SetClassname / G_SetTargetname
+(or G_RelinkFind after writing them directly) to keep the index current.
+
+==============================================================================
+*/
+
+#define	FIND_HASH_SIZE	1024
+
+static edict_t	*g_findhash[FIND_NUMINDEXES][FIND_HASH_SIZE];
+
+/*
+=============
+G_UnlinkFindIndex
+=============
+*/
+static void G_UnlinkFindIndex (edict_t *ent, int index)
+{
+	findlink_t	*link = &ent->findlinks[index];
+
+	if (!link->name)
+		return;
+
+	if (link->prev)
+		link->prev->findlinks[index].next = link->next;
+	else
+		g_findhash[index][link->bucket] = link->next;
+
+	if (link->next)
+		link->next->findlinks[index].prev = link->prev;
+
+	link->prev = link->next = NULL;
+	link->name = NULL;
+}
+
+/*
+=============
+G_LinkFindIndex
+
+Inserts ent into the chain for name, keeping the chain in edict order
+=============
+*/
+static void G_LinkFindIndex (edict_t *ent, int index, char *name)
+{
+	findlink_t	*link = &ent->findlinks[index];
+	edict_t		*prev, *next;
+
+	if (link->name == name)
+		return;
+
+	G_UnlinkFindIndex (ent, index);
+
+	if (!name)
+		return;
+
+	link->name = name;
+	link->bucket = Com_HashKey (name, FIND_HASH_SIZE);
+
+	prev = NULL;
+	for (next = g_findhash[index][link->bucket] ; next && next < ent ; next = next->findlinks[index].next)
+		prev = next;
+
+	link->prev = prev;
+	link->next = next;
+
+	if (prev)
+		prev->findlinks[index].next = ent;
+	else
+		g_findhash[index][link->bucket] = ent;
+
+	if (next)
+		next->findlinks[index].prev = ent;
+}
+
+/*
+=============
+G_SetClassname
+=============
+*/
+void G_SetClassname (edict_t *ent, char *classname)
+{
+	ent->classname = classname;
+	G_LinkFindIndex (ent, FIND_CLASSNAME, classname);
+}
+
+/*
+=============
+G_SetTargetname
+=============
+*/
+void G_SetTargetname (edict_t *ent, char *targetname)
+{
+	ent->targetname = targetname;
+	G_LinkFindIndex (ent, FIND_TARGETNAME, targetname);
+}
+
+/*
+=============
+G_RelinkFind
+
+Reindexes an edict whose fields were written directly, as by ED_ParseEdict
+=============
+*/
+void G_RelinkFind (edict_t *ent)
+{
+	G_LinkFindIndex (ent, FIND_CLASSNAME, ent->classname);
+	G_LinkFindIndex (ent, FIND_TARGETNAME, ent->targetname);
+}
+
+/*
+=============
+G_UnlinkFind
+
+Must be called before an indexed edict is wiped
+=============
+*/
+void G_UnlinkFind (edict_t *ent)
+{
+	G_UnlinkFindIndex (ent, FIND_CLASSNAME);
+	G_UnlinkFindIndex (ent, FIND_TARGETNAME);
+}
+
+/*
+=============
+G_ResetFindIndex
+
+Throws away the index and rebuilds it from the active edicts.  Used whenever
+g_edicts is reallocated, wiped or read back from a savegame, where any links
+left in the edicts are meaningless.
+=============
+*/
+void G_ResetFindIndex (void)
+{
+	edict_t	*ent;
+	int		i;
+
+	memset (g_findhash, 0, sizeof(g_findhash));
+
+	if (!g_edicts)
+		return;
+
+	// walk backwards so every insert lands at the head of its chain
+	for (ent = &g_edicts[globals.num_edicts - 1] ; ent >= g_edicts ; ent--)
+	{
+		memset (ent->findlinks, 0, sizeof(ent->findlinks));
+
+		if (!ent->inuse)
+			continue;
+
+		for (i=0 ; i<FIND_NUMINDEXES ; i++)
+		{
+			char	*name = i == FIND_CLASSNAME ? ent->classname : ent->targetname;
+
+			if (!name)
+				continue;
+
+			ent->findlinks[i].name = name;
+			ent->findlinks[i].bucket = Com_HashKey (name, FIND_HASH_SIZE);
+			ent->findlinks[i].next = g_findhash[i][ent->findlinks[i].bucket];
+
+			if (ent->findlinks[i].next)
+				ent->findlinks[i].next->findlinks[i].prev = ent;
+
+			g_findhash[i][ent->findlinks[i].bucket] = ent;
+		}
+	}
+}
+
+
+/*
+==============================================================================
+
+ACTIVE EDICTS
+
+One bit per edict that may be in use, so the per frame loops can skip runs
+of free edicts without touching them.  A bit is set everywhere inuse is set
+and is cleared lazily by G_RunFrame once it finds the edict free.
+
+Edicts that have nothing to do but wait for their next think (MOVETYPE_NONE,
+no prethink, not standing on anything) are also put to sleep, and G_RunFrame
+skips them until their think time comes up in the think queue.  Anything
+that could give a sleeping edict work wakes it: setting nextthink through
+G_SetNextThink, linking it into the world, or reusing or freeing it.  Woken
+edicts run in the usual edict order, so the order thinks happen in within a
+frame is unchanged.
+
+Callbacks can hand a sleeping edict work without going through any of
+those, such as a use function that gives it a movetype.  So the edict a
+use, touch, pain, die or blocked callback runs on is woken before the
+call.  Any other sleeper it may have changed is rechecked at the end of
+the frame.
+
+g_thinkverify 1 runs sleeping edicts the way the full scan would and
+reports any that moved or thought while asleep.
+
+==============================================================================
+*/
+
+unsigned		*g_activebits;		// allocated along with g_edicts
+unsigned		*g_sleepbits;
+
+static int		*think_heap;		// sleeping edict numbers, soonest think first
+static int		*think_slot;		// heap position + 1 for each edict, 0 if not queued
+static float	*think_time;		// nextthink when the edict went to sleep
+static int		think_count;
+static qboolean	think_recheck;		// a callback ran, so look the sleepers over
+
+void			(*gi_linkentity) (edict_t *ent);	// the engine's linkentity
+void			(*gi_unlinkentity) (edict_t *ent);
+
+/*
+=============
+G_AllocActiveEdicts
+
+Called wherever g_edicts is allocated
+=============
+*/
+void G_AllocActiveEdicts (void)
+{
+	int		words = (game.maxentities + 31) >> 5;
+
+	g_activebits = (unsigned *) gi.TagMalloc (words * sizeof(g_activebits[0]), TAG_GAME);
+	g_sleepbits = (unsigned *) gi.TagMalloc (words * sizeof(g_sleepbits[0]), TAG_GAME);
+	think_heap = (int *) gi.TagMalloc (game.maxentities * sizeof(think_heap[0]), TAG_GAME);
+	think_slot = (int *) gi.TagMalloc (game.maxentities * sizeof(think_slot[0]), TAG_GAME);
+	think_time = (float *) gi.TagMalloc (game.maxentities * sizeof(think_time[0]), TAG_GAME);
+	think_count = 0;
+}
+
+/*
+=============
+G_MarkActive
+=============
+*/
+void G_MarkActive (edict_t *ent)
+{
+	int		n = ent - g_edicts;
+
+	g_activebits[n >> 5] |= 1u << (n & 31);
+}
+
+/*
+=============
+G_ResetActiveEdicts
+
+Rebuilds the bits from the edicts and wakes everything; called whenever
+g_edicts is reallocated, wiped or read back from a savegame
+=============
+*/
+void G_ResetActiveEdicts (void)
+{
+	int		i, words;
+
+	words = (game.maxentities + 31) >> 5;
+	memset (g_activebits, 0, words * sizeof(g_activebits[0]));
+	memset (g_sleepbits, 0, words * sizeof(g_sleepbits[0]));
+	memset (think_slot, 0, game.maxentities * sizeof(think_slot[0]));
+	think_count = 0;
+
+	for (i=0 ; i<globals.num_edicts ; i++)
+	{
+		if (g_edicts[i].inuse)
+			G_MarkActive (&g_edicts[i]);
+	}
+}
+
+static void ThinkHeap_Place (int pos, int n)
+{
+	think_heap[pos] = n;
+	think_slot[n] = pos + 1;
+}
+
+static void ThinkHeap_Up (int pos)
+{
+	int		n = think_heap[pos];
+	int		parent;
+
+	while (pos > 0)
+	{
+		parent = (pos - 1) >> 1;
+		if (think_time[think_heap[parent]] <= think_time[n])
+			break;
+		ThinkHeap_Place (pos, think_heap[parent]);
+		pos = parent;
+	}
+
+	ThinkHeap_Place (pos, n);
+}
+
+static void ThinkHeap_Down (int pos)
+{
+	int		n = think_heap[pos];
+	int		child;
+
+	while ((child = pos * 2 + 1) < think_count)
+	{
+		if (child + 1 < think_count && think_time[think_heap[child + 1]] < think_time[think_heap[child]])
+			child++;
+		if (think_time[n] <= think_time[think_heap[child]])
+			break;
+		ThinkHeap_Place (pos, think_heap[child]);
+		pos = child;
+	}
+
+	ThinkHeap_Place (pos, n);
+}
+
+static void ThinkHeap_Remove (int n)
+{
+	int		pos = think_slot[n] - 1;
+	int		last;
+
+	think_slot[n] = 0;
+	last = think_heap[--think_count];
+
+	if (pos == think_count)
+		return;
+
+	ThinkHeap_Place (pos, last);
+	ThinkHeap_Up (pos);
+	ThinkHeap_Down (think_slot[last] - 1);
+}
+
+/*
+=============
+G_SleepEdict
+
+Stops running an idle edict every frame until its nextthink
+=============
+*/
+void G_SleepEdict (edict_t *ent)
+{
+	int		n = ent - g_edicts;
+
+	g_sleepbits[n >> 5] |= 1u << (n & 31);
+
+	if (ent->nextthink > 0)
+	{
+		think_time[n] = ent->nextthink;
+		think_heap[think_count++] = n;
+		ThinkHeap_Up (think_count - 1);
+	}
+}
+
+/*
+=============
+G_WakeEdict
+=============
+*/
+void G_WakeEdict (edict_t *ent)
+{
+	int		n = ent - g_edicts;
+
+	if (!(g_sleepbits[n >> 5] & (1u << (n & 31))))
+		return;
+
+	g_sleepbits[n >> 5] &= ~(1u << (n & 31));
+
+	if (think_slot[n])
+		ThinkHeap_Remove (n);
+}
+
+/*
+=============
+G_WakeThinkers
+
+Wakes every sleeping edict whose think is due this frame
+=============
+*/
+void G_WakeThinkers (void)
+{
+	int		i;
+
+	if (!g_thinkqueue->value)
+	{
+		// wake everything if the queue was just turned off
+		for (i=0 ; i<globals.num_edicts ; i++)
+			G_WakeEdict (&g_edicts[i]);
+		return;
+	}
+
+	while (think_count && think_time[think_heap[0]] <= level.time + 0.001)
+		G_WakeEdict (&g_edicts[think_heap[0]]);
+}
+
+/*
+=============
+G_WakeForCallback
+
+Called before running a callback on an edict, which may give it work
+=============
+*/
+void G_WakeForCallback (edict_t *ent)
+{
+	G_WakeEdict (ent);
+	think_recheck = true;
+}
+
+/*
+=============
+G_RecheckSleepers
+
+Wakes any sleeping edict that a callback this frame has given work to
+=============
+*/
+void G_RecheckSleepers (void)
+{
+	int		i, words;
+	unsigned	bits;
+
+	if (!think_recheck)
+		return;
+
+	think_recheck = false;
+	words = (globals.num_edicts + 31) >> 5;
+
+	for (i=0 ; i<words ; i++)
+	{
+		for (bits = g_sleepbits[i] ; bits ; bits &= bits - 1)
+		{
+			edict_t	*ent = &g_edicts[(i << 5) + Q_LowestBit (bits)];
+
+			if (!G_CanSleep (ent))
+				G_WakeEdict (ent);
+		}
+	}
+}
+
+/*
+=============
+G_CanSleep
+
+True if running the edict this frame would do nothing at all
+=============
+*/
+qboolean G_CanSleep (edict_t *ent)
+{
+	if (!ent->inuse)
+		return false;
+	if (ent->movetype != MOVETYPE_NONE || ent->prethink || ent->groundentity)
+		return false;
+	if (!VectorCompare (ent->s.origin, ent->s.old_origin))
+		return false;
+	if (ent->nextthink > 0 && ent->nextthink <= level.time + 0.001)
+		return false;
+
+	return true;
+}
+
+/*
+=============
+G_SetNextThink
+=============
+*/
+void G_SetNextThink (edict_t *ent, float nextthink)
+{
+	ent->nextthink = nextthink;
+	G_WakeEdict (ent);
+}
+
+/*
+=============
+G_LinkEntity
+
+Replaces gi.linkentity, since anything relinked may have been moved
+or had its movetype changed
+=============
+*/
+void G_LinkEntity (edict_t *ent)
+{
+	G_WakeEdict (ent);
+	AI_SenseLinked (ent);
+	gi_linkentity (ent);
+}
+
+/*
+=============
+G_UnlinkEntity
+
+Replaces gi.unlinkentity
+=============
+*/
+void G_UnlinkEntity (edict_t *ent)
+{
+	AI_SenseLinked (ent);
+	gi_unlinkentity (ent);
+}
+
+
 /*
 =============
 G_Find
@@ -40,22 +536,55 @@ the matching string at fieldofs (use the FOFS() macro) in the structure.
 Searches beginning at the edict after from, or the beginning if NULL
 NULL will be returned if the end of the list is reached.
 
+classname and targetname searches only visit the matching hash chain.
 =============
 */
 edict_t *G_Find (edict_t *from, int fieldofs, char *match)
 {
 	char	*s;
+	edict_t	*e;
+	int		index, bucket;
 
-	if (!from)
-		from = g_edicts;
+	if (!match)
+	{
+		return NULL;
+	}
+
+	if (fieldofs == FOFS(classname))
+		index = FIND_CLASSNAME;
+	else if (fieldofs == FOFS(targetname))
+		index = FIND_TARGETNAME;
 	else
-		from++;
+		index = -1;
 
-	if (!match)
+	if (index >= 0)
 	{
+		bucket = Com_HashKey (match, FIND_HASH_SIZE);
+
+		// continue down the chain if the last result is still on it,
+		// otherwise skip ahead from the start of the bucket
+		if (from && from->findlinks[index].name && from->findlinks[index].bucket == bucket)
+			e = from->findlinks[index].next;
+		else
+			for (e = g_findhash[index][bucket] ; e && from && e <= from ; e = e->findlinks[index].next)
+				;
+
+		for ( ; e ; e = e->findlinks[index].next)
+		{
+			if (!e->inuse)
+				continue;
+			if (!Q_stricmp (e->findlinks[index].name, match))
+				return e;
+		}
+
 		return NULL;
 	}
 
+	if (!from)
+		from = g_edicts;
+	else
+		from++;
+
 	for ( ; from < &g_edicts[globals.num_edicts] ; from++)
 	{
 		if (!from->inuse)
@@ -78,30 +607,92 @@ findradius
 Returns entities that have origins within a spherical area
 
 findradius (origin, radius)
+
+The candidates come from the server's area tree rather than a walk over
+every edict.  The first call of a search gathers everything linked within
+the bounding cube of the sphere, sorted into edict order, and later calls
+continue down that list as long as they ask about the same sphere.  Each
+candidate is still tested against the sphere when it is returned, since
+entities may move, die or change solidity while the caller is looping.
 =================
 */
+static edict_t	*radius_list[MAX_EDICTS];
+static int		radius_count;
+static int		radius_next;			// index of the next candidate to test
+static edict_t	*radius_last;			// last entity returned from the list
+static vec3_t	radius_org;
+static float	radius_rad;
+
+static int RadiusSort (void const *a, void const *b)
+{
+	edict_t	*e1 = *(edict_t **)a;
+	edict_t	*e2 = *(edict_t **)b;
+
+	if (e1 < e2)
+		return -1;
+	if (e1 > e2)
+		return 1;
+	return 0;
+}
+
+static void RadiusQuery (vec3_t org, float rad)
+{
+	vec3_t	mins, maxs;
+	int		j;
+
+	for (j=0 ; j<3 ; j++)
+	{
+		mins[j] = org[j] - rad;
+		maxs[j] = org[j] + rad;
+	}
+
+	radius_count = gi.BoxEdicts (mins, maxs, radius_list, MAX_EDICTS, AREA_SOLID);
+	radius_count += gi.BoxEdicts (mins, maxs, radius_list + radius_count, MAX_EDICTS - radius_count, AREA_TRIGGERS);
+
+	qsort (radius_list, radius_count, sizeof(radius_list[0]), RadiusSort);
+
+	VectorCopy (org, radius_org);
+	radius_rad = rad;
+	radius_next = 0;
+}
+
 edict_t *findradius (edict_t *from, vec3_t org, float rad)
 {
+	edict_t	*e;
 	vec3_t	eorg;
 	int		j;
 
-	if (!from)
-		from = g_edicts;
-	else
-		from++;
-	for ( ; from < &g_edicts[globals.num_edicts]; from++)
+	// a nested search may have replaced the list, so only continue
+	// where we left off if it's still ours
+	if (!from || rad != radius_rad || !VectorCompare (org, radius_org)
+		|| from != radius_last)
 	{
-		if (!from->inuse)
+		RadiusQuery (org, rad);
+
+		if (from)
+		{
+			while (radius_next < radius_count && radius_list[radius_next] <= from)
+				radius_next++;
+		}
+	}
+
+	while (radius_next < radius_count)
+	{
+		e = radius_list[radius_next++];
+
+		if (!e->inuse)
 			continue;
-		if (from->solid == SOLID_NOT)
+		if (e->solid == SOLID_NOT)
 			continue;
 		for (j=0 ; j<3 ; j++)
-			eorg[j] = org[j] - (from->s.origin[j] + (from->mins[j] + from->maxs[j])*0.5);
+			eorg[j] = org[j] - (e->s.origin[j] + (e->mins[j] + e->maxs[j])*0.5);
 		if (VectorLength(eorg) > rad)
 			continue;
-		return from;
+		radius_last = e;
+		return e;
 	}
 
+	radius_last = NULL;
 	return NULL;
 }
 
@@ -196,8 +787,8 @@ void G_UseTargets (edict_t *ent, edict_t *activator)
 	{
 	// create a temp object to fire at a later time
 		t = G_Spawn();
-		t->classname = "DelayedUse";
-		t->nextthink = level.time + ent->delay;
+		G_SetClassname (t, "DelayedUse");
+		G_SetNextThink (t, level.time + ent->delay);
 		t->think = Think_Delay;
 		t->activator = activator;
 		if (!activator)
@@ -273,7 +864,10 @@ void G_UseTargets (edict_t *ent, edict_t *activator)
 			else
 			{
 				if (t->use)
+				{
+					G_WakeForCallback (t);
 					t->use (t, ent, activator);
+				}
 			}
 			if (!ent->inuse)
 			{
@@ -426,7 +1020,9 @@ char *G_CopyString (char *in)
 void G_InitEdict (edict_t *e)
 {
 	e->inuse = true;
-	e->classname = "noclass";
+	G_MarkActive (e);
+	G_WakeEdict (e);
+	G_SetClassname (e, "noclass");
 	e->gravity = 1.0;
 	e->s.number = e - g_edicts;
 }
@@ -494,6 +1090,9 @@ void G_FreeEdict (edict_t *ed)
 		}
 	}
 
+	// free edicts stay out of the find index and think queue
+	G_UnlinkFind (ed);
+	G_WakeEdict (ed);
 	memset (ed, 0, sizeof(*ed));
 	ed->classname = "freed";
 	ed->freetime = level.time;
@@ -532,6 +1131,7 @@ void G_TouchTriggers (edict_t *ent)
 			continue;
 		if (!hit->touch)
 			continue;
+		G_WakeForCallback (hit);
 		hit->touch (hit, ent, NULL, NULL);
 	}
 }
@@ -565,7 +1165,10 @@ void	G_TouchSolids (edict_t *ent)
 		if (!hit->inuse)
 			continue;
 		if (ent->touch)
+		{
+			G_WakeForCallback (hit);
 			ent->touch (hit, ent, NULL, NULL);
+		}
 		if (!ent->inuse)
 			break;
 	}
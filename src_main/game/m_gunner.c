@@ -361,7 +361,7 @@ void gunner_dead (edict_t *self)
 	Vector3Set (self->maxs, 16, 16, -8);
 	self->movetype = MOVETYPE_TOSS;
 	self->svflags |= SVF_DEADMONSTER;
-	self->nextthink = 0;
+	G_SetNextThink (self, 0);
 	gi.linkentity (self);
 }
 
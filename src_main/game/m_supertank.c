@@ -646,7 +646,7 @@ void supertank_dead (edict_t *self)
 	Vector3Set (self->maxs, 60, 60, 72);
 	self->movetype = MOVETYPE_TOSS;
 	self->svflags |= SVF_DEADMONSTER;
-	self->nextthink = 0;
+	G_SetNextThink (self, 0);
 	gi.linkentity (self);
 }
 
@@ -716,7 +716,7 @@ void BossExplode (edict_t *self)
 	gi.WritePosition (org);
 	gi.multicast (self->s.origin, MULTICAST_PVS);
 
-	self->nextthink = level.time + 0.1;
+	G_SetNextThink (self, level.time + 0.1);
 }
 
 
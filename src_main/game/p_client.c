@@ -61,7 +61,7 @@ static void SP_FixCoopSpots (edict_t *self)
 			if ((!self->targetname) || (Q_stricmp(self->targetname, spot->targetname) != 0))
 			{
 //				gi.dprintf("FixCoopSpots changed %s at %s targetname from %s to %s\n", self->classname, vtos(self->s.origin), self->targetname, spot->targetname);
-				self->targetname = spot->targetname;
+				G_SetTargetname (self, spot->targetname);
 			}
 			return;
 		}
@@ -84,27 +84,27 @@ static void SP_CreateCoopSpots (edict_t *self)
 	if(Q_stricmp(level.mapname, "security") == 0)
 	{
 		spot = G_Spawn();
-		spot->classname = "info_player_coop";
+		G_SetClassname (spot, "info_player_coop");
 		spot->s.origin[0] = 188 - 64;
 		spot->s.origin[1] = -164;
 		spot->s.origin[2] = 80;
-		spot->targetname = "jail3";
+		G_SetTargetname (spot, "jail3");
 		spot->s.angles[1] = 90;
 
 		spot = G_Spawn();
-		spot->classname = "info_player_coop";
+		G_SetClassname (spot, "info_player_coop");
 		spot->s.origin[0] = 188 + 64;
 		spot->s.origin[1] = -164;
 		spot->s.origin[2] = 80;
-		spot->targetname = "jail3";
+		G_SetTargetname (spot, "jail3");
 		spot->s.angles[1] = 90;
 
 		spot = G_Spawn();
-		spot->classname = "info_player_coop";
+		G_SetClassname (spot, "info_player_coop");
 		spot->s.origin[0] = 188 + 128;
 		spot->s.origin[1] = -164;
 		spot->s.origin[2] = 80;
-		spot->targetname = "jail3";
+		G_SetTargetname (spot, "jail3");
 		spot->s.angles[1] = 90;
 
 		return;
@@ -128,7 +128,7 @@ void SP_info_player_start(edict_t *self)
 	{
 		// invoke one of our gross, ugly, disgusting hacks
 		self->think = SP_CreateCoopSpots;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink (self, level.time + FRAMETIME);
 	}
 }
 
@@ -185,7 +185,7 @@ void SP_info_player_coop(edict_t *self)
 	{
 		// invoke one of our gross, ugly, disgusting hacks
 		self->think = SP_FixCoopSpots;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink (self, level.time + FRAMETIME);
 	}
 }
 
@@ -495,7 +495,7 @@ void TossClientWeapon (edict_t *self)
 		drop->spawnflags |= DROPPED_PLAYER_ITEM;
 
 		drop->touch = Touch_Item;
-		drop->nextthink = level.time + (self->client->quad_framenum - level.framenum) * FRAMETIME;
+		G_SetNextThink (drop, level.time + (self->client->quad_framenum - level.framenum) * FRAMETIME);
 		drop->think = G_FreeEdict;
 	}
 }
@@ -1030,7 +1030,7 @@ void InitBodyQue (void)
 		for (i=0; i<BODY_QUEUE_SIZE ; i++)
 		{
 			ent = G_Spawn();
-			ent->classname = "bodyque";
+			G_SetClassname (ent, "bodyque");
 		}
 	}
 }
@@ -1293,7 +1293,8 @@ void PutClientInServer (edict_t *ent)
 	ent->movetype = MOVETYPE_WALK;
 	ent->viewheight = 22;
 	ent->inuse = true;
-	ent->classname = "player";
+	G_MarkActive (ent);
+	G_SetClassname (ent, "player");
 	ent->mass = 200;
 	ent->solid = SOLID_BBOX;
 	ent->deadflag = DEAD_NO;
@@ -1468,7 +1469,7 @@ void ClientBegin (edict_t *ent)
 		// except for the persistant data that was initialized at
 		// ClientConnect() time
 		G_InitEdict (ent);
-		ent->classname = "player";
+		G_SetClassname (ent, "player");
 		InitClientResp (ent->client);
 		PutClientInServer (ent);
 	}
@@ -1682,7 +1683,7 @@ void ClientDisconnect (edict_t *ent)
 	ent->s.modelindex = 0;
 	ent->solid = SOLID_NOT;
 	ent->inuse = false;
-	ent->classname = "disconnected";
+	G_SetClassname (ent, "disconnected");
 	ent->client->pers.connected = false;
 
 	playernum = ent-g_edicts-1;
@@ -1875,6 +1876,7 @@ void ClientThink (edict_t *ent, usercmd_t *ucmd)
 				continue;	// duplicated
 			if (!other->touch)
 				continue;
+			G_WakeForCallback (other);
 			other->touch (other, ent, NULL, NULL);
 		}
 
@@ -402,18 +402,18 @@ extern void ED_ParseField ( char * key , char * value , edict_t * ent ) ;
 extern char * ED_NewString ( char * string ) ;
 extern void ED_CallSpawn ( edict_t * ent ) ;
 extern void ReadLevel ( char * filename ) ;
-extern void ReadLevelLocals ( FILE * f ) ;
-extern void ReadEdict ( FILE * f , edict_t * ent ) ;
+extern void ReadLevelLocals ( savebuf_t * f ) ;
+extern void ReadEdict ( savebuf_t * f , edict_t * ent ) ;
 extern void WriteLevel ( char * filename ) ;
-extern void WriteLevelLocals ( FILE * f ) ;
-extern void WriteEdict ( FILE * f , edict_t * ent ) ;
+extern void WriteLevelLocals ( savebuf_t * f ) ;
+extern void WriteEdict ( savebuf_t * f , edict_t * ent ) ;
 extern void ReadGame ( char * filename ) ;
 extern void WriteGame ( char * filename , qboolean autosave ) ;
-extern void ReadClient ( FILE * f , gclient_t * client ) ;
-extern void WriteClient ( FILE * f , gclient_t * client ) ;
-extern void ReadField ( FILE * f , field_t * field , byte * base ) ;
-extern void WriteField2 ( FILE * f , field_t * field , byte * base ) ;
-extern void WriteField1 ( FILE * f , field_t * field , byte * base ) ;
+extern void ReadClient ( savebuf_t * f , gclient_t * client ) ;
+extern void WriteClient ( savebuf_t * f , gclient_t * client ) ;
+extern void ReadField ( savebuf_t * f , field_t * field , byte * base ) ;
+extern void WriteField2 ( savebuf_t * f , field_t * field , byte * base ) ;
+extern void WriteField1 ( savebuf_t * f , field_t * field , byte * base ) ;
 extern mmove_t * FindMmoveByName ( char * name ) ;
 extern mmoveList_t * GetMmoveByAddress ( mmove_t * adr ) ;
 extern byte * FindFunctionByName ( char * name ) ;
@@ -426,7 +426,6 @@ extern void SV_Physics_Toss ( edict_t * ent ) ;
 extern void SV_Physics_Noclip ( edict_t * ent ) ;
 extern void SV_Physics_None ( edict_t * ent ) ;
 extern void SV_Physics_Pusher ( edict_t * ent ) ;
-extern qboolean SV_Push ( edict_t * pusher , vec3_t move , vec3_t amove ) ;
 extern trace_t SV_PushEntity ( edict_t * ent , vec3_t push ) ;
 extern void RealBoundingBox ( edict_t * ent , vec3_t mins , vec3_t maxs ) ;
 extern void SV_AddGravity ( edict_t * ent ) ;
@@ -426,7 +426,6 @@
 {"SV_Physics_Noclip", (byte *)SV_Physics_Noclip},
 {"SV_Physics_None", (byte *)SV_Physics_None},
 {"SV_Physics_Pusher", (byte *)SV_Physics_Pusher},
-{"SV_Push", (byte *)SV_Push},
 {"SV_PushEntity", (byte *)SV_PushEntity},
 {"RealBoundingBox", (byte *)RealBoundingBox},
 {"SV_AddGravity", (byte *)SV_AddGravity},
@@ -33,7 +33,8 @@ GLuint u_drawBrightnessAmount = 0;
 GLuint u_drawContrastAmount = 0;
 GLuint u_drawtexturecolormix = 0;
 
-#define MAX_DRAW_QUADS	2048
+// as many as 16-bit indexes can reach, so a full console of text goes in one draw
+#define MAX_DRAW_QUADS	16384
 
 typedef struct drawvert_s
 {
@@ -197,10 +198,8 @@ void Draw_End2D (void)
 }
 
 
-void Draw_GenericRect (GLuint texture, GLuint sampler, float texturecolormix, float brightness, float contrast, float x, float y, float w, float h, unsigned color, float sl, float tl, float sh, float th)
+static void Draw_SetState (GLuint texture, GLuint sampler, float texturecolormix, float brightness, float contrast)
 {
-	drawvert_t *dv = NULL;
-
 	Draw_Begin2D ();
 
 	if (texturecolormix != gl_drawstate.texturecolormix)
@@ -239,6 +238,12 @@ void Draw_GenericRect (GLuint texture, GLuint sampler, float texturecolormix, fl
 		gl_drawstate.currenttexture = texture;
 		gl_drawstate.currentsampler = sampler;
 	}
+}
+
+
+static void Draw_AddQuad (float x, float y, float w, float h, unsigned color, float sl, float tl, float sh, float th)
+{
+	drawvert_t *dv = NULL;
 
 	if (gl_drawstate.firstquad + gl_drawstate.numquads + 1 >= MAX_DRAW_QUADS)
 	{
@@ -271,6 +276,13 @@ void Draw_GenericRect (GLuint texture, GLuint sampler, float texturecolormix, fl
 }
 
 
+void Draw_GenericRect (GLuint texture, GLuint sampler, float texturecolormix, float brightness, float contrast, float x, float y, float w, float h, unsigned color, float sl, float tl, float sh, float th)
+{
+	Draw_SetState (texture, sampler, texturecolormix, brightness, contrast);
+	Draw_AddQuad (x, y, w, h, color, sl, tl, sh, th);
+}
+
+
 void Draw_TexturedRect (GLuint texnum, GLuint sampler, float x, float y, float w, float h, float sl, float tl, float sh, float th)
 {
 	Draw_GenericRect (texnum, sampler, 0.0f, vid_gamma->value, vid_contrast->value, x, y, w, h, 0xffffffff, sl, tl, sh, th);
@@ -331,6 +343,41 @@ void RE_GL_Draw_Char (int x, int y, int num)
 	RE_GL_Draw_CharScaled(x, y, num, 1.0f);
 }
 
+/*
+================
+RE_Draw_StringScaled
+
+Draws len characters side by side.  The state is only set up once for the
+whole string, and the glyphs batch with everything else until Draw_Flush.
+================
+*/
+void RE_GL_Draw_StringScaled (int x, int y, char *s, int len, float scale)
+{
+	int i, num;
+	float frow, fcol, size, scaledSize;
+
+	if (y <= -8)
+		return;			// totally off screen
+
+	size = 0.0625;
+	scaledSize = 8 * scale;
+
+	Draw_SetState (draw_chars->texnum, r_drawnearestclampsampler, 0.0f, vid_gamma->value, vid_contrast->value);
+
+	for (i = 0; i < len; i++)
+	{
+		num = s[i] & 255;
+
+		if ((num & 127) == 32)
+			continue;		// space
+
+		frow = (num >> 4) * 0.0625;
+		fcol = (num & 15) * 0.0625;
+
+		Draw_AddQuad (x + i * scaledSize, y, scaledSize, scaledSize, 0xffffffff, fcol, frow, fcol + size, frow + size);
+	}
+}
+
 /*
 =============
 RE_Draw_RegisterPic
@@ -489,6 +536,9 @@ extern unsigned	r_rawpalette[256];
 
 void RE_GL_Draw_StretchRaw (int x, int y, int w, int h, int cols, int rows, byte *data)
 {
+	int mark;
+	unsigned *data32;
+
 	Draw_End2D ();
 
 	// bind-to-modify madness here
@@ -505,8 +555,13 @@ void RE_GL_Draw_StretchRaw (int x, int y, int w, int h, int cols, int rows, byte
 	}
 
 	// update the texture
-	GL_Image8To32 (data, (unsigned *) Scratch_Alloc (), rows * cols, r_rawpalette);
-	glTextureSubImage2DEXT (r_rawtexture, GL_TEXTURE_2D, 0, 0, 0, cols, rows, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, Scratch_Alloc ());
+	mark = Scratch_Mark ();
+	data32 = (unsigned *) Scratch_Alloc (rows * cols * 4);
+
+	GL_Image8To32 (data, data32, rows * cols, r_rawpalette);
+	glTextureSubImage2DEXT (r_rawtexture, GL_TEXTURE_2D, 0, 0, 0, cols, rows, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, data32);
+
+	Scratch_Release (mark);
 
 	Draw_TexturedRect (r_rawtexture, r_drawclampsampler, x, y, w, h, 0, 0, 1, 1);
 
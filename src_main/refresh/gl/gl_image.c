@@ -23,21 +23,23 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 unsigned	d_8to24table_rgba[256];
 unsigned	d_8to24table_bgra[256];
 
-int img_base = 0;
+// image loading memory is a scope on the scratch arena
+int img_mark = -1;
 
 void *Img_Alloc (int size)
 {
-	byte *data = (byte *) Scratch_Alloc ();
+	if (img_mark < 0)
+		img_mark = Scratch_Mark ();
 
-	data += img_base;
-	img_base += size;
-
-	return data;
+	return Scratch_Alloc (size);
 }
 
 void Img_Free (void)
 {
-	img_base = 0;
+	if (img_mark >= 0)
+		Scratch_Release (img_mark);
+
+	img_mark = -1;
 }
 
 
@@ -21,84 +21,294 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "gl_local.h"
 
-#define	DLIGHT_CUTOFF	64
-
-
 /*
 =============================================================================
 
-DYNAMIC LIGHTS
+DYNAMIC LIGHT CLUSTERS
+
+Dynamic lights aren't baked into the lightmaps.  Each frame the view is cut
+into a grid of clusters, CLUSTER_X by CLUSTER_Y screen tiles by CLUSTER_Z
+slices spaced exponentially in depth, and each light is listed in every
+cluster its sphere touches.  The brush and alias shaders look up the cluster
+of each pixel and only loop over the lights listed there.
 
 =============================================================================
 */
 
+// these must match common.glsl
+#define	CLUSTER_X		16
+#define	CLUSTER_Y		8
+#define	CLUSTER_Z		24
+#define	CLUSTER_COUNT	(CLUSTER_X * CLUSTER_Y * CLUSTER_Z)
+
+// the depth range of the projection in R_SetupGL
+#define	CLUSTER_NEAR	4.0f
+#define	CLUSTER_FAR		4096.0f
+
+// light indexes shared by all the clusters, stored as bytes
+#define	MAX_CLUSTER_INDEXES	(CLUSTER_COUNT * 8)
+
+#if MAX_DLIGHTS > 256
+#error MAX_DLIGHTS must fit the byte light indexes
+#endif
+
+typedef struct lightubo_s
+{
+	float origin[MAX_DLIGHTS][4];	// w is the radius
+	float color[MAX_DLIGHTS][4];	// scaled to lightmap units
+	float forward[4];				// w is -dot (vieworg, forward) so the view depth is a single dot
+	float scale[4];					// tiles per pixel in x and y, log depth scale and bias for the slice
+	float bias[4];					// viewport origin in window coordinates
+} lightubo_t;
+
+static GLuint r_lightubo = 0;
+static GLuint r_lightubobinding = 2;
+
+static GLuint r_clustergridbuffer = 0;
+static GLuint r_clustergridtexture = 0;
+static GLuint r_clusterindexbuffer = 0;
+static GLuint r_clusterindextexture = 0;
+
+static lightubo_t r_lightuboupdate;
+
+static unsigned int r_clustergrid[CLUSTER_COUNT][2];	// first index, number of lights
+static unsigned short r_clusterfill[CLUSTER_COUNT];
+static byte r_clusterindexes[MAX_CLUSTER_INDEXES];
+
+static int r_lightfirst[MAX_DLIGHTS][3];
+static int r_lightlast[MAX_DLIGHTS][3];
+
+
 /*
 =============
-R_MarkLights
+RLight_CreateBuffers
 =============
 */
-static void R_MarkLights (dlight_t *light, int bit, mnode_t *node)
+void RLight_CreateBuffers (void)
 {
-	cplane_t	*splitplane;
-	float		dist;
-	msurface_t	*surf;
-	int			i;
+	glGenBuffers (1, &r_lightubo);
+	glNamedBufferDataEXT (r_lightubo, sizeof (lightubo_t), NULL, GL_STREAM_DRAW);
 
-	if (node->contents != -1)
-		return;
+	glGenBuffers (1, &r_clustergridbuffer);
+	glNamedBufferDataEXT (r_clustergridbuffer, sizeof (r_clustergrid), NULL, GL_STREAM_DRAW);
 
-	splitplane = node->plane;
-	dist = DotProduct (light->transformed, splitplane->normal) - splitplane->dist;
+	glGenBuffers (1, &r_clusterindexbuffer);
+	glNamedBufferDataEXT (r_clusterindexbuffer, sizeof (r_clusterindexes), NULL, GL_STREAM_DRAW);
 
-	if (dist > light->intensity - DLIGHT_CUTOFF)
-	{
-		R_MarkLights (light, bit, node->children[0]);
-		return;
-	}
+	glGenTextures (1, &r_clustergridtexture);
+	glTextureBufferEXT (r_clustergridtexture, GL_TEXTURE_BUFFER, GL_RG32UI, r_clustergridbuffer);
 
-	if (dist < -light->intensity + DLIGHT_CUTOFF)
-	{
-		R_MarkLights (light, bit, node->children[1]);
-		return;
-	}
+	glGenTextures (1, &r_clusterindextexture);
+	glTextureBufferEXT (r_clusterindextexture, GL_TEXTURE_BUFFER, GL_R8UI, r_clusterindexbuffer);
+}
 
-	// mark the polygons
-	surf = r_worldmodel->surfaces + node->firstsurface;
 
-	for (i = 0; i < node->numsurfaces; i++, surf++)
-	{
-		if (surf->dlightframe != r_framecount)
-		{
-			surf->dlightbits = 0;
-			surf->dlightframe = r_framecount;
-		}
+/*
+=============
+RLight_SetupProgram
 
-		surf->dlightbits |= bit;
-	}
+Points a program that calls DynamicLight at the light uniforms and cluster textures
+=============
+*/
+void RLight_SetupProgram (GLuint progid)
+{
+	glUniformBlockBinding (progid, glGetUniformBlockIndex (progid, "LightUniforms"), r_lightubobinding);
 
-	R_MarkLights (light, bit, node->children[0]);
-	R_MarkLights (light, bit, node->children[1]);
+	glProgramUniform1i (progid, glGetUniformLocation (progid, "clustergrid"), 4);
+	glProgramUniform1i (progid, glGetUniformLocation (progid, "clusterlights"), 5);
 }
 
 
 /*
 =============
-R_PushDlights
+R_ClusterTiles
+
+Finds the range of tiles along one screen axis covered by a sphere in front
+of the near plane.  Returns false if the sphere is off screen.
 =============
 */
-void R_PushDlights (mnode_t *headnode, glmatrix *transform)
+static qboolean R_ClusterTiles (float side, float depth, float radius, float tanfov, int numtiles, int *first, int *last)
 {
-	int		i;
-	dlight_t	*l;
+	float lo = side - radius;
+	float hi = side + radius;
+
+	// the widest projection of each edge is at the nearest depth when it's off axis on that side and the farthest when it isn't
+	lo /= ((lo < 0) ? depth - radius : depth + radius) * tanfov;
+	hi /= ((hi > 0) ? depth - radius : depth + radius) * tanfov;
+
+	if (lo > 1 || hi < -1)
+		return false;
+
+	*first = (int) ((lo * 0.5f + 0.5f) * numtiles);
+	*last = (int) ((hi * 0.5f + 0.5f) * numtiles);
+
+	if (*first < 0) *first = 0;
+	if (*last > numtiles - 1) *last = numtiles - 1;
+
+	return true;
+}
+
+
+/*
+=============
+R_ClusterSlice
+=============
+*/
+static int R_ClusterSlice (float depth)
+{
+	int slice;
+
+	if (depth <= CLUSTER_NEAR)
+		return 0;
+
+	slice = (int) (log (depth) * r_lightuboupdate.scale[2] + r_lightuboupdate.scale[3]);
+
+	if (slice < 0) return 0;
+	if (slice > CLUSTER_Z - 1) return CLUSTER_Z - 1;
+
+	return slice;
+}
+
+
+/*
+=============
+R_SetupDlights
+
+Culls the frame's dynamic lights into the cluster grid and uploads it; must
+be called after the view is set up
+=============
+*/
+void R_SetupDlights (void)
+{
+	int			i, x, y, z, c;
+	int			numlights = 0;
+	int			numindexes = 0;
+	float		tany, tanx;
+	float		depth, side, up, radius;
+	vec3_t		dist;
+	dlight_t	*dl;
+
+	tany = tan (r_newrefdef.fov_y * M_PI / 360.0);
+	tanx = tany * (float) r_newrefdef.width / (float) r_newrefdef.height;
+
+	VectorCopy (vpn, r_lightuboupdate.forward);
+	r_lightuboupdate.forward[3] = -DotProduct (r_origin, vpn);
+
+	r_lightuboupdate.scale[0] = (float) CLUSTER_X / r_newrefdef.width;
+	r_lightuboupdate.scale[1] = (float) CLUSTER_Y / r_newrefdef.height;
+	r_lightuboupdate.scale[2] = CLUSTER_Z / log (CLUSTER_FAR / CLUSTER_NEAR);
+	r_lightuboupdate.scale[3] = -log (CLUSTER_NEAR) * r_lightuboupdate.scale[2];
+
+	// keep this consistent with the viewport in R_SetupGL
+	r_lightuboupdate.bias[0] = r_newrefdef.x;
+	r_lightuboupdate.bias[1] = vid.height - r_newrefdef.height - r_newrefdef.y;
+
+	// find the clusters each light touches
+	for (i = 0, dl = r_newrefdef.dlights; i < r_newrefdef.num_dlights && gl_dynamic->value; i++, dl++)
+	{
+		radius = dl->intensity;
+
+		// negative lights aren't supported
+		if (radius <= 0)
+			continue;
+
+		VectorSubtract (dl->origin, r_origin, dist);
+		depth = DotProduct (dist, vpn);
+		side = DotProduct (dist, vright);
+		up = DotProduct (dist, vup);
+
+		if (depth + radius < CLUSTER_NEAR || depth - radius > CLUSTER_FAR)
+			continue;
+
+		if (depth - radius <= CLUSTER_NEAR)
+		{
+			// wraps around the eye so it may cover any tile
+			r_lightfirst[numlights][0] = r_lightfirst[numlights][1] = 0;
+			r_lightlast[numlights][0] = CLUSTER_X - 1;
+			r_lightlast[numlights][1] = CLUSTER_Y - 1;
+		}
+		else
+		{
+			if (!R_ClusterTiles (side, depth, radius, tanx, CLUSTER_X, &r_lightfirst[numlights][0], &r_lightlast[numlights][0]))
+				continue;
+
+			if (!R_ClusterTiles (up, depth, radius, tany, CLUSTER_Y, &r_lightfirst[numlights][1], &r_lightlast[numlights][1]))
+				continue;
+		}
+
+		r_lightfirst[numlights][2] = R_ClusterSlice (depth - radius);
+		r_lightlast[numlights][2] = R_ClusterSlice (depth + radius);
+
+		VectorCopy (dl->origin, r_lightuboupdate.origin[numlights]);
+		r_lightuboupdate.origin[numlights][3] = radius;
+
+		// lightmaps store 0..255
+		VectorScale (dl->color, 1.0f / 255.0f, r_lightuboupdate.color[numlights]);
+
+		if (gl_monolightmap->value)
+		{
+			float ntsc[] = {0.3f, 0.59f, 0.11f};
+			float gs = DotProduct (r_lightuboupdate.color[numlights], ntsc);
+
+			r_lightuboupdate.color[numlights][0] = r_lightuboupdate.color[numlights][1] = r_lightuboupdate.color[numlights][2] = gs;
+		}
+
+		numlights++;
+	}
+
+	// count the lights in each cluster
+	memset (r_clustergrid, 0, sizeof (r_clustergrid));
+
+	for (i = 0; i < numlights; i++)
+		for (z = r_lightfirst[i][2]; z <= r_lightlast[i][2]; z++)
+			for (y = r_lightfirst[i][1]; y <= r_lightlast[i][1]; y++)
+				for (x = r_lightfirst[i][0]; x <= r_lightlast[i][0]; x++)
+					r_clustergrid[(z * CLUSTER_Y + y) * CLUSTER_X + x][1]++;
+
+	// give each cluster its run of the index list, dropping whatever doesn't fit
+	for (c = 0; c < CLUSTER_COUNT; c++)
+	{
+		if (numindexes + r_clustergrid[c][1] > MAX_CLUSTER_INDEXES)
+			r_clustergrid[c][1] = MAX_CLUSTER_INDEXES - numindexes;
+
+		r_clustergrid[c][0] = numindexes;
+		numindexes += r_clustergrid[c][1];
+		r_clusterfill[c] = 0;
+	}
+
+	for (i = 0; i < numlights; i++)
+	{
+		for (z = r_lightfirst[i][2]; z <= r_lightlast[i][2]; z++)
+		{
+			for (y = r_lightfirst[i][1]; y <= r_lightlast[i][1]; y++)
+			{
+				for (x = r_lightfirst[i][0]; x <= r_lightlast[i][0]; x++)
+				{
+					c = (z * CLUSTER_Y + y) * CLUSTER_X + x;
+
+					if (r_clusterfill[c] < r_clustergrid[c][1])
+						r_clusterindexes[r_clustergrid[c][0] + r_clusterfill[c]++] = i;
+				}
+			}
+		}
+	}
+
+	glNamedBufferDataEXT (r_lightubo, sizeof (lightubo_t), NULL, GL_STREAM_DRAW);
+	glNamedBufferSubDataEXT (r_lightubo, 0, sizeof (lightubo_t), &r_lightuboupdate);
 
-	l = r_newrefdef.dlights;
+	glNamedBufferDataEXT (r_clustergridbuffer, sizeof (r_clustergrid), NULL, GL_STREAM_DRAW);
+	glNamedBufferSubDataEXT (r_clustergridbuffer, 0, sizeof (r_clustergrid), r_clustergrid);
 
-	for (i = 0; i < r_newrefdef.num_dlights; i++, l++)
+	if (numindexes)
 	{
-		// transform the light by the matrix to get it's new position for surface marking and mark the surfaces
-		GL_TransformPoint (transform, l->origin, l->transformed);
-		R_MarkLights (l, 1 << i, headnode);
+		glNamedBufferDataEXT (r_clusterindexbuffer, sizeof (r_clusterindexes), NULL, GL_STREAM_DRAW);
+		glNamedBufferSubDataEXT (r_clusterindexbuffer, 0, numindexes, r_clusterindexes);
 	}
+
+	glBindBufferBase (GL_UNIFORM_BUFFER, r_lightubobinding, r_lightubo);
+
+	GL_BindTexture (GL_TEXTURE4, GL_TEXTURE_BUFFER, 0, r_clustergridtexture);
+	GL_BindTexture (GL_TEXTURE5, GL_TEXTURE_BUFFER, 0, r_clusterindextexture);
 }
 
 
@@ -212,18 +422,14 @@ static int RecursiveLightPoint (mnode_t *node, vec3_t start, vec3_t end, float *
 
 /*
 ===============
-R_LightPoint
+R_LightPointStatic
+
+Lightmap colour under a point, without dynamic lights
 ===============
 */
-void R_LightPoint (vec3_t p, vec3_t color, float *lightspot)
+void R_LightPointStatic (vec3_t p, vec3_t color, float *lightspot)
 {
 	vec3_t		end;
-	float		r;
-	int			lnum;
-	dlight_t	*dl;
-	float		light;
-	vec3_t		dist;
-	float		add;
 	vec3_t		pointcolor;
 
 	if (!r_worldmodel->lightdata)
@@ -237,108 +443,47 @@ void R_LightPoint (vec3_t p, vec3_t color, float *lightspot)
 	end[1] = p[1];
 	end[2] = r_worldmodel->mins[2] - 10.0f;
 
-	if ((r = RecursiveLightPoint (r_worldmodel->nodes, p, end, pointcolor, lightspot)) == -1)
+	if (RecursiveLightPoint (r_worldmodel->nodes, p, end, pointcolor, lightspot) == -1)
 		VectorCopy (vec3_origin, color);
 	else
 		VectorCopy (pointcolor, color);
-
-	// add dynamic lights
-	light = 0;
-	dl = r_newrefdef.dlights;
-
-	for (lnum = 0; lnum < r_newrefdef.num_dlights; lnum++, dl++)
-	{
-		VectorSubtract (p, dl->origin, dist);
-		add = dl->intensity - VectorLength (dist);
-		add *= (1.0f / 256.0f);
-
-		if (add > 0) VectorMA (color, add, dl->color, color);
-	}
 }
 
 
-//===================================================================
-
-
 /*
 ===============
-R_AddDynamicLights
+R_LightPoint
 ===============
 */
-void R_AddDynamicLights (msurface_t *surf, float *s_blocklights)
+void R_LightPoint (vec3_t p, vec3_t color, float *lightspot)
 {
 	int			lnum;
-	int			sd, td;
-	float		fdist, frad, fminlight;
-	vec3_t		impact, local;
-	int			s, t;
-	int			i;
-	int			smax, tmax;
-	mtexinfo_t	*tex;
 	dlight_t	*dl;
-	float		*pfBL;
-	float		fsacc, ftacc;
-
-	smax = (surf->extents[0] >> 4) + 1;
-	tmax = (surf->extents[1] >> 4) + 1;
-	tex = surf->texinfo;
-
-	for (lnum = 0; lnum < r_newrefdef.num_dlights; lnum++)
-	{
-		if (!(surf->dlightbits & (1 << lnum)))
-			continue;		// not lit by this light
-
-		dl = &r_newrefdef.dlights[lnum];
-		frad = dl->intensity;
-		fdist = DotProduct (dl->transformed, surf->plane->normal) - surf->plane->dist;
-		frad -= fabs (fdist);
-
-		// rad is now the highest intensity on the plane
-		fminlight = DLIGHT_CUTOFF;	// FIXME: make configurable?
-
-		if (frad < fminlight)
-			continue;
-
-		fminlight = frad - fminlight;
-
-		for (i = 0; i < 3; i++)
-			impact[i] = dl->transformed[i] - surf->plane->normal[i] * fdist;
-
-		local[0] = DotProduct (impact, tex->vecs[0]) + tex->vecs[0][3] - surf->texturemins[0];
-		local[1] = DotProduct (impact, tex->vecs[1]) + tex->vecs[1][3] - surf->texturemins[1];
-
-		pfBL = s_blocklights;
-
-		for (t = 0, ftacc = 0; t < tmax; t++, ftacc += 16)
-		{
-			td = local[1] - ftacc;
+	vec3_t		dist;
+	float		add;
 
-			if (td < 0)
-				td = -td;
+	R_LightPointStatic (p, color, lightspot);
 
-			for (s = 0, fsacc = 0; s < smax; s++, fsacc += 16, pfBL += 3)
-			{
-				sd = Q_ftol (local[0] - fsacc);
+	if (!r_worldmodel->lightdata)
+		return;
 
-				if (sd < 0)
-					sd = -sd;
+	// add dynamic lights
+	dl = r_newrefdef.dlights;
 
-				if (sd > td)
-					fdist = sd + (td >> 1);
-				else fdist = td + (sd >> 1);
+	for (lnum = 0; lnum < r_newrefdef.num_dlights; lnum++, dl++)
+	{
+		VectorSubtract (p, dl->origin, dist);
+		add = dl->intensity - VectorLength (dist);
+		add *= (1.0f / 256.0f);
 
-				if (fdist < fminlight)
-				{
-					pfBL[0] += (fminlight - fdist) * dl->color[0];
-					pfBL[1] += (fminlight - fdist) * dl->color[1];
-					pfBL[2] += (fminlight - fdist) * dl->color[2];
-				}
-			}
-		}
+		if (add > 0) VectorMA (color, add, dl->color, color);
 	}
 }
 
 
+//===================================================================
+
+
 /*
 R_SetCacheState
 */
@@ -348,8 +493,6 @@ void R_SetCacheState (msurface_t *surf)
 
 	for (maps = 0; maps < MAXLIGHTMAPS && surf->styles[maps] != 255; maps++)
 		surf->cached_light[maps] = r_newrefdef.lightstyles[surf->styles[maps]].white;
-
-	surf->cached_dlight = (surf->dlightframe == r_framecount);
 }
 
 /*
@@ -428,10 +571,6 @@ void R_BuildLightMap (msurface_t *surf, unsigned *dest, int stride)
 		}
 	}
 
-	// add all the dynamic lights
-	if (surf->dlightframe == r_framecount)
-		R_AddDynamicLights (surf, s_blocklights);
-
 	// put into texture format
 	bl = s_blocklights;
 
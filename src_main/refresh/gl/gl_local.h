@@ -295,7 +295,11 @@ void RImage_CreateSamplers (void);
 void GL_BindTexture (GLenum tmu, GLenum target, GLuint sampler, GLuint texnum);
 
 void R_LightPoint (vec3_t p, vec3_t color, float *lightspot);
-void R_PushDlights (mnode_t *headnode, glmatrix *transform);
+void R_LightPointStatic (vec3_t p, vec3_t color, float *lightspot);
+
+void RLight_CreateBuffers (void);
+void RLight_SetupProgram (GLuint progid);
+void R_SetupDlights (void);
 
 //====================================================================
 
@@ -332,6 +336,7 @@ void RE_GL_Draw_PicScaled (int x, int y, char *name, float scale);
 void RE_GL_Draw_StretchPic (int x, int y, int w, int h, char *name);
 void RE_GL_Draw_Char (int x, int y, int c);
 void RE_GL_Draw_CharScaled (int x, int y, int num, float scale);
+void RE_GL_Draw_StringScaled (int x, int y, char *s, int len, float scale);
 void RE_GL_Draw_TileClear (int x, int y, int w, int h, char *name);
 void RE_GL_Draw_Fill (int x, int y, int w, int h, int c);
 void RE_GL_Draw_FadeScreen (void);
@@ -345,6 +350,7 @@ void RE_GL_SetPalette (const unsigned char *palette);
 
 void RE_GL_BeginRegistration(char *model);
 struct model_s *RE_GL_RegisterModel(char *name);
+float RE_GL_ModelRadius(struct model_s *model);
 struct image_s *RE_GL_RegisterSkin(char *name);
 struct image_s *RE_GL_Draw_RegisterPic(char *name);
 void RE_GL_SetSky(char *name, float rotate, vec3_t axis);
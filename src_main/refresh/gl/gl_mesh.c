@@ -69,6 +69,7 @@ float r_avertexnormals[NUMVERTEXNORMALS][3] =
 typedef struct meshubo_s
 {
 	glmatrix localMatrix;
+	glmatrix entityMatrix;
 	float move[4];
 	float frontv[4];
 	float backv[4];
@@ -77,6 +78,7 @@ typedef struct meshubo_s
 	float lerpfrac;
 	float powersuitscale;
 	float shellmix;
+	float dlightscale;
 } meshubo_t;
 
 
@@ -110,6 +112,8 @@ void RMesh_CreatePrograms (void)
 	glProgramUniform1i (gl_meshprog, glGetUniformLocation (gl_meshprog, "diffuse"), 0);
 	glProgramUniform3fv (gl_meshprog, glGetUniformLocation (gl_meshprog, "lightnormal"), 162, (float *) r_avertexnormals);
 
+	RLight_SetupProgram (gl_meshprog);
+
 	glGenBuffers (1, &gl_meshubo);
 	glNamedBufferDataEXT (gl_meshubo, MESH_UBO_MAX_BLOCKS * gl_meshuboblocksize, NULL, GL_STREAM_DRAW);
 }
@@ -207,6 +211,10 @@ void GL_DrawAliasFrameLerp (entity_t *e, dmdl_t *hdr, float backlerp, qboolean s
 	gl_meshuboupdate.shadelight[3] = alpha;
 	gl_meshuboupdate.lerpfrac = backlerp;
 
+	// shadows don't pick up dynamic lights
+	if (shadow)
+		gl_meshuboupdate.dlightscale = 0.0f;
+
 	if (e->model->lastcurrframe != e->currframe)
 	{
 		glVertexArrayVertexAttribOffsetEXT (e->model->meshvao, e->model->meshvbo, 0, 4, GL_UNSIGNED_BYTE, GL_FALSE, sizeof (posevert_t), VERTOFFSET (e->currframe));
@@ -391,6 +399,7 @@ void R_DrawAliasModel (entity_t *e)
 	if (e->flags & (RF_SHELL_HALF_DAM | RF_SHELL_GREEN | RF_SHELL_RED | RF_SHELL_BLUE | RF_SHELL_DOUBLE))
 	{
 		VectorClear (gl_meshuboupdate.shadelight);
+		gl_meshuboupdate.dlightscale = 0.0f;
 
 		if (e->flags & RF_SHELL_HALF_DAM)
 		{
@@ -414,28 +423,36 @@ void R_DrawAliasModel (entity_t *e)
 		gl_meshuboupdate.shadelight[0] = 1.0;
 		gl_meshuboupdate.shadelight[1] = 1.0;
 		gl_meshuboupdate.shadelight[2] = 1.0;
+		gl_meshuboupdate.dlightscale = 0.0f;
 	}
 	else
 	{
-		R_LightPoint (e->currorigin, gl_meshuboupdate.shadelight, lightspot);
+		// dynamic lights are added per pixel in the shader
+		R_LightPointStatic (e->currorigin, gl_meshuboupdate.shadelight, lightspot);
+		gl_meshuboupdate.dlightscale = r_lightscale->value * 2.0f;
 
 		// player lighting hack for communication back to server
-		// big hack!
+		// big hack!  the server wants muzzle flashes and the like
+		// counted, so this goes through R_LightPoint with the dlights
 		if (e->flags & RF_WEAPONMODEL)
 		{
+			vec3_t	level;
+
+			R_LightPoint (e->currorigin, level, lightspot);
+
 			// pick the greatest component, which should be the same
 			// as the mono value returned by software
-			if (gl_meshuboupdate.shadelight[0] > gl_meshuboupdate.shadelight[1])
+			if (level[0] > level[1])
 			{
-				if (gl_meshuboupdate.shadelight[0] > gl_meshuboupdate.shadelight[2])
-					r_lightlevel->value = 150 * gl_meshuboupdate.shadelight[0];
-				else r_lightlevel->value = 150 * gl_meshuboupdate.shadelight[2];
+				if (level[0] > level[2])
+					r_lightlevel->value = 150 * level[0];
+				else r_lightlevel->value = 150 * level[2];
 			}
 			else
 			{
-				if (gl_meshuboupdate.shadelight[1] > gl_meshuboupdate.shadelight[2])
-					r_lightlevel->value = 150 * gl_meshuboupdate.shadelight[1];
-				else r_lightlevel->value = 150 * gl_meshuboupdate.shadelight[2];
+				if (level[1] > level[2])
+					r_lightlevel->value = 150 * level[1];
+				else r_lightlevel->value = 150 * level[2];
 			}
 		}
 	}
@@ -478,6 +495,7 @@ void R_DrawAliasModel (entity_t *e)
 		gl_meshuboupdate.shadelight[0] = 1.0;
 		gl_meshuboupdate.shadelight[1] = 0.0;
 		gl_meshuboupdate.shadelight[2] = 0.0;
+		gl_meshuboupdate.dlightscale = 0.0f;
 	}
 
 	an = e->angles[1] / 180 * M_PI;
@@ -514,6 +532,13 @@ void R_DrawAliasModel (entity_t *e)
 	GL_RotateMatrix (&gl_meshuboupdate.localMatrix, e->angles[0], 0, 1, 0);
 	GL_RotateMatrix (&gl_meshuboupdate.localMatrix, -e->angles[2], 1, 0, 0);
 
+	// the same transform without the view, for the world position of dynamic lights
+	GL_LoadIdentity (&gl_meshuboupdate.entityMatrix);
+	GL_TranslateMatrix (&gl_meshuboupdate.entityMatrix, e->currorigin[0], e->currorigin[1], e->currorigin[2]);
+	GL_RotateMatrix (&gl_meshuboupdate.entityMatrix, e->angles[1], 0, 0, 1);
+	GL_RotateMatrix (&gl_meshuboupdate.entityMatrix, e->angles[0], 0, 1, 0);
+	GL_RotateMatrix (&gl_meshuboupdate.entityMatrix, -e->angles[2], 1, 0, 0);
+
 	// select skin
 	if (e->skin)
 		skin = e->skin;	// custom player skin
@@ -618,10 +643,32 @@ void R_DrawAliasModel (entity_t *e)
 ==============================================================================
 */
 
+int RMesh_CountGLCmdVerts (dmdl_t *hdr)
+{
+	int *order = (int *) ((byte *) hdr + hdr->ofs_glcmds);
+	int numverts = 0;
+
+	while (1)
+	{
+		int count = *order++;
+
+		if (!count) break;
+		if (count < 0) count = -count;
+
+		order += count * 3;
+		numverts += count;
+	}
+
+	return numverts;
+}
+
+
 void RMesh_CreateFrames (model_t *mod, dmdl_t *hdr)
 {
 	int i, frame;
-	posevert_t *verts = (posevert_t *) Scratch_Alloc ();
+	int mark = Scratch_Mark ();
+	posevert_t *base = (posevert_t *) Scratch_Alloc (hdr->num_frames * RMesh_CountGLCmdVerts (hdr) * sizeof (posevert_t));
+	posevert_t *verts = base;
 	int numverts = 0;
 
 	glGenBuffers (1, &mod->meshvbo);
@@ -651,13 +698,17 @@ void RMesh_CreateFrames (model_t *mod, dmdl_t *hdr)
 		}
 	}
 
-	glNamedBufferDataEXT (mod->meshvbo, numverts * sizeof (posevert_t), Scratch_Alloc (), GL_STATIC_DRAW);
+	glNamedBufferDataEXT (mod->meshvbo, numverts * sizeof (posevert_t), base, GL_STATIC_DRAW);
+
+	Scratch_Release (mark);
 }
 
 
 void RMesh_CreateTexCoords (model_t *mod, dmdl_t *hdr)
 {
-	mdlst_t *st = (mdlst_t *) Scratch_Alloc ();
+	int mark = Scratch_Mark ();
+	mdlst_t *base = (mdlst_t *) Scratch_Alloc (RMesh_CountGLCmdVerts (hdr) * sizeof (mdlst_t));
+	mdlst_t *st = base;
 	int *order = (int *) ((byte *) hdr + hdr->ofs_glcmds);
 
 	mod->numframeverts = 0;
@@ -682,13 +733,17 @@ void RMesh_CreateTexCoords (model_t *mod, dmdl_t *hdr)
 		mod->numframeverts += count;
 	}
 
-	glNamedBufferDataEXT (mod->texcoordvbo, mod->numframeverts * sizeof (mdlst_t), Scratch_Alloc (), GL_STATIC_DRAW);
+	glNamedBufferDataEXT (mod->texcoordvbo, mod->numframeverts * sizeof (mdlst_t), base, GL_STATIC_DRAW);
+
+	Scratch_Release (mark);
 }
 
 
 void RMesh_CreateIndexes (model_t *mod, dmdl_t *hdr)
 {
-	unsigned short *ndx = (unsigned short *) Scratch_Alloc ();
+	int mark = Scratch_Mark ();
+	unsigned short *base = (unsigned short *) Scratch_Alloc (RMesh_CountGLCmdVerts (hdr) * 3 * sizeof (unsigned short));
+	unsigned short *ndx = base;
 	int *order = (int *) ((byte *) hdr + hdr->ofs_glcmds);
 	int firstvertex = 0;
 
@@ -728,7 +783,9 @@ void RMesh_CreateIndexes (model_t *mod, dmdl_t *hdr)
 		mod->numindexes += (count - 2) * 3;
 	}
 
-	glNamedBufferDataEXT (mod->indexbuffer, mod->numindexes * sizeof (unsigned short), Scratch_Alloc (), GL_STATIC_DRAW);
+	glNamedBufferDataEXT (mod->indexbuffer, mod->numindexes * sizeof (unsigned short), base, GL_STATIC_DRAW);
+
+	Scratch_Release (mark);
 }
 
 
@@ -264,17 +264,17 @@ model_t *Mod_ForName (char *name, qboolean crash)
 	switch (LittleLong (*(unsigned *) buf))
 	{
 	case IDALIASHEADER:
-		loadmodel->extradata = Hunk_Begin (0x800000);
+		loadmodel->extradata = Hunk_Begin (0x800000, mod->name);
 		Mod_LoadAliasModel (mod, buf);
 		break;
 
 	case IDSPRITEHEADER:
-		loadmodel->extradata = Hunk_Begin (0x40000);
+		loadmodel->extradata = Hunk_Begin (0x40000, mod->name);
 		Mod_LoadSpriteModel (mod, buf);
 		break;
 
 	case IDBSPHEADER:
-		loadmodel->extradata = Hunk_Begin (0x4000000);
+		loadmodel->extradata = Hunk_Begin (0x4000000, mod->name);
 		Mod_LoadBrushModel (mod, buf);
 		break;
 
@@ -1028,6 +1028,8 @@ void Mod_LoadAliasModel (model_t *mod, void *buffer)
 	daliasframe_t		*pinframe, *poutframe;
 	int					*pincmd, *poutcmd;
 	int					version;
+	vec3_t				mins, maxs;
+	float				radius;
 
 	pinmodel = (dmdl_t *) buffer;
 
@@ -1084,6 +1086,8 @@ void Mod_LoadAliasModel (model_t *mod, void *buffer)
 	}
 
 	// load the frames
+	mod->radius = 0;
+
 	for (i = 0; i < pheader->num_frames; i++)
 	{
 		pinframe = (daliasframe_t *) ((byte *) pinmodel + pheader->ofs_frames + i * pheader->framesize);
@@ -1100,6 +1104,17 @@ void Mod_LoadAliasModel (model_t *mod, void *buffer)
 		// verts are all 8 bit, so no swapping needed
 		memcpy (poutframe->verts, pinframe->verts, pheader->num_xyz * sizeof (dtrivertx_t));
 
+		// how far the model reaches from its origin in any frame
+		for (j = 0; j < 3; j++)
+		{
+			mins[j] = poutframe->translate[j];
+			maxs[j] = poutframe->translate[j] + poutframe->scale[j] * 255;
+		}
+
+		radius = RadiusFromBounds (mins, maxs);
+
+		if (radius > mod->radius)
+			mod->radius = radius;
 	}
 
 	mod->type = mod_alias;
@@ -1256,6 +1271,22 @@ struct model_s *RE_GL_RegisterModel (char *name)
 	return mod;
 }
 
+/*
+=====================
+RE_ModelRadius
+
+How far an alias model reaches from its origin over all of its frames,
+or 0 if it isn't known
+=====================
+*/
+float RE_GL_ModelRadius (struct model_s *model)
+{
+	if (!model || model->type != mod_alias)
+		return 0;
+
+	return model->radius;
+}
+
 
 /*
 =====================
@@ -100,7 +100,6 @@ typedef struct msurface_s
 	short		extents[2];
 
 	int			light_s, light_t;	// gl lightmap coordinates
-	int			dlight_s, dlight_t; // gl lightmap coordinates for dynamic lightmaps
 
 	struct msurface_s	*texturechain;
 	struct msurface_s	*reversechain;
@@ -108,10 +107,6 @@ typedef struct msurface_s
 	mtexinfo_t	*texinfo;
 
 	// lighting info
-	int			dlightframe;
-	int			dlightbits;
-	qboolean	cached_dlight;
-
 	RECT		lightrect;
 	int			lightmaptexturenum;
 	byte		styles[MAXLIGHTMAPS];
@@ -259,7 +254,7 @@ byte	*Mod_ClusterPVS (int cluster, model_t *model);
 
 void	Mod_Modellist_f (void);
 
-void	*Hunk_Begin (int maxsize);
+void	*Hunk_Begin (int maxsize, char *name);
 void	*Hunk_Alloc (int size);
 int		Hunk_End (void);
 void	Hunk_Free (void *base);
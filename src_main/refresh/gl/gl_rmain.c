@@ -367,6 +367,9 @@ void R_SetupGL (void)
 	RSky_BeginFrame ();
 	RWarp_BeginFrame ();
 	RSurf_BeginFrame ();
+
+	// cull dynamic lights into the view clusters
+	R_SetupDlights ();
 }
 
 
@@ -917,6 +920,9 @@ int RE_GL_Init (void)
 	glGenBuffers (1, &gl_sharedubo);
 	glNamedBufferDataEXT (gl_sharedubo, sizeof (sharedubo_t), NULL, GL_STREAM_DRAW);
 
+	// and the buffers for dynamic light clusters
+	RLight_CreateBuffers ();
+
 	VID_MenuInit ();
 
 	GL_SetDefaultState ();
@@ -1060,6 +1066,7 @@ void GL_GFX_CoreInit(void)
 	RE_Draw_TileClear = RE_GL_Draw_TileClear;
 	RE_Draw_CharScaled = RE_GL_Draw_CharScaled;
 	RE_Draw_Char = RE_GL_Draw_Char;
+	RE_Draw_StringScaled = RE_GL_Draw_StringScaled;
 	RE_Draw_StretchPic = RE_GL_Draw_StretchPic;
 	RE_Draw_PicScaled = RE_GL_Draw_PicScaled;
 	RE_Draw_Pic = RE_GL_Draw_Pic;
@@ -1067,6 +1074,7 @@ void GL_GFX_CoreInit(void)
 
 	RE_BeginRegistration = RE_GL_BeginRegistration;
 	RE_RegisterModel = RE_GL_RegisterModel;
+	RE_ModelRadius = RE_GL_ModelRadius;
 	RE_RegisterSkin = RE_GL_RegisterSkin;
 	RE_Draw_RegisterPic = RE_GL_Draw_RegisterPic;
 	RE_SetSky = RE_GL_SetSky;
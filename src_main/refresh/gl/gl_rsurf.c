@@ -65,6 +65,7 @@ int gl_maxindexes = 0;
 GLuint gl_lightmappedsurfprog = 0;
 
 GLuint u_brushlocalMatrix;
+GLuint u_brushentityMatrix;
 GLuint u_brushcolormatrix;
 GLuint u_brushsurfalpha;
 GLuint u_brushscroll;
@@ -88,10 +89,13 @@ void RSurf_CreatePrograms (void)
 	glProgramUniform1i (gl_lightmappedsurfprog, glGetUniformLocation (gl_lightmappedsurfprog, "lightmap"), 2);
 
 	u_brushlocalMatrix = glGetUniformLocation (gl_lightmappedsurfprog, "localMatrix");
+	u_brushentityMatrix = glGetUniformLocation (gl_lightmappedsurfprog, "entityMatrix");
 	u_brushcolormatrix = glGetUniformLocation (gl_lightmappedsurfprog, "colormatrix");
 	u_brushsurfalpha = glGetUniformLocation (gl_lightmappedsurfprog, "surfalpha");
 	u_brushscroll = glGetUniformLocation (gl_lightmappedsurfprog, "scroll");
 
+	RLight_SetupProgram (gl_lightmappedsurfprog);
+
 	glGenBuffers (1, &r_surfaceubo);
 	glNamedBufferDataEXT (r_surfaceubo, SURF_UBO_MAX_BLOCKS * r_surfuboblocksize, NULL, GL_STREAM_DRAW);
 
@@ -209,12 +213,13 @@ void RSurf_BeginFrame (void)
 }
 
 
-void RSurf_SelectProgramAndStates (glmatrix *matrix, float alpha)
+void RSurf_SelectProgramAndStates (glmatrix *matrix, glmatrix *entmatrix, float alpha)
 {
 	int i;
 	qboolean stateset = false;
 
 	glProgramUniformMatrix4fv (gl_lightmappedsurfprog, u_brushlocalMatrix, 1, GL_FALSE, matrix->m[0]);
+	glProgramUniformMatrix4fv (gl_lightmappedsurfprog, u_brushentityMatrix, 1, GL_FALSE, entmatrix->m[0]);
 	glProgramUniform1f (gl_lightmappedsurfprog, u_brushsurfalpha, alpha);
 
 	GL_UseProgram (gl_lightmappedsurfprog);
@@ -278,9 +283,12 @@ void R_DrawAlphaSurfaces (void)
 	int lastsurfflags = -1;
 	msurface_t *reversechain = NULL;
 	int numindexes = 0;
+	glmatrix entmatrix;
 
 	if (!r_alpha_surfaces) return;
 
+	GL_LoadIdentity (&entmatrix);
+
 	GL_BindVertexArray (r_surfacevao);
 	GL_Enable (DEPTHTEST_BIT | (gl_cull->value ? CULLFACE_BIT : 0) | BLEND_BIT);
 
@@ -298,7 +306,7 @@ void R_DrawAlphaSurfaces (void)
 
 			if (s->flags & SURF_DRAWTURB)
 				R_BeginWaterPolys (&r_mvpmatrix, alpha);
-			else RSurf_SelectProgramAndStates (&r_mvpmatrix, alpha);
+			else RSurf_SelectProgramAndStates (&r_mvpmatrix, &entmatrix, alpha);
 
 			lastsurfflags = s->flags;
 			lasttexture = s->texinfo->image;
@@ -359,7 +367,7 @@ void R_DrawSurfaceChain (msurface_t *chain, int numindexes)
 }
 
 
-void R_DrawTextureChains (entity_t *e)
+void R_DrawTextureChains (entity_t *e, glmatrix *entmatrix)
 {
 	int i;
 	image_t *image = NULL;
@@ -373,11 +381,11 @@ void R_DrawTextureChains (entity_t *e)
 	if (e->flags & RF_TRANSLUCENT)
 	{
 		GL_Enable (DEPTHTEST_BIT | (gl_cull->value ? CULLFACE_BIT : 0) | BLEND_BIT);
-		RSurf_SelectProgramAndStates (matrix, 0.25);
+		RSurf_SelectProgramAndStates (matrix, entmatrix, 0.25);
 	}
 	else
 	{
-		RSurf_SelectProgramAndStates (matrix, 1);
+		RSurf_SelectProgramAndStates (matrix, entmatrix, 1);
 		GL_Enable (DEPTHTEST_BIT | (gl_cull->value ? CULLFACE_BIT : 0) | DEPTHWRITE_BIT);
 	}
 
@@ -453,17 +461,13 @@ void R_ModifySurfaceLightmap (msurface_t *surf)
 	if (surf->texinfo->flags & SURF_SKY) return;
 	if (surf->texinfo->flags & SURF_WARP) return;
 
+	// only a lightstyle change rebuilds the lightmap; dynamic lights are added per pixel
 	for (map = 0; map < MAXLIGHTMAPS && surf->styles[map] != 255; map++)
-		if (r_newrefdef.lightstyles[surf->styles[map]].white != surf->cached_light[map])
-			goto dynamic;
-
-	// dynamic this frame or dynamic previously
-	if ((surf->dlightframe == r_framecount) || surf->cached_dlight)
 	{
-dynamic:;
-		if (gl_dynamic->value)
+		if (r_newrefdef.lightstyles[surf->styles[map]].white != surf->cached_light[map])
 		{
-			is_dynamic = true;
+			is_dynamic = (gl_dynamic->value != 0);
+			break;
 		}
 	}
 
@@ -526,7 +530,7 @@ void R_DrawInlineBModel (entity_t *e)
 	msurface_t	*surf;
 	glmatrix	localMatrix;
 
-	// compute everything on the local matrix so that we can use it for lighting transforms
+	// compute everything on the local matrix so that the shader can find world positions for dynamic lights
 	GL_LoadIdentity (&localMatrix);
 	GL_TranslateMatrix (&localMatrix, e->currorigin[0], e->currorigin[1], e->currorigin[2]);
 
@@ -534,12 +538,8 @@ void R_DrawInlineBModel (entity_t *e)
 	GL_RotateMatrix (&localMatrix, e->angles[0], 0, 1, 0);
 	GL_RotateMatrix (&localMatrix, e->angles[2], 1, 0, 0);
 
-	// now multiply out for the final model transform and take it's inverse for lighting
+	// now multiply out for the final model transform
 	GL_MultMatrix (&e->matrix, &localMatrix, &r_mvpmatrix);
-	GL_InvertMatrix (&localMatrix, NULL, &localMatrix);
-
-	// and now calculate dynamic lighting for bmodel
-	R_PushDlights (e->model->nodes + e->model->firstnode, &localMatrix);
 
 	surf = &e->model->surfaces[e->model->firstmodelsurface];
 
@@ -558,7 +558,7 @@ void R_DrawInlineBModel (entity_t *e)
 		}
 	}
 
-	R_DrawTextureChains (e);
+	R_DrawTextureChains (e, &localMatrix);
 }
 
 
@@ -746,11 +746,11 @@ void R_DrawWorld (void)
 	ent.model = r_worldmodel;
 	memcpy (&ent.matrix, &r_mvpmatrix, sizeof (glmatrix));
 
-	R_PushDlights (r_worldmodel->nodes, GL_LoadIdentity (&localMatrix));
+	GL_LoadIdentity (&localMatrix);
 
 	R_RecursiveWorldNode (r_worldmodel->nodes);
 
-	R_DrawTextureChains (&ent);
+	R_DrawTextureChains (&ent, &localMatrix);
 }
 
 
@@ -1051,7 +1051,6 @@ void GL_CreateSurfaceLightmap (msurface_t *surf)
 	}
 
 	surf->lightmaptexturenum = gl_lms.current_lightmap_texture;
-	surf->dlightframe = -1;
 
 	surf->lightrect.left = surf->light_s;
 	surf->lightrect.top = surf->light_t;
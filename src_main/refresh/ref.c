@@ -38,6 +38,7 @@ void            (* RE_Draw_Fill)( int x, int y, int w, int h, int c ) = NULL;
 void            (* RE_Draw_TileClear)( int x, int y, int w, int h, char *pic ) = NULL;
 void            (* RE_Draw_CharScaled)( int x, int y, int num, float scale ) = NULL;
 void            (* RE_Draw_Char)( int x, int y, int num ) = NULL;
+void            (* RE_Draw_StringScaled)( int x, int y, char *s, int len, float scale ) = NULL;
 void		    (* RE_Draw_StretchPic)( int x, int y, int w, int h, char *pic ) = NULL;
 void            (* RE_Draw_PicScaled)( int x, int y, char *pic, float scale ) = NULL;
 void	        (* RE_Draw_Pic)( int x, int y, char *pic ) = NULL;
@@ -45,6 +46,7 @@ void            (* RE_Draw_GetPicSize)( int *w, int *h, char *pic ) = NULL;
 
 void            (* RE_BeginRegistration)( char *model ) = NULL;
 struct model_s * (* RE_RegisterModel)( char *name ) = NULL;
+float           (* RE_ModelRadius)( struct model_s *model ) = NULL;
 struct image_s * (* RE_RegisterSkin)( char *name ) = NULL;
 struct image_s * (* RE_Draw_RegisterPic)( char *name ) = NULL;
 void            (* RE_SetSky)( char *name, float rotate, vec3_t axis ) = NULL;
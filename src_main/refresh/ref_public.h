@@ -64,9 +64,9 @@ glmatrix *GL_PerspectiveMatrix (glmatrix *m, float fovy, float aspect, float zNe
 void GL_TransformPoint (glmatrix *m, float *in, float *out);
 
 
-#define	MAX_DLIGHTS		32
+#define	MAX_DLIGHTS		128		// gl culls these per view cluster; soft only marks the first 32
 #define	MAX_ENTITIES	1024	// same as max_edicts
-#define	MAX_PARTICLES	16000
+#define	MAX_PARTICLES	65536
 #define	MAX_LIGHTSTYLES	256
 
 #define POWERSUIT_SCALE		4.0f
@@ -201,6 +201,7 @@ extern void(*RE_Draw_Fill)(int x, int y, int w, int h, int c);
 extern void(*RE_Draw_TileClear)(int x, int y, int w, int h, char *pic);
 extern void(*RE_Draw_CharScaled)(int x, int y, int num, float scale);
 extern void(*RE_Draw_Char)(int x, int y, int num);
+extern void(*RE_Draw_StringScaled)(int x, int y, char *s, int len, float scale);
 extern void(*RE_Draw_StretchPic)(int x, int y, int w, int h, char *pic);
 extern void(*RE_Draw_PicScaled)(int x, int y, char *pic, float scale);
 extern void(*RE_Draw_Pic)(int x, int y, char *pic);
@@ -208,6 +209,7 @@ extern void(*RE_Draw_GetPicSize)(int *w, int *h, char *pic);
 
 extern void(*RE_BeginRegistration)(char *model);
 extern struct model_s * (*RE_RegisterModel)(char *name);
+extern float(*RE_ModelRadius)(struct model_s *model);
 extern struct image_s * (*RE_RegisterSkin)(char *name);
 extern struct image_s * (*RE_Draw_RegisterPic)(char *name);
 extern void(*RE_SetSky)(char *name, float rotate, vec3_t axis);
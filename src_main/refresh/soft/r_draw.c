@@ -125,6 +125,19 @@ void RE_SW_Draw_CharScaled(int x, int y, int num, float scale)
 	}
 }
 
+/*
+================
+RE_Draw_StringScaled
+================
+*/
+void RE_SW_Draw_StringScaled(int x, int y, char *s, int len, float scale)
+{
+	int		i;
+
+	for (i=0 ; i<len ; i++, x += 8 * (int) scale)
+		RE_SW_Draw_CharScaled (x, y, s[i], scale);
+}
+
 /*
 =============
 RE_Draw_GetPicSize
@@ -23,6 +23,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 int	r_dlightframecount;
 
+#define	MAX_SURF_DLIGHTS	32		// one bit each in dlightbits
+
 
 /*
 =============================================================================
@@ -97,7 +99,7 @@ void SW_R_PushDlights (model_t *model)
 	dlight_t	*l;
 
 	r_dlightframecount = r_framecount;
-	for (i=0, l = r_newrefdef.dlights ; i<r_newrefdef.num_dlights ; i++, l++)
+	for (i=0, l = r_newrefdef.dlights ; i<r_newrefdef.num_dlights && i<MAX_SURF_DLIGHTS ; i++, l++)
 	{
 		R_MarkLights ( l, 1<<i,
 			model->nodes + model->firstnode);
@@ -298,7 +300,7 @@ void SW_R_AddDynamicLights(void)
 	tmax = (surf->extents[1]>>4)+1;
 	tex = surf->texinfo;
 
-	for (lnum=0 ; lnum<r_newrefdef.num_dlights ; lnum++)
+	for (lnum=0 ; lnum<r_newrefdef.num_dlights && lnum<MAX_SURF_DLIGHTS ; lnum++)
 	{
 		if (!(surf->dlightbits & (1<<lnum)))
 			continue;	// not lit by this light
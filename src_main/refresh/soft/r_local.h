@@ -707,6 +707,7 @@ void D_FlushCaches(void);
 void	R_ScreenShot_f( void );
 void    RE_SW_BeginRegistration (char *map);
 struct model_s  *RE_SW_RegisterModel (char *name);
+float   RE_SW_ModelRadius (struct model_s *model);
 struct image_s *RE_SW_RegisterSkin (char *name);
 void    RE_SW_EndRegistration (void);
 
@@ -719,6 +720,7 @@ void	RE_SW_Draw_FadeScreen (void);
 void	RE_SW_Draw_Fill (int x, int y, int w, int h, int c);
 void	RE_SW_Draw_TileClear (int x, int y, int w, int h, char *name);
 void	RE_SW_Draw_CharScaled (int x, int y, int num, float scale);
+void	RE_SW_Draw_StringScaled (int x, int y, char *s, int len, float scale);
 void	RE_SW_Draw_StretchPic (int x, int y, int w, int h, char *name);
 void	RE_SW_Draw_PicScaled (int x, int y, char *name, float scale);
 void	RE_SW_Draw_GetPicSize (int *w, int *h, char *name);
@@ -1881,6 +1881,7 @@ void SW_GFX_CoreInit(void)
 	RE_Draw_TileClear = RE_SW_Draw_TileClear;
 	RE_Draw_CharScaled = RE_SW_Draw_CharScaled;
 	RE_Draw_Char = NULL;
+	RE_Draw_StringScaled = RE_SW_Draw_StringScaled;
 	RE_Draw_StretchPic = RE_SW_Draw_StretchPic;
 	RE_Draw_PicScaled = RE_SW_Draw_PicScaled;
 	RE_Draw_Pic = NULL;
@@ -1888,6 +1889,7 @@ void SW_GFX_CoreInit(void)
 
 	RE_BeginRegistration = RE_SW_BeginRegistration;
 	RE_RegisterModel = RE_SW_RegisterModel;
+	RE_ModelRadius = RE_SW_ModelRadius;
 	RE_RegisterSkin = RE_SW_RegisterSkin;
 	RE_Draw_RegisterPic = RE_SW_Draw_RegisterPic;
 	RE_SetSky = RE_SW_SetSky;
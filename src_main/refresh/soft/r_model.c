@@ -153,17 +153,17 @@ model_t *SW_Mod_ForName(char *name, qboolean crash)
 	switch (LittleLong(*(unsigned *)buf))
 	{
 	case IDALIASHEADER:
-		loadmodel->extradata = Hunk_Begin (0x800000);
+		loadmodel->extradata = Hunk_Begin (0x800000, mod->name);
 		SW_Mod_LoadAliasModel(mod, buf);
 		break;
 
 	case IDSPRITEHEADER:
-		loadmodel->extradata = Hunk_Begin (0x40000);
+		loadmodel->extradata = Hunk_Begin (0x40000, mod->name);
 		SW_Mod_LoadSpriteModel(mod, buf);
 		break;
 
 	case IDBSPHEADER:
-		loadmodel->extradata = Hunk_Begin (0x4000000);
+		loadmodel->extradata = Hunk_Begin (0x4000000, mod->name);
 		SW_Mod_LoadBrushModel(mod, buf);
 		break;
 
@@ -1042,9 +1042,13 @@ void SW_Mod_LoadAliasModel(model_t *mod, void *buffer)
 	//
 	// load the frames
 	//
+	mod->radius = 0;
+
 	for (i=0 ; i<pheader->num_frames ; i++)
 	{
 		daliasframe_t *pinframe, *poutframe;
+		vec3_t		corner;
+		float		radius;
 
 		pinframe = (daliasframe_t *) ((byte *)pinmodel
 			+ pheader->ofs_frames + i * pheader->framesize);
@@ -1061,6 +1065,13 @@ void SW_Mod_LoadAliasModel(model_t *mod, void *buffer)
 		memcpy (poutframe->verts, pinframe->verts,
 			pheader->num_xyz*sizeof(dtrivertx_t));
 
+		// how far the model reaches from its origin in any frame
+		for (j=0 ; j<3 ; j++)
+			corner[j] = max (fabs (poutframe->translate[j]),
+				fabs (poutframe->translate[j] + poutframe->scale[j]*255));
+		radius = VectorLength (corner);
+		if (radius > mod->radius)
+			mod->radius = radius;
 	}
 
 	mod->type = mod_alias;
@@ -1204,6 +1215,22 @@ struct model_s *RE_SW_RegisterModel (char *name)
 	return mod;
 }
 
+/*
+@@@@@@@@@@@@@@@@@@@@@
+RE_SW_ModelRadius
+
+How far an alias model reaches from its origin over all of its frames,
+or 0 if it isn't known
+@@@@@@@@@@@@@@@@@@@@@
+*/
+float RE_SW_ModelRadius (struct model_s *model)
+{
+	if (!model || model->type != mod_alias)
+		return 0;
+
+	return model->radius;
+}
+
 /*
 @@@@@@@@@@@@@@@@@@@@@
 RE_SW_EndRegistration
@@ -181,6 +181,7 @@ typedef struct model_s
 	// volume occupied by the model graphics
 	//
 	vec3_t		mins, maxs;
+	float		radius;		// alias models over all frames
 
 	//
 	// solid volume for clipping (sent from server)
@@ -244,7 +245,7 @@ byte	*SW_Mod_ClusterPVS(int cluster, model_t *model);
 
 void	SW_Mod_Modellist_f (void);
 
-void	*Hunk_Begin (int maxsize);
+void	*Hunk_Begin (int maxsize, char *name);
 void	*Hunk_Alloc (int size);
 int		Hunk_End (void);
 void	Hunk_Free (void *base);
@@ -20,7 +20,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 // game.h -- game dll information visible to server
 
-#define	GAME_API_VERSION	3
+#define	GAME_API_VERSION	5
 
 // edict->svflags
 
@@ -173,6 +173,18 @@ typedef struct
 	void	(*AddCommandString) (char *text);
 
 	void	(*DebugGraph) (float value, int color);
+
+	// runs func for every index in [0, count) on the engine's worker
+	// threads and returns when they are all done; func may only read
+	// game state and trace with masks that exclude CONTENTS_MONSTER
+	void	(*ParallelFor) (void (*func) (int index, void *data), int count, void *data);
+
+	// wall clock time, for timing things
+	unsigned int	(*Microseconds) (void);
+
+	// queues a save file to be written by the engine's save thread;
+	// data is copied, so the caller's buffer can be reused at once
+	void	(*WriteSaveFile) (char *filename, void *data, int len);
 } game_import_t;
 
 //
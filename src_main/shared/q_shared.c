@@ -19,6 +19,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 */
 #include "q_shared.h"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 vec3_t vec3_origin = {0, 0, 0};
 
 //============================================================================
@@ -1413,6 +1417,55 @@ int Q_strlcat(char *dst, const char *src, int size)
 	return (d - dst) + Q_strlcpy(d, src, size);
 }
 
+/*
+============
+Com_HashKey
+
+Case insensitive FNV-1a string hash; hashsize must be a power of two
+============
+*/
+unsigned Com_HashKey (const char *s, int hashsize)
+{
+	unsigned	hash = 2166136261u;
+
+	while (*s)
+	{
+		hash ^= (unsigned) tolower (*s++);
+		hash *= 16777619u;
+	}
+
+	return hash & (hashsize - 1);
+}
+
+/*
+============
+Q_LowestBit
+
+Index of the lowest set bit, for walking bitsets; v must not be 0
+============
+*/
+int Q_LowestBit (unsigned v)
+{
+#if defined(_MSC_VER)
+	unsigned long	bit;
+
+	_BitScanForward (&bit, v);
+	return (int) bit;
+#elif defined(__GNUC__)
+	return __builtin_ctz (v);
+#else
+	int		bit = 0;
+
+	while (!(v & 1))
+	{
+		v >>= 1;
+		bit++;
+	}
+
+	return bit;
+#endif
+}
+
 /*
 =====================================================================
 
@@ -315,6 +315,9 @@ char *Q_strlwr (char *s);
 int Q_strlcpy (char *dst, const char *src, int size);
 int Q_strlcat (char *dst, const char *src, int size);
 
+unsigned Com_HashKey (const char *s, int hashsize);
+int Q_LowestBit (unsigned v);
+
 int glob_match (char *pattern, char *text);
 
 //=============================================
@@ -358,7 +361,7 @@ int		Sys_Milliseconds (void);
 void	Sys_Mkdir (char *path);
 
 // large block stack allocation routines
-void	*Hunk_Begin (int maxsize);
+void	*Hunk_Begin (int maxsize, char *name);
 void	*Hunk_Alloc (int size);
 void	Hunk_Free (void *buf);
 int		Hunk_End (void);
@@ -412,6 +415,7 @@ typedef struct cvar_s
 	float		value;
 	int			integer;
 	struct cvar_s *next;
+	int			sequence;	// cvar_sequence at the last value change
 } cvar_t;
 
 #endif		// CVAR